@@ -21,6 +21,8 @@ cc_mode='RELEASE'
 
 # Liste des algorithmes disponibles.
 algos=("$1")
+# Algorithme de référence pour le calcul de l'accélération (le premier).
+ref_algo=`echo $algos | cut -d ' ' -f 1`
 # Regex des fichiers à compresser.
 files_regex='*.txt'
 # Liste des fichiers à compresser.
@@ -75,13 +77,20 @@ else
                 # Inscris le nom du fichier traité et de l'algorithme.
                 echo "`echo $file | sed -e "s/.*\/\(.*\)/\1/g"`|$algo" \
                     | tr '\n' '|' >> $tmp_file
-                # Lance la compression, supprime les messages de make, isole les
-                # données importantes et les mets en forme.
+                # Lance la compression avec les statistiques au format CSV,
+                # ignore les messages de make et isole les colonnes utiles par
+                # leur nom (les chemins, seuls champs entre guillemets, sont
+                # en fin de ligne).
                 make run --directory=$root_path --no-print-directory \
-                CC_MODE="$cc_mode" ARGS="-c -i \"$file\" -s --$algo"\
-                    | sed -n 3,6p \
-                    | sed -e "s/.* : //g" -e "s/\([0-9.]*\).*/\1/g" \
-                    | tr '\n' '|' >> $tmp_file
+                CC_MODE="$cc_mode" ARGS="-c -i \"$file\" --stats=csv --$algo"\
+                    | awk -F ',' '
+                        $1 == "mode" { for (i = 1; i <= NF; i++) col[$i] = i
+                                       getline
+                                       printf "%d|%d|%s|%s|",
+                                           $col["in_bytes"] / 1000,
+                                           $col["out_bytes"] / 1000,
+                                           $col["wall_s"], $col["max_rss_kb"]
+                                     }' >> $tmp_file
                 echo -e "\n" >> $tmp_file
             done
         done
@@ -91,6 +100,14 @@ else
         # l'affichage.
         echo -e "`sed "/^$/d" $tmp_file | tee $stat_file \
             | sed -e "s/#\(.*\)/\1/g" | column -s '|' -t` \n"
+        # Accélération de la compression de chaque algorithme par rapport à
+        # l'algorithme de référence, fichier par fichier.
+        echo -e "Accélération par rapport à $ref_algo :\n"
+        echo -e "`awk -F '|' -v ref="$ref_algo" '
+            NR == 1 { print "Fichier|Algorithme|Accélération"; next }
+            $2 == ref { t_ref[$1] = $5 }
+            $1 in t_ref && $5 > 0 { printf "%s|%s|x%.2f\n", $1, $2, \
+                t_ref[$1] / $5 }' $stat_file | column -s '|' -t` \n"
         rm $tmp_file
     fi
 fi
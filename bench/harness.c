@@ -0,0 +1,309 @@
+/**
+ * \file harness.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Banc de mesure.
+ * \details Mesure les algorithmes dans le processus, sans lancer
+ * l'exécutable : chaque fichier est chargé en mémoire puis compressé et
+ * décompressé plusieurs fois avec codec_run_mem, après des itérations de
+ * chauffe. Le résultat est affiché sur la sortie standard au format de
+ * benchmark.sh (colonnes séparées par des '|', lues par benchmark.gnu),
+ * suivies du taux de compression et des débits médians et p95.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include "init.h"
+#include "errors.h"
+#include "io.h"
+#include "codec.h"
+#include "algo_pipe.h"
+#include "common.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Nombre d'itérations mesurées par défaut. */
+#define BENCH_ITER_DEFAULT 10
+/* Nombre d'itérations de chauffe par défaut (non mesurées). */
+#define BENCH_WARMUP_DEFAULT 1
+/* Nombre maximal d'itérations mesurées. */
+#define BENCH_ITER_MAX 10000
+
+/* Noms des colonnes : celles de benchmark.sh, puis celles du banc. */
+#define BENCH_HEADER "Fichier|Algorithme|Taille original (kB)|Taille " \
+    "compressé (kB)|Temps de compression (s)|Espace mémoire utilisé (kB)|" \
+    "Taux de compression|Compression médiane (MB/s)|Compression p95 (MB/s)|" \
+    "Décompression médiane (MB/s)|Décompression p95 (MB/s)"
+
+/* Structures privées ======================================================= */
+
+/* Paramètres du banc. */
+typedef struct bench_opt {
+    int nb_iter;                /* Nombre d'itérations mesurées. */
+    int nb_warmup;              /* Nombre d'itérations de chauffe. */
+    int level;                  /* Niveau de compression (0 : par défaut). */
+    pipe_spec_s pipe;           /* Chaîne de transformations de PIPE (vide
+                                   si -p est absent). */
+    algo_e a_algos[ALGO_NB];    /* Algorithmes à mesurer. */
+    int nb_algos;               /* Nombre d'algorithmes à mesurer. */
+} bench_opt_s;
+
+/* Résultat d'une mesure d'un algorithme sur un fichier. */
+typedef struct bench_res {
+    size_t cmp_size;            /* Taille compressée en byte. */
+    double cmp_med;             /* Temps médian de compression en s. */
+    double cmp_p95;             /* 95e centile du temps de compression. */
+    double dcmp_med;            /* Temps médian de décompression en s. */
+    double dcmp_p95;            /* 95e centile du temps de décompression. */
+} bench_res_s;
+
+/* Fonctions privées ======================================================== */
+
+/* Affiche l'utilisation du programme "s_name" sur "p_stream" et quitte le
+ * programme avec "exit_code". */
+static void bench_usage(FILE * p_stream, const int exit_code,
+                        const char *s_name)
+{
+    fprintf(p_stream,
+            "Utilisation : %s [-n ITERATIONS] [-w WARMUP] [-l LEVEL] "
+            "[-p LIST] [-a ALGO]... FILE...\n\n"
+            "\t-n ITERATIONS\n"
+            "\t\tNombre de compressions et décompressions mesurées par\n"
+            "\t\tfichier et par algorithme (défaut : %d).\n\n"
+            "\t-w WARMUP\n"
+            "\t\tNombre d'itérations de chauffe, non mesurées (défaut :\n"
+            "\t\t%d).\n\n"
+            "\t-l LEVEL\n"
+            "\t\tNiveau de compression de LZ (1 à 9).\n\n"
+            "\t-p LIST\n"
+            "\t\tChaîne de transformations de PIPE, comme --pipeline\n"
+            "\t\t(PIPE n'est mesuré qu'avec cette option).\n\n"
+            "\t-a ALGO\n"
+            "\t\tAlgorithme à mesurer (répétable, défaut : tous, AUTO\n"
+            "\t\tétant le choix automatique) :\n\t\t",
+            s_name, BENCH_ITER_DEFAULT, BENCH_WARMUP_DEFAULT);
+    for (algo_e algo = ALGO_NONE + 1; algo < ALGO_NB; algo++)
+        fprintf(p_stream, "%s%s", codec_desc(algo)->s_name,
+                algo + 1 < ALGO_NB ? ", " : ".\n");
+    exit(exit_code);
+}
+
+/* Charge le fichier "s_path" en mémoire dans "*pp_data" (à libérer avec
+ * "free") et sa taille dans "*p_size".
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int bench_load(const char *s_path, byte_t ** pp_data, size_t * p_size)
+{
+    FILE *fp = fopen(s_path, "rb");
+    if (!fp)
+        return perror(s_path), -1;
+    size_t cap = 1 << 16, size = 0, nb_bytes;
+    byte_t *p_data = NULL, *p_tmp;
+    do {
+        if (!(p_tmp = realloc(p_data, cap <<= 1)))
+            return perror("realloc"), free(p_data), fclose(fp), -1;
+        p_data = p_tmp;
+        nb_bytes = fread(p_data + size, sizeof(byte_t), cap - size, fp);
+        size += nb_bytes;
+    } while (nb_bytes && size == cap);
+    if (ferror(fp))
+        return perror(s_path), free(p_data), fclose(fp), -1;
+    fclose(fp);
+    *pp_data = p_data;
+    *p_size = size;
+    return 0;
+}
+
+/* Compare deux durées pour "qsort". */
+static int bench_cmp_time(const void *p_a, const void *p_b)
+{
+    const double a = *(const double *)p_a, b = *(const double *)p_b;
+    return (a > b) - (a < b);
+}
+
+/* Trie les "nb" durées de "a_times" et renvoie la médiane dans "*p_med" et
+ * le 95e centile dans "*p_p95". */
+static void bench_quantiles(double *a_times, const int nb, double *p_med,
+                            double *p_p95)
+{
+    qsort(a_times, nb, sizeof(double), bench_cmp_time);
+    *p_med = nb % 2 ? a_times[nb / 2]
+        : (a_times[nb / 2 - 1] + a_times[nb / 2]) / 2;
+    *p_p95 = a_times[(nb * 95 + 99) / 100 - 1];
+}
+
+/* Compresse puis décompresse "size" bytes de "p_data" avec "algo" et les
+ * réglages de "opt", et vérifie
+ * le résultat. Positionne les durées de chaque sens dans "*p_cmp_time" et
+ * "*p_dcmp_time" en secondes, et la taille compressée dans "*p_cmp_size".
+ * Renvoie ERR_NONE sur un succès, l'erreur correspondante sinon. */
+static err_code_e bench_round(const byte_t * p_data, const size_t size,
+                       const algo_e algo, const bench_opt_s * opt,
+                       double *p_cmp_time, double *p_dcmp_time,
+                       size_t * p_cmp_size)
+{
+    codec_ctx_s ctx;
+    byte_t *p_cmp, *p_dcmp;
+    size_t dcmp_size;
+    codec_init(&ctx, MODE_COMPRESS, algo, opt->level);
+    ctx.pipe = opt->pipe;
+    /* L'algorithme est mesuré même s'il agrandit les données. */
+    ctx.store = FALSE;
+    uint64_t start = io_time_ns();
+    if (codec_run_mem(&ctx, p_data, size, CODEC_SIZE_UNKNOWN, &p_cmp,
+                      p_cmp_size))
+        return ctx.err;
+    *p_cmp_time = (io_time_ns() - start) / 1e9;
+    /* Décompression avec l'algorithme retenu en choix automatique. */
+    codec_init(&ctx, MODE_DECOMPRESS, ctx.algo, 0);
+    start = io_time_ns();
+    if (codec_run_mem(&ctx, p_cmp, *p_cmp_size, size, &p_dcmp, &dcmp_size))
+        return free(p_cmp), ctx.err;
+    *p_dcmp_time = (io_time_ns() - start) / 1e9;
+    int ret = dcmp_size != size || (size && memcmp(p_data, p_dcmp, size));
+    free(p_cmp), free(p_dcmp);
+    return ret ? ERR_DECOMPRESSION_FAILED : ERR_NONE;
+}
+
+/* Mesure "algo" sur "size" bytes de "p_data" selon "opt" et stocke le
+ * résultat dans "res".
+ * Renvoie ERR_NONE sur un succès, l'erreur correspondante sinon. */
+static err_code_e bench_measure(const byte_t * p_data, const size_t size,
+                                const algo_e algo, const bench_opt_s * opt,
+                                bench_res_s * res)
+{
+    double a_cmp[BENCH_ITER_MAX], a_dcmp[BENCH_ITER_MAX];
+    for (int i = 0; i < opt->nb_warmup + opt->nb_iter; i++) {
+        /* Les itérations de chauffe écrasent la première mesure. */
+        const int slot = i < opt->nb_warmup ? 0 : i - opt->nb_warmup;
+        const err_code_e err = bench_round(p_data, size, algo, opt,
+                                           &a_cmp[slot], &a_dcmp[slot],
+                                           &res->cmp_size);
+        if (err)
+            return err;
+    }
+    bench_quantiles(a_cmp, opt->nb_iter, &res->cmp_med, &res->cmp_p95);
+    bench_quantiles(a_dcmp, opt->nb_iter, &res->dcmp_med, &res->dcmp_p95);
+    return ERR_NONE;
+}
+
+/* Affiche la ligne du résultat "res" de "algo" sur le fichier "s_path" de
+ * "size" bytes. */
+static void bench_print(const char *s_path, const size_t size,
+                        const algo_e algo, const bench_res_s * res)
+{
+    struct rusage rus;
+    const char *s_name = strrchr(s_path, '/');
+    const double mb = size / 1e6;
+    if (getrusage(RUSAGE_SELF, &rus))
+        rus.ru_maxrss = 0;
+    printf("%s|%s|%zu|%zu|%.6f|%ld|%.4f|%.3f|%.3f|%.3f|%.3f|\n",
+           s_name ? s_name + 1 : s_path, codec_desc(algo)->s_name, size / 1000,
+           res->cmp_size / 1000, res->cmp_med, rus.ru_maxrss,
+           res->cmp_size ? (double)size / res->cmp_size : 0,
+           res->cmp_med > 0 ? mb / res->cmp_med : 0,
+           res->cmp_p95 > 0 ? mb / res->cmp_p95 : 0,
+           res->dcmp_med > 0 ? mb / res->dcmp_med : 0,
+           res->dcmp_p95 > 0 ? mb / res->dcmp_p95 : 0);
+    fflush(stdout);
+}
+
+/* Récupère les paramètres du banc sur la ligne de commande dans "opt".
+ * Renvoie l'indice du premier fichier dans "argv". Quitte le programme sur
+ * une erreur. */
+static int bench_args(bench_opt_s * opt, const int argc, char *const *argv)
+{
+    const codec_desc_s *desc;
+    char s_err[CODEC_ERR_SIZE];
+    int curr_arg;
+    opt->nb_iter = BENCH_ITER_DEFAULT;
+    opt->nb_warmup = BENCH_WARMUP_DEFAULT;
+    opt->level = opt->nb_algos = opt->pipe.nb_stages = 0;
+    while ((curr_arg = getopt(argc, argv, "hn:w:l:p:a:")) != -1) {
+        switch (curr_arg) {
+            case 'n':
+                opt->nb_iter = atoi(optarg);
+                if (opt->nb_iter < 1 || opt->nb_iter > BENCH_ITER_MAX)
+                    bench_usage(stderr, EXIT_FAILURE, argv[0]);
+                break;
+            case 'w':
+                opt->nb_warmup = atoi(optarg);
+                if (opt->nb_warmup < 0)
+                    bench_usage(stderr, EXIT_FAILURE, argv[0]);
+                break;
+            case 'l':
+                opt->level = atoi(optarg);
+                break;
+            case 'p':
+                if (pipe_parse(optarg, &opt->pipe, s_err, sizeof(s_err))) {
+                    fprintf(stderr, "Option -p : %s.\n", s_err);
+                    bench_usage(stderr, EXIT_FAILURE, argv[0]);
+                }
+                break;
+            case 'a':
+                if (opt->nb_algos == ALGO_NB || !(desc = codec_find(optarg)))
+                    bench_usage(stderr, EXIT_FAILURE, argv[0]);
+                opt->a_algos[opt->nb_algos++] = desc->algo;
+                break;
+            case 'h':
+                bench_usage(stdout, EXIT_SUCCESS, argv[0]);
+            default:
+                bench_usage(stderr, EXIT_FAILURE, argv[0]);
+        }
+    }
+    if (optind == argc)
+        bench_usage(stderr, EXIT_FAILURE, argv[0]);
+    /* Par défaut, tout les algorithmes (PIPE seulement avec sa chaîne). */
+    if (!opt->nb_algos) {
+        for (algo_e algo = ALGO_NONE + 1; algo < ALGO_NB; algo++)
+            if (algo != ALGO_PIPE || opt->pipe.nb_stages)
+                opt->a_algos[opt->nb_algos++] = algo;
+    }
+    for (int i = 0; i < opt->nb_algos; i++)
+        if (opt->a_algos[i] == ALGO_PIPE && !opt->pipe.nb_stages)
+            bench_usage(stderr, EXIT_FAILURE, argv[0]);
+    return optind;
+}
+
+/* Point d'entrée =========================================================== */
+
+int main(int argc, char *argv[])
+{
+    bench_opt_s opt;
+    int ret = EXIT_SUCCESS;
+    puts(BENCH_HEADER);
+    for (int i = bench_args(&opt, argc, argv); i < argc; i++) {
+        byte_t *p_data;
+        size_t size;
+        if (bench_load(argv[i], &p_data, &size)) {
+            ret = EXIT_FAILURE;
+            continue;
+        }
+        const int is_text = io_is_text(p_data, size);
+        for (int j = 0; j < opt.nb_algos; j++) {
+            const codec_desc_s *desc = codec_desc(opt.a_algos[j]);
+            bench_res_s res;
+            /* Par exemple RLE sur un fichier qui n'est pas en ASCII. */
+            if (!is_text && !(desc->caps & CODEC_CAP_BINARY)) {
+                fprintf(stderr, "%s avec %s : ignoré, fichier binaire.\n",
+                        argv[i], desc->s_name);
+                continue;
+            }
+            const err_code_e err = bench_measure(p_data, size,
+                                                 opt.a_algos[j], &opt, &res);
+            if (err) {
+                fprintf(stderr, "%s avec %s : %s.\n", argv[i], desc->s_name,
+                        err_str(err));
+                ret = EXIT_FAILURE;
+                continue;
+            }
+            bench_print(argv[i], size, opt.a_algos[j], &res);
+        }
+        free(p_data);
+    }
+    return ret;
+}
@@ -0,0 +1,340 @@
+#!/bin/bash
+
+# Ce script vérifie qu'aucun changement ne casse ni ne ralentit les
+# algorithmes. Chaque fichier des corpus de Calgary et de Canterbury (y compris
+# les fichiers binaires) est compressé puis décompressé par l'exécutable avec
+# chaque algorithme passé en argument, en mode séquentiel et en mode parallèle,
+# et le résultat est comparé octet par octet avec l'original. Ensuite, le banc
+# de mesure (exe/bench-harness) mesure $nb_rounds fois les débits de chaque
+# algorithme sur les corpus, et le meilleur débit de chacun est comparé à celui
+# de la référence $baseline_file, mesurée de la même façon sur cette machine :
+# le script échoue si un débit est inférieur de plus de $threshold % à la
+# référence. Avec l'option -b, ou si la référence n'existe pas encore, le
+# script enregistre les débits mesurés comme nouvelle référence.
+
+# Variables ====================================================================
+
+## Structure du projet ........................................................:
+
+# Dossier racine du projet.
+root_path='../'
+# Dossiers des corpus.
+corpus_paths=("env/Calgary Corpus/" "env/Canterbury Corpus/")
+# Exécutable et banc de mesure.
+exec_path="${root_path}exe/compressor-0"
+harness_path="${root_path}exe/bench-harness"
+
+## Paramètres .................................................................:
+
+# Baisse de débit tolérée par rapport à la référence, en pourcentage.
+threshold=${REGRESSION_THRESHOLD:-20}
+# Nombre de mesures de chaque algorithme, dont seul le meilleur débit est
+# retenu, et itérations mesurées et de chauffe du banc de mesure par mesure.
+nb_rounds=${REGRESSION_ROUNDS:-3}
+nb_iter=${REGRESSION_ITER:-10}
+nb_warmup=${REGRESSION_WARMUP:-3}
+# Options de l'exécutable pour le mode parallèle.
+par_opts='-t 2'
+
+## Fichiers ...................................................................:
+
+# Référence des débits de cette machine, non suivie par git, au format
+# "algo|compression|décompression".
+baseline_file='./regression_baseline.dat'
+# Débits mesurés.
+result_file='./regression_out.log'
+# Fichiers temporaires des allers-retours.
+tmp_cmp="/tmp/regression_$$.cmp"
+tmp_out="/tmp/regression_$$.out"
+tmp_arc="/tmp/regression_$$.c0a"
+
+# Fonctions ====================================================================
+
+# Renvoie vrai si l'algorithme $1 peut traiter le fichier $2. RLE et RLE-FAST
+# n'acceptent que l'ASCII sans octet nul.
+algo_accepts() {
+    case "$1" in
+        RLE|RLE-FAST)
+            [ `LC_ALL=C tr -d '\001-\177' < "$2" | head -c 1 | wc -c` -eq 0 ] ;;
+        *)
+            true ;;
+    esac
+}
+
+# Compresse puis décompresse le fichier $2 avec l'algorithme $1 et les options
+# $3, et compare le résultat à l'original. Renvoie vrai si l'aller-retour est
+# correct.
+round_trip() {
+    "$exec_path" -c -i "$2" -o "$tmp_cmp" --$1 $3 > /dev/null \
+        && "$exec_path" -d -i "$tmp_cmp" -o "$tmp_out" $3 > /dev/null \
+        && cmp -s "$2" "$tmp_out"
+}
+
+# Compresse le fichier $2 avec l'algorithme $1, écrase 8 octets au milieu des
+# données compressées, puis décompresse le résultat sans vérifier la somme de
+# contrôle. Renvoie vrai si le décodeur rejette le fichier avec un message
+# d'erreur qui en donne la cause (et non "Erreur 0").
+corrupt_check() {
+    "$exec_path" -c -i "$2" -o "$tmp_cmp" --$1 > /dev/null || return 1
+    local size=`stat -c %s "$tmp_cmp"`
+    printf '\377\377\377\377\377\377\377\377' \
+        | dd of="$tmp_cmp" bs=1 seek=$((size / 2)) conv=notrunc 2> /dev/null
+    local msg
+    msg=`"$exec_path" -d -i "$tmp_cmp" -o "$tmp_out" --no-verify 2>&1` \
+        && return 1
+    echo "$msg" | grep -q '^Erreur [1-9]' \
+        && ! echo "$msg" | grep -q '^Erreur 0 '
+}
+
+# Compresse le fichier binaire $2 avec l'algorithme $1, qui n'accepte que
+# l'ASCII, avec les options $3. Renvoie vrai si le fichier est refusé avec un
+# message d'erreur.
+binary_check() {
+    local msg
+    msg=`"$exec_path" -c -i "$2" -o "$tmp_cmp" --$1 $3 2>&1 > /dev/null` \
+        && return 1
+    echo "$msg" | grep -q '^Erreur [1-9]'
+}
+
+# Crée une archive avec les chemins $2..., qui donnent deux fois le même nom
+# de membre, puis vérifie qu'elle est refusée avec un message d'erreur et que
+# l'archive $1 n'est pas créée.
+archive_dup_check() {
+    local archive=$1
+    shift
+    local msg
+    msg=`"$exec_path" -a "$archive" --LZ "$@" 2>&1 > /dev/null` && return 1
+    [ ! -e "$archive" ] && echo "$msg" | grep -q '^Erreur [1-9]'
+}
+
+# Affiche le débit global de chaque algorithme (taille totale / temps total
+# médian) en compression et en décompression, à partir de la sortie du banc de
+# mesure $1, sous la forme "algo|compression|décompression".
+algo_rates() {
+    awk -F '|' 'NR > 1 {
+            size[$2] += $3
+            if ($8 > 0) t_cmp[$2] += $3 / $8
+            if ($10 > 0) t_dcmp[$2] += $3 / $10
+        }
+        END {
+            for (a in size)
+                printf "%s|%.3f|%.3f\n", a,
+                    (t_cmp[a] > 0 ? size[a] / t_cmp[a] : 0),
+                    (t_dcmp[a] > 0 ? size[a] / t_dcmp[a] : 0)
+        }' "$1"
+}
+
+# Affiche, trié par algorithme, le meilleur débit de chaque algorithme en
+# compression et en décompression parmi les lignes "algo|compression|
+# décompression" du fichier $1. Une machine chargée ne pouvant que ralentir un
+# algorithme, le meilleur débit est le moins sensible au bruit de la mesure.
+best_rates() {
+    awk -F '|' '{
+            if ($2 > cmp[$1]) cmp[$1] = $2
+            if ($3 > dcmp[$1]) dcmp[$1] = $3
+        }
+        END {
+            for (a in cmp)
+                printf "%s|%.3f|%.3f\n", a, cmp[a], dcmp[a]
+        }' "$1" | LC_ALL=C sort -t '|' -k1,1
+}
+
+# Script =======================================================================
+
+save_baseline=0
+if [ "$1" = '-b' ]
+then
+    save_baseline=1
+    shift
+fi
+algos=($1)
+
+if [ -z "$algos" ]
+then
+    echo -e "Erreur : aucun algorithme à tester." \
+        "\nUtilisation : $0 [-b] \"ALGO_1 ALGO_2 ...\""
+    exit 1
+fi
+if [ ! -x "$exec_path" ] || [ ! -x "$harness_path" ]
+then
+    echo "Erreur : compilez d'abord le projet (make bench-harness)."
+    exit 1
+fi
+# Liste des fichiers des corpus (les noms peuvent contenir des espaces).
+files=()
+for corpus in "${corpus_paths[@]}"
+do
+    while IFS= read -r -d '' file
+    do
+        files+=("$file")
+    done < <(find "$root_path$corpus" -type f -print0 | sort -z)
+done
+trap 'rm -f "$tmp_cmp" "$tmp_out" "$tmp_arc"' EXIT
+
+## Allers-retours .............................................................:
+
+nb_fail=0
+nb_warn=0
+nb_skip=0
+echo "Allers-retours sur ${#files[@]} fichiers :"
+for algo in "${algos[@]}"
+do
+    for file in "${files[@]}"
+    do
+        if ! algo_accepts "$algo" "$file"
+        then
+            nb_skip=$((nb_skip + 1))
+            continue
+        fi
+        for opts in '' "$par_opts"
+        do
+            if ! round_trip "$algo" "$file" "$opts" 2> /dev/null
+            then
+                echo "ÉCHEC : $file avec $algo ${opts:-(séquentiel)}"
+                nb_fail=$((nb_fail + 1))
+            fi
+        done
+    done
+done
+echo "$nb_fail échec(s), $nb_skip fichier(s) ignoré(s) par RLE (non ASCII)."
+
+## Fichiers corrompus .........................................................:
+
+# Seuls les décodeurs qui valident leurs blocs détectent une corruption sans
+# la somme de contrôle.
+for algo in "${algos[@]}"
+do
+    case "$algo" in
+        ANS|BWT) ;;
+        *) continue ;;
+    esac
+    if ! corrupt_check "$algo" "${files[0]}"
+    then
+        echo "ÉCHEC : fichier corrompu accepté ou erreur sans cause avec $algo"
+        nb_fail=$((nb_fail + 1))
+    fi
+done
+
+## Fichiers binaires ..........................................................:
+
+# RLE et RLE-FAST refusent un fichier qui n'est pas de l'ASCII au lieu de
+# produire un fichier indécompressable.
+for algo in "${algos[@]}"
+do
+    for file in "${files[@]}"
+    do
+        algo_accepts "$algo" "$file" && continue
+        for opts in '' "$par_opts"
+        do
+            if ! binary_check "$algo" "$file" "$opts"
+            then
+                echo "ÉCHEC : fichier binaire accepté par $algo" \
+                    "${opts:-(séquentiel)}"
+                nb_fail=$((nb_fail + 1))
+            fi
+        done
+        break
+    done
+done
+
+## Archives ...................................................................:
+
+# Un même fichier passé deux fois, ou sous deux chemins qui donnent le même nom
+# de membre ("./" retiré, ou fichier déjà dans un répertoire passé), est
+# refusé.
+dup_file=${files[0]}
+for dup_paths in "$dup_file|$dup_file" "$dup_file|./$dup_file" \
+    "$(dirname "$dup_file")|$dup_file"
+do
+    if ! archive_dup_check "$tmp_arc" "${dup_paths%%|*}" "${dup_paths#*|}"
+    then
+        echo "ÉCHEC : noms de membres en double acceptés (${dup_paths/|/, })"
+        nb_fail=$((nb_fail + 1))
+    fi
+done
+
+## Débits .....................................................................:
+
+echo -e "\nMesure des débits ($nb_rounds mesures de $nb_iter itérations) :"
+: > "$result_file"
+: > "$result_file.rates"
+# Les mesures alternent les algorithmes, pour qu'une charge passagère de la
+# machine ne pénalise pas toutes les mesures d'un même algorithme.
+for round in `seq "$nb_rounds"`
+do
+    for algo in "${algos[@]}"
+    do
+        algo_files=()
+        for file in "${files[@]}"
+        do
+            algo_accepts "$algo" "$file" && algo_files+=("$file")
+        done
+        # Le banc vérifie aussi chaque aller-retour en mémoire.
+        if ! "$harness_path" -n "$nb_iter" -w "$nb_warmup" -a "$algo" \
+            "${algo_files[@]}" > "$result_file.tmp"
+        then
+            echo "ÉCHEC : banc de mesure avec $algo (mesure $round)"
+            nb_fail=$((nb_fail + 1))
+        fi
+        algo_rates "$result_file.tmp" >> "$result_file.rates"
+        # Une seule ligne des noms des colonnes.
+        if [ -s "$result_file" ]
+        then
+            tail -n +2 "$result_file.tmp" >> "$result_file"
+        else
+            cat "$result_file.tmp" > "$result_file"
+        fi
+    done
+done
+best_rates "$result_file.rates" > "$result_file.best"
+rm -f "$result_file.tmp" "$result_file.rates"
+
+if [ $save_baseline -eq 1 ] || [ ! -f "$baseline_file" ]
+then
+    [ $save_baseline -eq 1 ] || echo "Aucune référence sur cette machine :" \
+        "les débits mesurés deviennent la référence."
+    cp "$result_file.best" "$baseline_file"
+    echo "Référence enregistrée dans $baseline_file."
+    awk -F '|' '{
+            printf "%-10s compression %9.3f MB/s,", $1, $2
+            printf "  décompression %9.3f MB/s\n", $3
+        }' "$baseline_file"
+else
+    # Compare les débits globaux de chaque algorithme à la référence. Les
+    # algorithmes absents de la référence sont signalés, pas ignorés.
+    LC_ALL=C join -t '|' -a 2 -e '-' -o '0,1.2,1.3,2.2,2.3' \
+        <(LC_ALL=C sort -t '|' -k1,1 "$baseline_file") \
+        "$result_file.best" > "$result_file.cmp"
+    while IFS='|' read -r algo ref_cmp ref_dcmp cur_cmp cur_dcmp
+    do
+        if [ "$ref_cmp" = '-' ]
+        then
+            printf "%-10s compression %9.3f MB/s," "$algo" "$cur_cmp"
+            printf "  décompression %9.3f MB/s : AVERTISSEMENT, absent" \
+                "$cur_dcmp"
+            echo " de la référence (relancez $0 -b)"
+            nb_warn=$((nb_warn + 1))
+            continue
+        fi
+        status=`awk -v rc="$ref_cmp" -v rd="$ref_dcmp" -v cc="$cur_cmp" \
+            -v cd="$cur_dcmp" -v t="$threshold" 'BEGIN {
+                min = 1 - t / 100
+                print (cc < rc * min || cd < rd * min) ? "RÉGRESSION" : "ok"
+            }'`
+        printf "%-10s compression %9.3f MB/s (réf. %9.3f)," \
+            "$algo" "$cur_cmp" "$ref_cmp"
+        printf "  décompression %9.3f MB/s (réf. %9.3f) : %s\n" \
+            "$cur_dcmp" "$ref_dcmp" "$status"
+        [ "$status" = 'ok' ] || nb_fail=$((nb_fail + 1))
+    done < "$result_file.cmp"
+    rm -f "$result_file.cmp"
+fi
+rm -f "$result_file.best"
+
+if [ $nb_fail -ne 0 ]
+then
+    echo -e "\nÉchec de la régression : $nb_fail erreur(s)."
+    exit 1
+fi
+[ $nb_warn -eq 0 ] || echo -e "\n$nb_warn avertissement(s)."
+echo -e "\nRégression réussie."
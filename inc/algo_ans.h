@@ -0,0 +1,41 @@
+/**
+ * \file algo_ans.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief rANS.
+ * \details Module du codage entropique d'ordre 0 par rANS (range Asymmetric
+ * Numeral Systems), à quatre états entrelacés.
+ */
+
+/* Principe de l'algorithme : chaque octet est codé d'après sa fréquence dans
+ * le bloc qui le contient, avec une fraction de bit : un octet de probabilité
+ * p coûte log2(1/p) bits, là où un code de Huffman arrondit ce coût au bit
+ * entier, ce qui compte sur les fichiers dont quelques octets dominent.
+ * L'algorithme fonctionne sur tout type de fichier. */
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Lance la compression rANS sur un fichier entrant et l'inscrit sur un fichier
+ * sortant. Le fichier entrant est lu une seule fois, par blocs qui portent
+ * chacun leur table de fréquences.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ */
+int ans_compress(cmp_file_s * cf);
+
+/**
+ * Lance la décompression rANS sur un fichier entrant et l'inscris sur un
+ * fichier sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si le fichier est corrompu.
+ */
+int ans_decompress(cmp_file_s * cf);
@@ -0,0 +1,44 @@
+/**
+ * \file algo_bwt.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief BWT.
+ * \details Module de la chaîne de compression par blocs triés : transformée
+ * de Burrows-Wheeler, move-to-front, RLE binaire puis codage rANS.
+ */
+
+/* Principe de l'algorithme : chaque bloc est remplacé par la dernière colonne
+ * de la liste triée de ses rotations (transformée de Burrows-Wheeler), qui
+ * regroupe les octets suivis des mêmes contextes : sur du texte, elle est
+ * faite de longues suites d'un même octet. Le move-to-front remplace chaque
+ * octet par son rang parmi les octets récemment vus, ce qui transforme ces
+ * suites en suites de zéros que l'algorithme RLE binaire (--RLE-BIN) réduit,
+ * avant le codage entropique par rANS (--ANS).
+ * L'algorithme fonctionne sur tout type de fichier. */
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Lance la compression par blocs triés sur un fichier entrant et l'inscrit sur
+ * un fichier sortant. Le tableau des suffixes de chaque bloc est construit
+ * par SA-IS, en temps linéaire.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ */
+int bwt_compress(cmp_file_s * cf);
+
+/**
+ * Lance la décompression par blocs triés sur un fichier entrant et l'inscris
+ * sur un fichier sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si le fichier est corrompu.
+ */
+int bwt_decompress(cmp_file_s * cf);
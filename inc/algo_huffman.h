@@ -0,0 +1,41 @@
+/**
+ * \file algo_huffman.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Huffman.
+ * \details Module de l'algorithme de codage de Huffman.
+ */
+
+/* Principe de l'algorithme : chaque octet est remplacé par un code binaire de
+ * longueur variable, d'autant plus court que l'octet est fréquent dans le
+ * fichier. Aucun code n'est le préfixe d'un autre, ce qui permet de les
+ * décoder sans séparateur.
+ * L'algorithme fonctionne sur tout type de fichier. */
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Lance la compression de Huffman sur un fichier entrant et l'inscrit sur un
+ * fichier sortant. Le fichier entrant est lu deux fois (histogramme puis
+ * codage) : s'il ne peut pas être rembobiné (tube), il est conservé en
+ * mémoire lors de la première lecture.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ */
+int huffman_compress(cmp_file_s * cf);
+
+/**
+ * Lance la décompression de Huffman sur un fichier entrant et l'inscris sur un
+ * fichier sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si le fichier est corrompu.
+ */
+int huffman_decompress(cmp_file_s * cf);
@@ -0,0 +1,52 @@
+/**
+ * \file algo_lz.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief LZ.
+ * \details Module de l'algorithme LZ (famille LZ77), à fenêtre glissante et
+ * recherche des correspondances par chaînes de hachage.
+ */
+
+/* Principe de l'algorithme : lorsqu'une suite d'octets a déjà été rencontrée
+ * dans les 64 derniers kB du fichier, elle est remplacée par un couple
+ * (distance, longueur) qui désigne sa précédente occurrence. Les octets sans
+ * correspondance sont recopiés tels quels.
+ * L'algorithme fonctionne sur tout type de fichier. */
+
+/* Macro-constantes publiques =============================================== */
+
+/** Niveau de compression le plus rapide. */
+#define LZ_LEVEL_MIN 1
+/** Niveau de compression le plus fort. */
+#define LZ_LEVEL_MAX 9
+/** Niveau de compression par défaut. */
+#define LZ_LEVEL_DEFAULT 6
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Lance la compression LZ sur un fichier entrant et l'inscrit sur un fichier
+ * sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \param level Niveau de compression, de LZ_LEVEL_MIN à LZ_LEVEL_MAX (sinon
+ * LZ_LEVEL_DEFAULT est utilisé) : plus il est élevé, plus la recherche des
+ * correspondances est profonde et plus la compression est lente.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ */
+int lz_compress(cmp_file_s * cf, const int level);
+
+/**
+ * Lance la décompression LZ sur un fichier entrant et l'inscris sur un fichier
+ * sortant. Le niveau de compression n'a pas besoin d'être connu.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si le fichier est corrompu.
+ */
+int lz_decompress(cmp_file_s * cf);
@@ -0,0 +1,65 @@
+/**
+ * \file algo_pipe.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Chaîne de transformations.
+ * \details Module de la compression par une chaîne d'étages choisie sur la
+ * ligne de commande (--pipeline), appliqués en mémoire bloc par bloc.
+ */
+
+/* Principe de l'algorithme : chaque bloc passe dans l'ordre par les étages de
+ * la chaîne, chacun travaillant sur la zone mémoire produite par le précédent.
+ * Les étages "delta" (différence avec l'octet situé N octets avant) et
+ * "transpose" (regroupement des octets de même rang d'enregistrements de N
+ * octets) ne réduisent pas les données mais les préparent : sur des tableaux
+ * de structures ou des colonnes de nombres qui varient lentement, ils donnent
+ * de longues suites de zéros aux étages "rle" (RLE binaire), "huffman" et
+ * "ans" (rANS). La chaîne est inscrite au début des données compressées, qui
+ * se décompressent sans la connaître.
+ * L'algorithme fonctionne sur tout type de fichier. */
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Lit une chaîne de transformations, sous la forme d'une liste d'étages
+ * séparés par des virgules, chacun éventuellement suivi de ":N" (par exemple
+ * "transpose:4,delta,rle,ans"). Les étages sont "delta" (N = 1 par défaut),
+ * "transpose" (N = 4 par défaut), "rle", "huffman" et "ans", avec N de 1 à
+ * 255.
+ * \param s_list Liste des étages.
+ * \param spec Pointeur recevant la chaîne lue.
+ * \param s_err Zone recevant, sur une erreur, un message qui nomme l'étage
+ * fautif et la limite dépassée (NULL : aucun message).
+ * \param err_size Taille de "s_err" en byte.
+ * \return 0 sur succès, -1 si la liste est vide, invalide ou compte plus de
+ * PIPE_STAGES_MAX étages.
+ */
+int pipe_parse(const char *s_list, pipe_spec_s * spec, char *s_err,
+               const size_t err_size);
+
+/**
+ * Lance la compression par la chaîne "spec" sur un fichier entrant et
+ * l'inscrit sur un fichier sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \param spec Chaîne de transformations, d'au moins un étage.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si "spec" est nulle.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression
+ * ou si la chaîne est vide ou invalide.
+ */
+int pipe_compress(cmp_file_s * cf, const pipe_spec_s * spec);
+
+/**
+ * Lance la décompression par la chaîne inscrite au début d'un fichier entrant
+ * et l'inscris sur un fichier sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si le fichier est corrompu.
+ */
+int pipe_decompress(cmp_file_s * cf);
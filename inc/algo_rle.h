@@ -11,7 +11,17 @@
  * que le programme rencontre une répétition consécutive de plusieurs
  * caractères, on note un code qui indique ce nombre de répétition, puis un seul
  * de ces caractères.
- * L'algorithme nécessite des fichiers en ASCII pour fonctionner. */
+ * Les moteurs RLE et RLE rapide nécessitent des fichiers en ASCII pour
+ * fonctionner. Le moteur binaire utilise un format orienté octet, qui accepte
+ * tout type de fichier et des répétitions de longueur quelconque. */
+
+/* Macro-constantes publiques =============================================== */
+
+/**
+ * Nombre de bit du code de répétition (sans compter le premier bit ID),
+ * inscrit dans l'en-tête des fichiers compressés. 2 <= REP_CODE_LENGHT <= 7.
+ */
+#define REP_CODE_LENGHT 3       /* Valeur optimale déterminée empiriquement. */
 
 /* Fonctions publiques ====================================================== */
 
@@ -20,9 +30,8 @@
  * sortant.
  * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
  * compresser.
- * \return 0 sur succès, -1 sur une erreur et positionne "CMP_err" sur l'erreur
- * correspondante.
- * \error ERR_BAD_ADRESS si le pointeur est nulle ou invalide.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
  * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
  */
 int rle_compress(cmp_file_s * cf);
@@ -32,9 +41,59 @@ int rle_compress(cmp_file_s * cf);
  * sortant.
  * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
  * décompresser.
- * \return 0 sur succès, -1 sur une erreur et positionne "CMP_err" sur l'erreur
- * correspondante.
- * \error ERR_BAD_ADRESS si le pointeur est nulle ou invalide.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
  * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la décompression.
  */
 int rle_decompress(cmp_file_s * cf);
+
+/**
+ * Lance la compression RLE sur un fichier entrant et l'inscrit sur un fichier
+ * sortant, en utilisant le moteur rapide (écriture des champs entiers dans un
+ * accumulateur de 64 bits). Le format produit est identique à celui de
+ * rle_compress.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ */
+int rle_fast_compress(cmp_file_s * cf);
+
+/**
+ * Lance la décompression RLE sur un fichier entrant et l'inscris sur un fichier
+ * sortant, en utilisant le moteur rapide (décodage des champs par table).
+ * Décompresse indifféremment les fichiers produits par rle_compress ou
+ * rle_fast_compress.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression.
+ */
+int rle_fast_decompress(cmp_file_s * cf);
+
+/**
+ * Lance la compression RLE sur un fichier entrant et l'inscrit sur un fichier
+ * sortant, en utilisant le moteur binaire (format orienté octet, à paquets de
+ * littéraux et de répétitions). Fonctionne sur tout type de fichier.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * compresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ */
+int rle_bin_compress(cmp_file_s * cf);
+
+/**
+ * Lance la décompression RLE sur un fichier entrant produit par
+ * rle_bin_compress et l'inscris sur un fichier sortant.
+ * \param cf Pointeur vers une structure de couple fichier entrant/sortant à
+ * décompresser.
+ * \return 0 sur succès, -1 sur une erreur et positionne l'erreur de "cf" (voir
+ * cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression, ou si le fichier est corrompu.
+ */
+int rle_bin_decompress(cmp_file_s * cf);
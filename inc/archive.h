@@ -0,0 +1,118 @@
+/**
+ * \file archive.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Archives.
+ * \details Module de création et d'extraction des archives, qui regroupent
+ * plusieurs fichiers compressés dans un seul conteneur. Les fichiers sont
+ * compressés et décompressés en parallèle par un groupe de threads.
+ */
+
+/* Format de l'archive, entiers en little endian :
+ * - En-tête de ARC_HEADER_SIZE bytes : nombre magique ARC_MAGIC (4 bytes),
+ *   version du format (8 bits), puis 3 bytes nuls.
+ * - Données des membres, à la suite : chaque membre est un fichier compressé
+ *   complet (en-tête, voir header.h, données compressées puis somme de
+ *   contrôle du fichier original), qui peut être décompressé seul.
+ * - Index central, une entrée par membre dans l'ordre des données :
+ *   - Position des données du membre dans l'archive (64 bits).
+ *   - Taille des données du membre, en-tête et somme de contrôle compris (64
+ *     bits).
+ *   - Taille du fichier original (64 bits).
+ *   - Identifiant de l'algorithme ("algo_e", 8 bits).
+ *   - Longueur du nom (16 bits), puis le nom sans '\0' (chemin relatif, les
+ *     répertoires séparés par '/').
+ * - Fin de l'archive de ARC_TRAILER_SIZE bytes : position de l'index (64
+ *   bits), nombre de membres (32 bits), nombre magique ARC_INDEX_MAGIC (4
+ *   bytes).
+ * L'index étant à la fin, l'archive est écrite d'un seul trait (elle peut
+ * l'être sur un tube), et un membre est extrait en lisant la fin de
+ * l'archive, l'index puis ses seules données. */
+
+#ifndef __ARCHIVE_H
+#define __ARCHIVE_H
+
+#include "init.h"
+#include "codec.h"
+
+/* Macro-constantes publiques =============================================== */
+
+/** Nombre magique au début des archives. */
+#define ARC_MAGIC "CMPA"
+/** Nombre magique à la fin des archives. */
+#define ARC_INDEX_MAGIC "CMPI"
+/** Version du format. */
+#define ARC_VERSION 1
+/** Taille de l'en-tête de l'archive en byte. */
+#define ARC_HEADER_SIZE 8
+/** Taille de la fin de l'archive en byte. */
+#define ARC_TRAILER_SIZE 16
+/** Longueur maximale du nom d'un membre. */
+#define ARC_NAME_MAX 4095
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Crée une archive à partir de fichiers et de répertoires (parcourus
+ * récursivement, dans l'ordre alphabétique). Chaque fichier est compressé en
+ * mémoire par un des threads, et les membres sont écrits dans l'ordre des
+ * chemins, suivis de l'index.
+ * \param s_archive Chemin de l'archive, ou IO_STD_PATH pour la sortie
+ * standard.
+ * \param a_s_paths Chemins des fichiers et des répertoires à archiver.
+ * \param nb_paths Nombre de chemins.
+ * \param ctx Contexte donnant l'algorithme et le niveau de chaque membre, qui
+ * reçoit les statistiques du traitement.
+ * \param nb_threads Nombre de threads de compression (>= 1).
+ * \param ps_err_path Si non NULL, reçoit sur une erreur le chemin du fichier
+ * qui l'a causée (alloué, à libérer), NULL sinon.
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur autre que "ctx" est incorrect.
+ * \error ERR_IO_FOPEN si un fichier ou un répertoire ne peut pas être ouvert.
+ * \error ERR_IO_FREAD si un fichier ne peut pas être lu.
+ * \error ERR_IO_FWRITE si l'archive ne peut pas être écrite.
+ * \error ERR_COMPRESSION_FAILED si la compression d'un membre échoue.
+ * \error ERR_NOT_TEXT si un membre n'est pas du texte alors que l'algorithme
+ * n'a pas CODEC_CAP_BINARY.
+ * \error ERR_ARCHIVE si un nom de membre est trop long, ou si deux membres
+ * ont le même nom (même chemin donné deux fois, ou chemins identiques une
+ * fois "/", "./" et "../" retirés).
+ */
+int arc_create(const char *s_archive, char *const *a_s_paths,
+               const int nb_paths, codec_ctx_s * ctx, const int nb_threads,
+               char **ps_err_path);
+
+/**
+ * Extrait les membres d'une archive dans un répertoire, en recréant leurs
+ * répertoires. Chaque membre est lu à sa position dans l'archive et
+ * décompressé par un des threads.
+ * \param s_archive Chemin de l'archive (fichier régulier).
+ * \param s_dir Répertoire de destination, créé si besoin.
+ * \param a_s_names Noms des membres à extraire : un nom de répertoire
+ * sélectionne tout les membres qu'il contient. NULL pour tout extraire.
+ * \param nb_names Nombre de noms.
+ * \param ctx Contexte de décompression, qui donne la vérification des sommes
+ * de contrôle et reçoit les statistiques du traitement.
+ * \param nb_threads Nombre de threads de décompression (>= 1).
+ * \param ps_err_path Si non NULL, reçoit sur une erreur le chemin de
+ * l'archive, du fichier extrait ou du nom demandé qui l'a causée (alloué, à
+ * libérer), NULL sinon.
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur autre que "ctx" est incorrect.
+ * \error ERR_IO_FOPEN si l'archive ou un fichier extrait ne peut pas être
+ * ouvert.
+ * \error ERR_ARCHIVE si l'archive est invalide, ou si un nom de membre sort du
+ * répertoire de destination.
+ * \error ERR_ARCHIVE_MEMBER si un nom demandé n'est pas dans l'archive.
+ * \error ERR_DECOMPRESSION_FAILED si la décompression d'un membre échoue.
+ * \error ERR_CHECKSUM si la somme de contrôle d'un membre est incorrecte
+ * (vérifiée si demandé par "ctx").
+ */
+int arc_extract(const char *s_archive, const char *s_dir,
+                char *const *a_s_names, const int nb_names,
+                codec_ctx_s * ctx, const int nb_threads, char **ps_err_path);
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * \file cmp_types.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Types publics.
+ * \details Énumérations partagées par le programme et par l'interface de la
+ * bibliothèque libcompressor0 : modes, algorithmes et codes d'erreurs.
+ */
+
+#ifndef __CMP_TYPES_H
+#define __CMP_TYPES_H
+
+/* Énumérations publiques =================================================== */
+
+typedef enum mode mode_e;
+typedef enum algo algo_e;
+typedef enum err_code err_code_e;
+
+/** Liste les modes possibles de fonctionnement du programme. */
+enum mode {
+    MODE_NONE = 0,              /*!< Aucun mode. */
+    MODE_COMPRESS,              /*!< Mode de compression de fichier. */
+    MODE_DECOMPRESS             /*!< Mode de décompression de fichier. */
+};
+
+/** Liste les algorithmes disponibles pour la compression d'un fichier. Les
+ * identifiants sont inscrits dans les en-têtes : un nouvel algorithme est
+ * ajouté avant ALGO_NB, et décrit dans le registre du module codec. */
+enum algo {
+    ALGO_NONE = 0,              /*!< Aucun algorithme. */
+    ALGO_RLE,                   /*!< Run-Lenght Encoding. */
+    ALGO_RLE_FAST,              /*!< Run-Lenght Encoding, moteur rapide. */
+    ALGO_HUFFMAN,               /*!< Codage de Huffman. */
+    ALGO_LZ,                    /*!< LZ77 à chaînes de hachage. */
+    ALGO_RLE_BIN,               /*!< Run-Lenght Encoding, moteur binaire. */
+    ALGO_AUTO,                  /*!< Choix automatique, bloc par bloc. */
+    ALGO_STORED,                /*!< Données stockées telles quelles. */
+    ALGO_ANS,                   /*!< Codage rANS à états entrelacés. */
+    ALGO_BWT,                   /*!< Burrows-Wheeler, MTF, RLE puis rANS. */
+    ALGO_PIPE,                  /*!< Chaîne d'étages choisie (--pipeline). */
+    ALGO_NB                     /*!< Nombre d'identifiants d'algorithmes. */
+};
+
+/**
+ * Liste des codes d'erreurs du programme. Utilisé dans le retour des
+ * fonctions et dans la correspondance erreur <=> message. Le code 0 signifie
+ * (sauf cas particulier) qu'aucune erreur ne s'est produite.
+ */
+enum err_code {
+    ERR_OTHER = -1,             /*!< Erreur quelconque. */
+    ERR_NONE = 0,               /*!< Aucune erreur. */
+    ERR_BAD_ADRESS,             /*!< Pointeur null ou invalide. */
+    ERR_INIT_MISSING_OPTIONS,   /*!< Options nécéssaires au programme
+                                   manquantes. */
+    ERR_STAT,                   /*!< Erreur pendant la récupération des
+                                   statistiques. */
+    ERR_IO_FREAD,               /*!< Erreur pendant la lecture du fichier. */
+    ERR_IO_FREAD_EOF,           /*!< Erreur pendant la lecture du fichier car la
+                                   fin à déjà été atteinte. */
+    ERR_IO_FWRITE,              /*!< Erreur pendant l'écriture du fichier. */
+    ERR_IO_FCLOSE,              /*!< Erreur pendant la fermeture du fichier. */
+    ERR_COMPRESSION_FAILED,     /*!< Erreur durant la compression. */
+    ERR_DECOMPRESSION_FAILED,   /*!< Erreur durant la décompression. */
+    ERR_HEADER,                 /*!< En-tête du fichier compressé invalide. */
+    ERR_IO_SIZE,                /*!< Taille du fichier sortant différente de
+                                   la taille attendue. */
+    ERR_IO_FOPEN,               /*!< Erreur pendant l'ouverture du fichier. */
+    ERR_BUFFER_SMALL,           /*!< Zone mémoire sortante trop petite. */
+    ERR_ARCHIVE,                /*!< Archive invalide, ou nom de membre
+                                   incorrect ou en double. */
+    ERR_ARCHIVE_MEMBER,         /*!< Membre absent de l'archive. */
+    ERR_RANGE,                  /*!< Accès à un intervalle impossible sur un
+                                   fichier qui n'est pas découpé en blocs. */
+    ERR_CHECKSUM,               /*!< Somme de contrôle des données originales
+                                   absente ou incorrecte. */
+    ERR_NOT_TEXT                /*!< Données entrantes qui ne sont pas de
+                                   l'ASCII sans octet nul, refusées par
+                                   l'algorithme. */
+};
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * \file codec.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Codecs.
+ * \details Module d'aiguillage vers les algorithmes de compression, sur un
+ * couple de fichiers ou directement sur des zones mémoires.
+ */
+
+/* Chaque algorithme est décrit dans un registre (codec_desc) par son nom,
+ * l'option qui le choisit, ses capacités, la lecture de ses réglages et ses
+ * fonctions de compression et de décompression. La ligne de commande, les
+ * statistiques et le banc de mesure parcourent ce registre : ajouter un
+ * algorithme revient à ajouter son identifiant à "algo_e" et sa description
+ * au registre.
+ * Les algorithmes ne partagent aucun état modifiable : tout ce qui est propre
+ * à un traitement (sens, niveau, chaîne, erreur, statistiques) est porté par un
+ * contexte "codec_ctx_s", et plusieurs contextes peuvent être utilisés en même
+ * temps sur des threads différents. L'erreur d'un algorithme est portée par
+ * son couple de fichiers (cmpf_get_err), puis par le contexte. */
+
+#ifndef __CODEC_H
+#define __CODEC_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "init.h"
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+
+/* Macro-constantes publiques =============================================== */
+
+/** Taille originale inconnue, pour codec_run_mem. */
+#define CODEC_SIZE_UNKNOWN UINT64_MAX
+/** Taille en byte d'un message d'erreur des fonctions "parse" du registre. */
+#define CODEC_ERR_SIZE 128
+
+/* Structures publiques ===================================================== */
+
+/** Capacités d'un algorithme, combinables. */
+enum codec_cap {
+    CODEC_CAP_BINARY = 1 << 0,  /*!< Accepte tout les octets, et pas
+                                   seulement l'ASCII sans octet nul (les
+                                   autres données sont refusées avec
+                                   ERR_NOT_TEXT). */
+    CODEC_CAP_PARALLEL = 1 << 1,        /*!< Compresse par défaut en mode
+                                           parallèle. */
+    CODEC_CAP_SEEKABLE = 1 << 2 /*!< Ses blocs du mode parallèle se
+                                   décompressent chacun seul : --range peut
+                                   n'en décompresser qu'une partie. */
+};
+
+typedef struct codec_desc codec_desc_s;
+typedef struct codec_ctx codec_ctx_s;
+
+/** Description d'un algorithme dans le registre. */
+struct codec_desc {
+    algo_e algo;                /*!< Identifiant, inscrit dans les
+                                   en-têtes. */
+    const char *s_name;         /*!< Nom. */
+    const char *s_option;       /*!< Option longue de la ligne de commande
+                                   qui le choisit, NULL s'il n'en a pas. */
+    int caps;                   /*!< Capacités (enum codec_cap). */
+    /** Lit les réglages de l'algorithme (argument de son option, ou niveau
+     * -1 à -9) dans "ctx", NULL s'il n'en a pas. "s_arg" est NULL si aucun
+     * réglage n'est donné. Renvoie 0 sur un succès, -1 si les réglages sont
+     * invalides ou manquent, et écrit alors dans "s_err" (de "err_size"
+     * bytes, CODEC_ERR_SIZE suffit ; rien si NULL) un message qui nomme le
+     * réglage fautif et la limite dépassée. */
+    int (*parse)(codec_ctx_s * ctx, const char *s_arg, char *s_err,
+                 const size_t err_size);
+    /** Compresse le fichier entrant de "cf" sur le fichier sortant, NULL si
+     * l'algorithme a des réglages ou ne s'applique pas à un couple de
+     * fichiers. */
+    int (*compress)(cmp_file_s * cf);
+    /** Compresse le fichier entrant de "cf" sur le fichier sortant, avec les
+     * réglages de "ctx" (niveau, chaîne de transformations), NULL si
+     * l'algorithme n'a pas de réglages. */
+    int (*compress_ctx)(cmp_file_s * cf, const codec_ctx_s * ctx);
+    /** Décompresse le fichier entrant de "cf" sur le fichier sortant, NULL si
+     * l'algorithme ne s'applique pas à un couple de fichiers. */
+    int (*decompress)(cmp_file_s * cf);
+};
+
+/** Contexte d'un traitement. */
+struct codec_ctx {
+    mode_e mode;                /*!< Sens : compression ou décompression. */
+    algo_e algo;                /*!< Algorithme à utiliser (modifié
+                                   seulement par les fonctions du module). */
+    const codec_desc_s *p_desc; /*!< Description de l'algorithme, résolue
+                                   une seule fois (NULL si inconnu). */
+    int level;                  /*!< Niveau de compression (0 : niveau par
+                                   défaut de l'algorithme). */
+    pipe_spec_s pipe;           /*!< Chaîne de transformations de ALGO_PIPE
+                                   (vide par défaut). */
+    int store;                  /*!< Vrai (par défaut) pour stocker telles
+                                   quelles les données que l'algorithme
+                                   agrandirait (codec_run_mem). */
+    int verify;                 /*!< Vrai (par défaut) pour vérifier les
+                                   sommes de contrôle des données originales
+                                   à la décompression. */
+    err_code_e err;             /*!< Erreur du dernier traitement. */
+    uint64_t in_total;          /*!< Nombre de bytes lus par les traitements. */
+    uint64_t out_total;         /*!< Nombre de bytes produits par les
+                                   traitements. */
+    uint64_t read_ns;           /*!< Temps passé à lire les données
+                                   entrantes, en nanosecondes. */
+    uint64_t codec_ns;          /*!< Temps passé dans l'algorithme, en
+                                   nanosecondes. */
+    uint64_t write_ns;          /*!< Temps passé à écrire les données
+                                   produites, en nanosecondes. */
+};
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Renvoie la description de l'algorithme "algo" dans le registre.
+ * \param algo Identifiant de l'algorithme.
+ * \return Description de l'algorithme, NULL s'il est inconnu (ALGO_NONE,
+ * ALGO_NB ou au-delà).
+ */
+const codec_desc_s *codec_desc(const algo_e algo);
+
+/**
+ * Cherche un algorithme par son nom dans le registre.
+ * \param s_name Nom de l'algorithme, sensible à la casse.
+ * \return Description de l'algorithme, NULL si aucun ne porte ce nom.
+ */
+const codec_desc_s *codec_find(const char *s_name);
+
+/**
+ * Initialise un contexte, sans erreur ni statistiques ni chaîne de
+ * transformations, et résout la description de son algorithme.
+ * \param ctx Contexte à initialiser.
+ * \param mode Compression ou décompression.
+ * \param algo Algorithme à utiliser.
+ * \param level Niveau de compression (0 : niveau par défaut).
+ */
+void codec_init(codec_ctx_s * ctx, const mode_e mode, const algo_e algo,
+                const int level);
+
+/**
+ * Choisit l'algorithme le plus rapide pour compresser des données, à partir
+ * d'un échantillon : l'entropie d'ordre 0 et des simulations rapides de
+ * RLE-BIN et de LZ donnent le taux estimé de chaque algorithme, et le plus
+ * rapide dont le taux approche le meilleur est retenu. Les données jugées
+ * incompressibles sont stockées telles quelles (ALGO_STORED).
+ * \param p_src Données à compresser.
+ * \param size Taille des données en byte.
+ * \return Algorithme choisi (jamais ALGO_AUTO).
+ */
+algo_e codec_pick(const byte_t * p_src, const size_t size);
+
+/**
+ * Lance l'algorithme du contexte dans son sens sur un couple de fichiers, sans
+ * en-tête (ALGO_AUTO n'y est pas accepté). Ajoute les bytes lus et produits
+ * et le temps passé dans chaque phase (lecture, algorithme, écriture) aux
+ * statistiques du contexte.
+ * \param ctx Contexte du traitement.
+ * \param cf Couple fichier entrant/sortant à traiter.
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" du contexte sur
+ * l'erreur correspondante (celle de "cf").
+ * \error ERR_BAD_ADRESS si un pointeur est nulle ou invalide.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression
+ * ou si l'algorithme est inconnu.
+ * \error ERR_NOT_TEXT si l'algorithme n'a pas CODEC_CAP_BINARY et que les
+ * données entrantes ne sont pas du texte (voir io_is_text) : rien d'illisible
+ * n'est produit.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si l'algorithme est inconnu.
+ */
+int codec_run(codec_ctx_s * ctx, cmp_file_s * cf);
+
+/**
+ * Lance l'algorithme du contexte dans son sens sur une zone mémoire, et
+ * alloue la zone mémoire résultante, que l'appelant devra libérer avec
+ * "free". En compression, ALGO_AUTO est remplacé dans le contexte par
+ * l'algorithme que choisit codec_pick, et si le résultat n'est pas plus petit
+ * que les données entrantes, elles sont stockées telles quelles et
+ * l'algorithme du contexte devient ALGO_STORED (sauf si "store" est faux).
+ * Les données stockées sont simplement copiées dans les deux sens. Ajoute la
+ * taille des deux zones et le temps de traitement aux statistiques du
+ * contexte.
+ * \param ctx Contexte du traitement.
+ * \param p_in Données entrantes.
+ * \param in_size Taille des données entrantes en byte.
+ * \param raw_size Taille attendue des données décompressées, allouées en une
+ * fois et vérifiées (CODEC_SIZE_UNKNOWN si inconnue ou en compression).
+ * \param pp_out Pointeur recevant l'adresse des données sortantes.
+ * \param p_out_size Pointeur recevant la taille des données sortantes.
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" du contexte sur
+ * l'erreur correspondante ("*pp_out" est alors NULL).
+ * \error Voir codec_run et cmpf_close_mem.
+ */
+int codec_run_mem(codec_ctx_s * ctx, const byte_t * p_in,
+                  const size_t in_size, const uint64_t raw_size,
+                  byte_t ** pp_out, size_t * p_out_size);
+
+#endif
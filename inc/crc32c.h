@@ -0,0 +1,46 @@
+/**
+ * \file crc32c.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Sommes de contrôle.
+ * \details Module de calcul des sommes de contrôle CRC32C (polynôme de
+ * Castagnoli), qui protègent les fichiers compressés contre la troncature et
+ * la corruption. Le calcul utilise l'instruction "crc32" de SSE4.2 quand le
+ * processeur la supporte.
+ */
+
+#ifndef __CRC32C_H
+#define __CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Macro-constantes publiques =============================================== */
+
+/** Somme de contrôle de données vides, valeur initiale de crc32c_update. */
+#define CRC32C_INIT 0
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Met à jour une somme de contrôle avec des données : la somme de "A" puis
+ * "B" est crc32c_update(crc32c_update(CRC32C_INIT, A), B).
+ * \param crc Somme de contrôle des données qui précèdent.
+ * \param p_src Données à ajouter (peut être NULL si "size" est nul).
+ * \param size Taille des données en byte.
+ * \return Somme de contrôle mise à jour.
+ */
+uint32_t crc32c_update(uint32_t crc, const void *p_src, size_t size);
+
+/**
+ * Calcule la somme de contrôle de la concaténation de deux suites de données
+ * à partir de leurs sommes, sans relire les données.
+ * \param crc1 Somme de contrôle de la première suite.
+ * \param crc2 Somme de contrôle de la seconde suite.
+ * \param len2 Taille de la seconde suite en byte.
+ * \return Somme de contrôle de la concaténation.
+ */
+uint32_t crc32c_combine(uint32_t crc1, const uint32_t crc2, uint64_t len2);
+
+#endif
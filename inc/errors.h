@@ -11,50 +11,31 @@
 #ifndef __ERRORS_H
 #define __ERRORS_H
 
-/* Types publiques ========================================================== */
+#include "cmp_types.h"
 
-typedef enum err_code err_code_e;
-
-/* Variales globales ======================================================== */
+/* Fonctions publiques ====================================================== */
 
 /**
- * Variable mise à la disposition des fonctions pour y inscrire leur
- * code d'erreur.
+ * Renvoie la description d'un code d'erreur.
+ * \param err Code d'erreur.
+ * \return Chaîne de caractères constante décrivant l'erreur.
  */
-err_code_e CMP_err;
-
-/* Énumérations publiques =================================================== */
+const char *err_str(const err_code_e err);
 
 /**
- * Liste des codes d'erreurs du programme. Utilisé dans le retour des
- * fonctions et dans la correspondance erreur <=> message. Le code 0 signifie
- * (sauf cas particulier) qu'aucune erreur ne s'est produite.
+ * Affiche le message d'erreur sur la sortie d'erreur en fonction du code
+ * d'erreur spécifié.
+ * \param err Code d'erreur.
  */
-enum err_code {
-    ERR_OTHER = -1,             /*!< Erreur quelconque. */
-    ERR_NONE = 0,               /*!< Aucune erreur. */
-    ERR_BAD_ADRESS,             /*!< Pointeur null ou invalide. */
-    ERR_INIT_MISSING_OPTIONS,   /*!< Options nécéssaires au programme
-                                   manquantes. */
-    ERR_STAT,                   /*!< Erreur pendant la récupération des
-                                   statistiques. */
-    ERR_IO_FREAD,               /*!< Erreur pendant la lecture du fichier. */
-    ERR_IO_FREAD_EOF,           /*!< Erreur pendant la lecture du fichier car la
-                                   fin à déjà été atteinte. */
-    ERR_IO_FWRITE,              /*!< Erreur pendant l'écriture du fichier. */
-    ERR_IO_FCLOSE,              /*!< Erreur pendant la fermeture du fichier. */
-    ERR_COMPRESSION_FAILED,     /*!< Erreur durant la compression. */
-    ERR_DECOMPRESSION_FAILED    /*!< Erreur durant la décompression. */
-};
-
-/* Fonctions publiques ====================================================== */
+void err_print(const err_code_e err);
 
 /**
  * Affiche le message d'erreur sur la sortie d'erreur en fonction du code
- * d'erreur spécifié.
+ * d'erreur spécifié, suivi du chemin du fichier qui l'a causée.
  * \param err Code d'erreur.
+ * \param s_path Chemin du fichier en cause.
  */
-void err_print(const err_code_e err);
+void err_print_path(const err_code_e err, const char *s_path);
 
 /**
  * Affiche l'aide sur le flux spécifié et quitte le programme avec le code
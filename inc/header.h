@@ -0,0 +1,158 @@
+/**
+ * \file header.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief En-tête.
+ * \details Module de lecture et d'écriture de l'en-tête des fichiers
+ * compressés, qui permet de les décompresser sans préciser l'algorithme.
+ */
+
+/* Format de l'en-tête, de HDR_SIZE bytes en little endian :
+ * - Nombre magique HDR_MAGIC (4 bytes).
+ * - Version du format (8 bits).
+ * - Identifiant de l'algorithme ("algo_e", 8 bits).
+ * - Flags (8 bits, voir HDR_FLAG_*).
+ * - Paramètre de l'algorithme nécessaire à la décompression (8 bits, nombre de
+ *   bits du code de répétition pour RLE, 0 sinon).
+ * - Taille du fichier original (64 bits, 0 si HDR_FLAG_SIZE est absent).
+ * - Somme de contrôle CRC32C (voir crc32c.h) des HDR_SIZE bytes qui
+ *   précèdent (32 bits, seulement si HDR_FLAG_CHECKSUM est présent).
+ * Les données compressées suivent l'en-tête. Avec HDR_FLAG_CHECKSUM, un
+ * fichier qui n'est pas découpé en blocs se termine par la somme de contrôle
+ * CRC32C des données originales (HDR_TRAILER_SIZE bytes) ; celle d'un fichier
+ * découpé en blocs est portée par l'en-tête de bloc nul (voir parallel.h). */
+
+#ifndef __HEADER_H
+#define __HEADER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "init.h"
+#include "io.h"
+#include "common.h"
+
+/* Macro-constantes publiques =============================================== */
+
+/** Nombre magique au début des fichiers compressés. */
+#define HDR_MAGIC "CMP0"
+/** Version du format. */
+#define HDR_VERSION 1
+/** Taille de l'en-tête sans la somme de contrôle en byte. */
+#define HDR_SIZE 16
+/** Taille maximale de l'en-tête (avec la somme de contrôle) en byte. */
+#define HDR_SIZE_MAX (HDR_SIZE + 4)
+/** Taille de la somme de contrôle des données originales qui termine un
+ * fichier non découpé en blocs avec le flag HDR_FLAG_CHECKSUM. */
+#define HDR_TRAILER_SIZE 4
+
+/** Flag, le fichier est découpé en blocs indépendants (voir parallel.h). */
+#define HDR_FLAG_PARALLEL 0x01
+/** Flag, la taille du fichier original est connue. */
+#define HDR_FLAG_SIZE 0x02
+/** Flag, l'en-tête et les données originales sont protégés par des sommes
+ * de contrôle. */
+#define HDR_FLAG_CHECKSUM 0x04
+/** Flag, une table d'accès aux blocs termine le fichier (voir parallel.h). */
+#define HDR_FLAG_SEEK 0x08
+
+/* Structures publiques ===================================================== */
+
+typedef struct header header_s;
+
+/** En-tête d'un fichier compressé. */
+struct header {
+    algo_e algo;                /*!< Algorithme de compression. */
+    byte_t flags;               /*!< Flags HDR_FLAG_*. */
+    byte_t param;               /*!< Paramètre de l'algorithme. */
+    uint64_t size;              /*!< Taille du fichier original. */
+};
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Initialise un en-tête pour l'algorithme spécifié, avec ses paramètres, sans
+ * flag.
+ * \param hdr En-tête à initialiser.
+ * \param algo Algorithme de compression.
+ */
+void hdr_init(header_s * hdr, const algo_e algo);
+
+/**
+ * Encode un en-tête dans une zone mémoire.
+ * \param hdr En-tête à encoder.
+ * \param p_dest Zone mémoire d'au moins HDR_SIZE_MAX bytes.
+ * \return Taille de l'en-tête encodé en byte.
+ */
+size_t hdr_encode(const header_s * hdr, byte_t * p_dest);
+
+/**
+ * Décode et vérifie l'en-tête au début d'une zone mémoire.
+ * \param hdr En-tête lu.
+ * \param p_src Zone mémoire contenant le début du fichier compressé.
+ * \param size Nombre de bytes disponibles dans "p_src".
+ * \return Taille de l'en-tête en byte sur un succès, 0 si "size" est trop
+ * petit pour contenir l'en-tête entier, -1 si un pointeur est incorrect ou si
+ * l'en-tête est invalide, corrompu (somme de contrôle incorrecte) ou d'une
+ * version non supportée.
+ */
+int hdr_decode(header_s * hdr, const byte_t * p_src, const size_t size);
+
+/**
+ * Écris un en-tête sur le fichier sortant.
+ * \param cf Fichier sortant.
+ * \param hdr En-tête à écrire.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de "cf"
+ * sur l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_IO_FWRITE si une erreur survient lors de l'écriture.
+ */
+int hdr_write(cmp_file_s * cf, const header_s * hdr);
+
+/**
+ * Lit et vérifie l'en-tête au début du fichier entrant.
+ * \param cf Fichier entrant.
+ * \param hdr En-tête lu.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de "cf"
+ * sur l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_HEADER si l'en-tête est absent, invalide, corrompu ou d'une
+ * version non supportée.
+ */
+int hdr_read(cmp_file_s * cf, header_s * hdr);
+
+/**
+ * Équivalent de hdr_write sur un fichier ouvert avec "fopen".
+ * \param fp Fichier sortant.
+ * \param hdr En-tête à écrire.
+ * \return 0 sur un succès, -1 si un pointeur est incorrect ou si l'écriture
+ * échoue.
+ */
+int hdr_fwrite(FILE * fp, const header_s * hdr);
+
+/**
+ * Équivalent de hdr_read sur un fichier ouvert avec "fopen".
+ * \param fp Fichier entrant.
+ * \param hdr En-tête lu.
+ * \return 0 sur un succès, -1 si un pointeur est incorrect ou si l'en-tête
+ * est absent, invalide, corrompu ou d'une version non supportée.
+ */
+int hdr_fread(FILE * fp, header_s * hdr);
+
+/**
+ * Encode la somme de contrôle des données originales qui termine un fichier
+ * non découpé en blocs.
+ * \param p_dest Zone mémoire d'au moins HDR_TRAILER_SIZE bytes.
+ * \param checksum Somme de contrôle CRC32C des données originales.
+ */
+void hdr_encode_trailer(byte_t * p_dest, const uint32_t checksum);
+
+/**
+ * Décode la somme de contrôle des données originales qui termine un fichier
+ * non découpé en blocs.
+ * \param p_src Zone mémoire de HDR_TRAILER_SIZE bytes.
+ * \return Somme de contrôle CRC32C des données originales.
+ */
+uint32_t hdr_decode_trailer(const byte_t * p_src);
+
+#endif
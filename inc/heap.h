@@ -0,0 +1,67 @@
+/**
+ * \file heap.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Tas binaire.
+ * \details Module d'implémentation d'un tas binaire minimum (file de
+ * priorité), dont les éléments sont des couples clé/valeur triés par clé
+ * croissante.
+ */
+
+#ifndef __HEAP_H
+#define __HEAP_H
+
+#include <stdint.h>
+
+/* Structures publiques ===================================================== */
+
+typedef struct heap heap_s;
+typedef struct heap_node heap_node_s;
+
+/** Élément d'un tas binaire. */
+struct heap_node {
+    uint64_t key;               /*!< Clé de tri (priorité). */
+    int value;                  /*!< Valeur associée à la clé. */
+};
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Crée un tas binaire vide.
+ * \param cap Nombre maximal d'éléments du tas.
+ * \return Pointeur vers le tas, ou NULL si l'allocation a échoué.
+ */
+heap_s *heap_new(const int cap);
+
+/**
+ * Libère la mémoire d'un tas binaire.
+ * \param h Tas à libérer (peut être NULL).
+ */
+void heap_free(heap_s * h);
+
+/**
+ * Renvoie le nombre d'éléments d'un tas binaire.
+ * \param h Tas binaire.
+ * \return Nombre d'éléments.
+ */
+int heap_size(const heap_s * h);
+
+/**
+ * Ajoute un élément à un tas binaire.
+ * \param h Tas binaire.
+ * \param key Clé de l'élément.
+ * \param value Valeur de l'élément.
+ * \return 0 sur un succès, -1 si le tas est plein.
+ */
+int heap_push(heap_s * h, const uint64_t key, const int value);
+
+/**
+ * Retire l'élément de plus petite clé d'un tas binaire.
+ * \param h Tas binaire.
+ * \param node Élément retiré.
+ * \return 0 sur un succès, -1 si le tas est vide.
+ */
+int heap_pop(heap_s * h, heap_node_s * node);
+
+#endif
@@ -11,36 +11,91 @@
 #ifndef __INIT_H
 #define __INIT_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "cmp_types.h"
+
+/* Macro-constantes publiques =============================================== */
+
+/** Nombre maximal d'étages d'une chaîne de transformations (--pipeline). */
+#define PIPE_STAGES_MAX 8
+
 /* Énumérations publiques ==================================================== */
 
-typedef enum mode mode_e;
-typedef enum algo algo_e;
+typedef enum stat_format stat_format_e;
+typedef enum pipe_stage pipe_stage_e;
 
-/** Liste les modes possibles de fonctionnement du programme. */
-enum mode {
-    MODE_NONE = 0,              /*!< Aucun mode. */
-    MODE_COMPRESS,              /*!< Mode de compression de fichier. */
-    MODE_DECOMPRESS             /*!< Mode de décompression de fichier. */
+/** Liste les formats d'affichage des statistiques. */
+enum stat_format {
+    STAT_NONE = 0,              /*!< Pas de statistiques. */
+    STAT_TEXT,                  /*!< Texte à lire. */
+    STAT_JSON,                  /*!< Objet JSON sur une ligne. */
+    STAT_CSV                    /*!< Ligne des noms des colonnes, puis ligne
+                                   des valeurs. */
 };
 
-/** Liste les algorithmes disponibles pour la compression d'un fichier. */
-enum algo {
-    ALGO_NONE = 0,              /*!< Aucun algorithme. */
-    ALGO_RLE                    /*!< Run-Lenght Encoding. */
+/** Liste les étages d'une chaîne de transformations. Les identifiants sont
+ * inscrits dans les données compressées : un nouvel étage est ajouté avant
+ * STAGE_NB. */
+enum pipe_stage {
+    STAGE_NONE = 0,             /*!< Aucun étage. */
+    STAGE_DELTA,                /*!< Différence avec l'octet situé N octets
+                                   avant. */
+    STAGE_TRANSPOSE,            /*!< Regroupement des octets de même rang
+                                   d'enregistrements de N octets. */
+    STAGE_RLE,                  /*!< Run-Lenght Encoding, moteur binaire. */
+    STAGE_HUFFMAN,              /*!< Codage de Huffman. */
+    STAGE_ANS,                  /*!< Codage rANS à états entrelacés. */
+    STAGE_NB                    /*!< Nombre d'identifiants d'étages. */
 };
 
 /* Structures publiques ===================================================== */
 
+typedef struct pipe_spec pipe_spec_s;
 typedef struct prog_info prog_info_s;
 
+/** Chaîne de transformations, appliquées dans l'ordre à la compression et
+ * dans l'ordre inverse à la décompression. */
+struct pipe_spec {
+    int nb_stages;              /*!< Nombre d'étages (0 : chaîne vide). */
+    pipe_stage_e a_stages[PIPE_STAGES_MAX];     /*!< Étages. */
+    int a_params[PIPE_STAGES_MAX];      /*!< Paramètre N de chaque étage
+                                           (1 à 255, 0 pour les étages qui
+                                           n'en ont pas). */
+};
+
 /** Informations sur l'instance du programme. */
 struct prog_info {
-    char stat;                  /*!< Flag, afficher les statistiques. */
+    stat_format_e stat;         /*!< Format des statistiques à afficher
+                                   (STAT_NONE : aucune). */
     mode_e mode;                /*!< Mode d'exécution. */
     algo_e algo;                /*!< Algorithme à utiliser. */
+    int nb_threads;             /*!< Nombre de threads du mode parallèle (0 :
+                                   mode séquentiel). */
+    int level;                  /*!< Niveau de compression (0 : niveau par
+                                   défaut de l'algorithme). */
+    pipe_spec_s pipe;           /*!< Chaîne de transformations de ALGO_PIPE
+                                   (--pipeline). */
+    size_t io_buffer;           /*!< Taille des buffers d'écriture en byte
+                                   (0 : taille par défaut). */
+    int io_direct;              /*!< Vrai pour écrire le fichier sortant sans
+                                   le cache du système. */
+    int verify;                 /*!< Vrai pour vérifier les sommes de contrôle
+                                   à la décompression. */
     char *s_prog_name;          /*!< Nom du programme. */
     char *s_input_file;         /*!< Nom du fichier entrant. */
-    char s_output_file[256];    /*!< Nom du fichier sortant. */
+    char s_output_file[256];    /*!< Nom du fichier sortant (répertoire de
+                                   destination pour l'extraction d'une
+                                   archive). */
+    char *s_archive;            /*!< Nom de l'archive (NULL hors du mode
+                                   archive). */
+    char *const *a_s_members;   /*!< Fichiers et répertoires à archiver, ou
+                                   membres à extraire (tous si aucun). */
+    int nb_members;             /*!< Nombre d'éléments de "a_s_members". */
+    uint64_t range_offset;      /*!< Position des données originales à
+                                   extraire. */
+    uint64_t range_len;         /*!< Longueur des données originales à
+                                   extraire (0 : tout le fichier). */
 };
 
 /* Fonctions publiques ====================================================== */
@@ -14,9 +14,13 @@
 #include <stdint.h>
 #include <assert.h>
 #include "common.h"
+#include "errors.h"
 
 /* Macro-constantes publiques =============================================== */
 
+/** Chemin désignant l'entrée standard ou la sortie standard. */
+#define IO_STD_PATH "-"
+
 /** Taille d'un bloc en byte. */
 #define BLOCK_SIZE sizeof(block_t)
 /** Longueur d'un bloc en bit. */
@@ -60,23 +64,77 @@ typedef struct cmp_file cmp_file_s;
 /* Fonctions publiques ====================================================== */
 
 /**
- * Initialise les flux vers les fichiers entrant et sortant, initialise la
- * structure pour qu'elle soit prête à être utilisée et assure les routines de
- * détection d'erreurs. Quitte le programme avec "EXIT_FAILURE" si une erreur
- * survient.
- * \param filepath_in Chemin vers le fichier entrant.
- * \param filepath_out Chemin vers le fichier sortant.
- * \return Pointeur vers la structure d'un fichier prêt à être traité.
+ * Ouvre un fichier avec "fopen", ou renvoie l'entrée standard ou la sortie
+ * standard (selon "s_mode") si le chemin est IO_STD_PATH. Le flux reçoit un
+ * buffer de grande taille, pour lire et écrire les tubes par gros morceaux.
+ * \param s_filepath Chemin vers le fichier, ou IO_STD_PATH.
+ * \param s_mode Mode d'ouverture de "fopen".
+ * \return Pointeur vers le flux ouvert, ou NULL si le fichier ne peut pas être
+ * ouvert ("errno" en indique la cause).
+ */
+FILE *io_fopen(const char *s_filepath, const char *s_mode);
+
+/**
+ * Renvoie le temps écoulé depuis une origine fixe (horloge monotone), pour
+ * mesurer des durées.
+ * \return Temps en nanosecondes.
+ */
+uint64_t io_time_ns(void);
+
+/**
+ * Indique si des données sont de l'ASCII sans octet nul, seules données
+ * acceptées par les algorithmes sans CODEC_CAP_BINARY (voir codec.h).
+ * \param p_data Données à vérifier.
+ * \param size Taille des données en byte.
+ * \return Vrai si les données sont du texte, faux sinon.
+ */
+int io_is_text(const byte_t * p_data, const size_t size);
+
+/**
+ * Ouvre les fichiers entrant et sortant avec io_fopen (IO_STD_PATH désigne
+ * l'entrée ou la sortie standard), puis initialise la structure avec
+ * cmpf_open_fp.
+ * \param s_filepath_in Chemin vers le fichier entrant.
+ * \param s_filepath_out Chemin vers le fichier sortant.
+ * \return Pointeur vers la structure d'un fichier prêt à être traité, ou NULL
+ * si un fichier ne peut pas être ouvert ou si la structure ne peut pas être
+ * initialisée.
  */
 cmp_file_s *cmpf_open(const char *s_filepath_in, const char *s_filepath_out);
 
+/**
+ * Initialise la structure pour qu'elle soit prête à être utilisée sur des flux
+ * déjà ouverts, dont elle devient propriétaire (ils sont fermés par
+ * cmpf_close, même sur une erreur). La lecture reprend à la position courante
+ * du flux entrant. Un fichier entrant régulier est projeté en mémoire ("mmap")
+ * et ses blocs sont lus directement depuis la projection, les autres (tubes,
+ * etc.) sont lus par buffer avec "fread".
+ * \param fp_in Flux entrant.
+ * \param fp_out Flux sortant.
+ * \return Pointeur vers la structure d'un fichier prêt à être traité, ou NULL
+ * si un pointeur est incorrect, si la mémoire ne peut pas être allouée ou si
+ * le flux sortant ne peut pas être vidé.
+ */
+cmp_file_s *cmpf_open_fp(FILE * fp_in, FILE * fp_out);
+
+/**
+ * Initialise une structure de fichier dont le flux entrant est une zone
+ * mémoire et le flux sortant une zone mémoire allouée et agrandie
+ * automatiquement. La zone entrante doit rester valide jusqu'à la fermeture.
+ * \param p_in Pointeur vers les données entrantes.
+ * \param in_size Taille des données entrantes en byte.
+ * \return Pointeur vers la structure d'un fichier prêt à être traité, ou NULL
+ * si un pointeur est incorrect ou si la structure ne peut pas être allouée.
+ */
+cmp_file_s *cmpf_open_mem(const byte_t * p_in, const size_t in_size);
+
 /**
  * Lit un bloc de donnée du fichier entrant depuis son buffer, et le stocke dans
  * un bloc.
  * \param cf Fichier source.
  * \param b Bloc à remplir.
- * \return 0 sur un succès, -1 sur une erreur et positionne "CMP_err" sur
- * l'erreur correspondante.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
  * \error ERR_BAD_ADRESS si un pointeur est incorrect.
  * \error ERR_IO_FREAD si une erreur survient lors de la lecture.
  * \error ERR_IO_FREAD_EOF si on à déjà lu la fin du fichier.
@@ -84,30 +142,243 @@ cmp_file_s *cmpf_open(const char *s_filepath_in, const char *s_filepath_out);
 int cmpf_get_block(cmp_file_s * cf, block_t * b);
 
 /**
- * Écris un bloc de donnée sur un buffer d'un fichier sortant.
+ * Lit au plus "size" bytes du fichier entrant et les stocke dans "p_dest". Au
+ * contraire de cmpf_get_block, permet de connaître la longueur exacte des
+ * données lues.
+ * \param cf Fichier source.
+ * \param p_dest Zone mémoire à remplir.
+ * \param size Nombre de bytes à lire.
+ * \return Nombre de bytes lus, inférieur à "size" seulement à la fin du fichier
+ * ou sur une erreur, et positionne alors l'erreur de "cf" sur l'erreur
+ * correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_IO_FREAD si une erreur survient lors de la lecture.
+ * \error ERR_IO_FREAD_EOF si la fin du fichier est atteinte.
+ */
+size_t cmpf_get_bytes(cmp_file_s * cf, byte_t * p_dest, const size_t size);
+
+/**
+ * Écris un bloc de donnée sur un buffer d'un fichier sortant. Les BLOCK_SIZE
+ * bytes du bloc sont tous écrits : un dernier bloc incomplet doit être écrit
+ * avec cmpf_put_bytes, à sa longueur exacte.
  * \param cf Fichier sortant.
  * \param b Bloc à écrire.
- * \return 0 sur un succès, -1 sur une erreur et positionne "CMP_err" sur
- * l'erreur correspondante.
- * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
  * \error ERR_IO_FWRITE si une erreur survient lors de l'écriture.
  */
 int cmpf_put_block(cmp_file_s * cf, block_t b);
 
+/**
+ * Écris "size" bytes sur le buffer d'un fichier sortant. Les gros morceaux
+ * sont écrits directement depuis "p_src", sans copie dans les buffers.
+ * \param cf Fichier sortant.
+ * \param p_src Données à écrire.
+ * \param size Nombre de bytes à écrire.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_IO_FWRITE si une erreur survient lors de l'écriture.
+ */
+int cmpf_put_bytes(cmp_file_s * cf, const byte_t * p_src, const size_t size);
+
+/**
+ * Configure l'écriture du fichier sortant : taille des deux buffers
+ * d'écriture, et écriture directe sans le cache du système (O_DIRECT), si le
+ * système la supporte pour ce fichier (sinon elle est ignorée). Les buffers
+ * sont alignés sur une page. Sans effet sur une zone mémoire sortante.
+ * \param cf Fichier sortant.
+ * \param buf_size Taille de chaque buffer en byte, arrondie à la page
+ * supérieure (0 : taille par défaut, 1 MiB).
+ * \param direct Vrai pour demander l'écriture directe.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_IO_FWRITE si les buffers ne peuvent pas être vidés.
+ * \error ERR_OTHER si les buffers ne peuvent pas être alloués.
+ */
+int cmpf_set_output(cmp_file_s * cf, const size_t buf_size, const int direct);
+
+/**
+ * Récupère la taille du fichier entrant, si elle est connue à l'avance
+ * (fichier régulier ou zone mémoire).
+ * \param cf Fichier entrant.
+ * \param p_size Taille du fichier entrant en byte.
+ * \return 0 sur un succès, -1 si la taille est inconnue (tube, etc.) ou si
+ * un pointeur est nul.
+ */
+int cmpf_get_size(const cmp_file_s * cf, uint64_t * p_size);
+
+/**
+ * Récupère le nombre de bytes lus sur le fichier entrant et écrits sur le
+ * fichier sortant depuis l'ouverture (y compris ceux encore dans le buffer
+ * d'écriture).
+ * \param cf Couple de fichiers.
+ * \param p_in Nombre de bytes lus.
+ * \param p_out Nombre de bytes écrits.
+ */
+void cmpf_get_totals(const cmp_file_s * cf, uint64_t * p_in,
+                     uint64_t * p_out);
+
+/**
+ * Récupère le temps passé à lire le fichier entrant et à écrire le fichier
+ * sortant depuis l'ouverture. Les lectures et écritures étant faites en
+ * avance par des threads dédiés, seul le temps passé à les attendre est
+ * compté. La lecture d'un fichier projeté en mémoire n'est pas comptée (elle
+ * a lieu pendant le traitement).
+ * \param cf Couple de fichiers.
+ * \param p_read_ns Temps de lecture en nanosecondes.
+ * \param p_write_ns Temps d'écriture en nanosecondes.
+ */
+void cmpf_get_times(const cmp_file_s * cf, uint64_t * p_read_ns,
+                    uint64_t * p_write_ns);
+
+/**
+ * Indique la taille finale du flux sortant. Une zone mémoire sortante est
+ * allouée directement à cette taille, et la fermeture échoue si le nombre de
+ * bytes écrits est différent.
+ * \param cf Fichier sortant.
+ * \param size Taille attendue du flux sortant en byte.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_IO_FWRITE si la zone mémoire ne peut pas être allouée.
+ */
+int cmpf_set_size(cmp_file_s * cf, const uint64_t size);
+
+/**
+ * Réserve le fichier entrant au texte (voir io_is_text) : une zone mémoire ou
+ * un fichier projeté est vérifié aussitôt, et un fichier lu par buffers l'est
+ * à chaque chargement, dont les bytes ne sont pas rendus s'ils contiennent un
+ * octet nul ou hors de l'ASCII.
+ * \param cf Couple de fichiers.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_NOT_TEXT si les données entrantes ne sont pas du texte (la
+ * lecture échoue avec la même erreur).
+ */
+int cmpf_set_text(cmp_file_s * cf);
+
+/**
+ * Active le calcul de la somme de contrôle CRC32C (voir crc32c.h) de tout les
+ * bytes lus sur le fichier entrant, ou écrits sur le flux sortant. Le calcul
+ * a lieu sur les threads de lecture et d'écriture, pendant le traitement. À
+ * appeler avant la première lecture ou écriture concernée.
+ * \param cf Couple de fichiers.
+ * \param output Vrai pour le flux sortant, faux pour le fichier entrant.
+ * \return 0 sur un succès, -1 si "cf" est nul.
+ */
+int cmpf_set_checksum(cmp_file_s * cf, const int output);
+
+/**
+ * Renvoie la somme de contrôle du fichier entrant activée avec
+ * cmpf_set_checksum, une fois toutes ses données lues (depuis le dernier
+ * rembobinage).
+ * \param cf Fichier entrant.
+ * \return Somme de contrôle des données lues.
+ */
+uint32_t cmpf_get_checksum(cmp_file_s * cf);
+
+/**
+ * Indique la somme de contrôle attendue du flux sortant, activée avec
+ * cmpf_set_checksum : la fermeture échoue si elle n'est pas retrouvée.
+ * \param cf Fichier sortant.
+ * \param checksum Somme de contrôle attendue.
+ * \return 0 sur un succès, -1 si "cf" est nul.
+ */
+int cmpf_expect_checksum(cmp_file_s * cf, const uint32_t checksum);
+
+/**
+ * Retient les "size" derniers bytes du fichier entrant, qui ne sont pas
+ * transmis aux lectures et sont récupérés avec cmpf_get_trailer. À appeler
+ * avant la première lecture.
+ * \param cf Fichier entrant.
+ * \param size Nombre de bytes retenus (au plus 8).
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_IO_FREAD_EOF si le fichier entrant, de taille connue, est trop
+ * court.
+ */
+int cmpf_set_trailer(cmp_file_s * cf, const size_t size);
+
+/**
+ * Récupère les derniers bytes du fichier entrant retenus avec
+ * cmpf_set_trailer. Les données qui les précèdent et qui n'ont pas été lues
+ * sont ignorées.
+ * \param cf Fichier entrant.
+ * \param p_dest Zone mémoire recevant les bytes retenus.
+ * \return 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "cf" (voir cmpf_get_err) sur l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_IO_FREAD si une erreur survient lors de la lecture.
+ * \error ERR_IO_FREAD_EOF si le fichier entrant est trop court.
+ */
+int cmpf_get_trailer(cmp_file_s * cf, byte_t * p_dest);
+
 /**
  * Vide le buffer d'écriture sur le disque, ferme les flux vers les fichiers
  * entrant et sortant, et libère la mémoire de la structure.
  * \param cf Fichier à fermer.
- * \return 0 sur un succès, ou -1 sur une erreur et positionne "CMP_err" à
- * l'erreur correspondante.
+ * \return ERR_NONE sur un succès, ou l'erreur correspondante.
  * \error ERR_BAD_ADRESS si un pointeur est incorrect
  * \error ERR_IO_FWRITE si un problème survient lors du flush du buffer
  * d'écriture sur le disque.
+ * \error ERR_IO_FCLOSE si la fermeture du fichier sortant échoue.
+ * \error ERR_IO_SIZE si la taille indiquée par cmpf_set_size n'est pas
+ * respectée (les flux sont tout de même fermés).
+ * \error ERR_CHECKSUM si la somme de contrôle indiquée par
+ * cmpf_expect_checksum n'est pas retrouvée (les flux sont tout de même
+ * fermés).
+ */
+err_code_e cmpf_close(cmp_file_s * cf);
+
+/**
+ * Vide le buffer d'écriture dans la zone mémoire sortante, libère la structure
+ * ouverte avec cmpf_open_mem et transfère la zone mémoire sortante à
+ * l'appelant, qui devra la libérer avec "free".
+ * \param cf Fichier à fermer.
+ * \param pp_out Pointeur recevant l'adresse des données sortantes (peut être
+ * NULL si aucune donnée n'a été écrite).
+ * \param p_out_size Pointeur recevant la taille des données sortantes.
+ * \return ERR_NONE sur un succès, ou l'erreur correspondante (la structure
+ * est tout de même libérée).
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_IO_FWRITE si la zone mémoire sortante ne peut être agrandie.
+ * \error ERR_IO_SIZE si la taille indiquée par cmpf_set_size n'est pas
+ * respectée.
+ */
+err_code_e cmpf_close_mem(cmp_file_s * cf, byte_t ** pp_out,
+                          size_t * p_out_size);
+
+/**
+ * Renvoie l'erreur du fichier : celle de la dernière fonction qui a échoué
+ * sur ce fichier, ERR_IO_FREAD_EOF si la fin du fichier entrant a été
+ * atteinte, ou ERR_NONE. Les fonctions appelées avec "cf" nul renvoient une
+ * erreur sans la positionner.
+ * \param cf Fichier.
+ * \return Code d'erreur.
+ */
+err_code_e cmpf_get_err(const cmp_file_s * cf);
+
+/**
+ * Remplace l'erreur du fichier, par exemple par ERR_NONE avant une boucle de
+ * lecture qui s'arrête sur la fin du fichier.
+ * \param cf Fichier.
+ * \param err Code d'erreur.
+ */
+void cmpf_set_err(cmp_file_s * cf, const err_code_e err);
+
+/**
+ * Signale l'échec d'un traitement sur le fichier : positionne son erreur sur
+ * "err", sauf si elle indique déjà une cause (autre que ERR_NONE et
+ * ERR_IO_FREAD_EOF), qui est conservée.
+ * \param cf Fichier.
+ * \param err Code d'erreur de l'échec.
+ * \return Toujours -1.
  */
-int cmpf_close(cmp_file_s * cf);
+int cmpf_fail(cmp_file_s * cf, const err_code_e err);
 
 /**
- * Rembobine le fichier d'entrée.
+ * Rembobine le fichier d'entrée, et remet à zéro sa somme de contrôle et son
+ * erreur.
  * \param cf Pointeur vers une structure contenant le fichier entrant à
  * rembobiner.
  */
@@ -0,0 +1,189 @@
+/**
+ * \file libcompressor0.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Bibliothèque.
+ * \details Interface de la bibliothèque libcompressor0, qui permet de
+ * compresser et de décompresser des zones mémoires au sein d'un autre
+ * programme, sans lancer l'exécutable ni passer par le disque.
+ */
+
+/* Les données produites ont le même format que les fichiers de l'exécutable
+ * (voir header.h) : un fichier compressé par la bibliothèque peut être
+ * décompressé avec "compressor-0 -d", et inversement. Les fonctions ne
+ * modifient aucun état global, n'écrivent rien sur les sorties du programme
+ * et peuvent être appelées depuis plusieurs threads, chaque flux n'étant
+ * utilisé que par un seul thread à la fois. Le niveau de compression de LZ
+ * est celui par défaut.
+ * Les fonctions sur des zones mémoires renvoient la taille des données
+ * écrites, ou une valeur négative sur une erreur dont le code est donné par
+ * cmp_error. Les fonctions des flux renvoient 0 ou -1, et le code d'erreur
+ * est conservé dans le flux (voir cmp_stream_error). */
+
+#ifndef __LIBCOMPRESSOR0_H
+#define __LIBCOMPRESSOR0_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cmp_types.h"
+
+/* Structures publiques ===================================================== */
+
+typedef struct cmp_stream cmp_stream_s;
+
+/* Types publiques ========================================================== */
+
+/**
+ * Fonction de sortie d'un flux, appelée avec les données produites dans
+ * l'ordre.
+ * \param p_opaque Pointeur passé à cmp_stream_new.
+ * \param p_data Données produites.
+ * \param size Taille des données produites en byte.
+ * \return 0 sur un succès, une autre valeur pour interrompre le flux.
+ */
+typedef int (*cmp_write_f) (void *p_opaque, const void *p_data, size_t size);
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Renvoie le code d'erreur correspondant au retour d'une fonction sur des
+ * zones mémoires.
+ * \param ret Valeur renvoyée par la fonction.
+ * \return ERR_NONE si "ret" n'est pas une erreur, sinon le code d'erreur.
+ */
+err_code_e cmp_error(const int64_t ret);
+
+/**
+ * Renvoie la description d'un code d'erreur.
+ * \param err Code d'erreur.
+ * \return Chaîne de caractères constante décrivant l'erreur.
+ */
+const char *cmp_error_str(const err_code_e err);
+
+/**
+ * Renvoie une taille de zone mémoire suffisante pour compresser "src_len"
+ * bytes avec cmp_compress_buffer, quel que soit l'algorithme : les données
+ * que l'algorithme agrandirait sont stockées telles quelles, après l'en-tête.
+ * \param src_len Taille des données à compresser en byte.
+ * \return Taille maximale des données compressées en byte.
+ */
+size_t cmp_compress_bound(const size_t src_len);
+
+/**
+ * Compresse une zone mémoire dans une autre, en un seul bloc précédé de
+ * l'en-tête.
+ * \param algo Algorithme de compression (ALGO_AUTO : choisi d'après les
+ * données). ALGO_PIPE n'est pas accepté : sa chaîne de transformations
+ * n'est choisie que sur la ligne de commande (--pipeline).
+ * \param p_src Données à compresser.
+ * \param src_len Taille des données à compresser en byte.
+ * \param p_dst Zone mémoire recevant les données compressées.
+ * \param dst_cap Capacité de "p_dst" en byte (voir cmp_compress_bound).
+ * \return Taille des données compressées en byte, ou une valeur négative sur
+ * une erreur (voir cmp_error).
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression
+ * ou si l'algorithme est inconnu.
+ * \error ERR_BUFFER_SMALL si "dst_cap" est trop petit.
+ */
+int64_t cmp_compress_buffer(const algo_e algo, const void *p_src,
+                            const size_t src_len, void *p_dst,
+                            const size_t dst_cap);
+
+/**
+ * Lit la taille originale des données compressées dans leur en-tête.
+ * \param p_src Données compressées (au moins leur en-tête).
+ * \param src_len Taille de "p_src" en byte.
+ * \return Taille originale en byte, ou une valeur négative sur une erreur
+ * (voir cmp_error).
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_HEADER si l'en-tête est absent, invalide, ou ne contient pas la
+ * taille originale (données compressées par un flux ou depuis un tube).
+ */
+int64_t cmp_get_size(const void *p_src, const size_t src_len);
+
+/**
+ * Décompresse une zone mémoire produite par cmp_compress_buffer, un flux ou
+ * l'exécutable. L'algorithme est détecté grâce à l'en-tête.
+ * \param p_src Données compressées.
+ * \param src_len Taille des données compressées en byte.
+ * \param p_dst Zone mémoire recevant les données décompressées.
+ * \param dst_cap Capacité de "p_dst" en byte (voir cmp_get_size).
+ * \return Taille des données décompressées en byte, ou une valeur négative sur
+ * une erreur (voir cmp_error).
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_HEADER si l'en-tête est absent ou invalide.
+ * \error ERR_DECOMPRESSION_FAILED si les données sont corrompues.
+ * \error ERR_IO_SIZE si la taille originale n'est pas retrouvée.
+ * \error ERR_CHECKSUM si les données décompressées ne correspondent pas à la
+ * somme de contrôle enregistrée.
+ * \error ERR_BUFFER_SMALL si "dst_cap" est trop petit.
+ */
+int64_t cmp_decompress_buffer(const void *p_src, const size_t src_len,
+                              void *p_dst, const size_t dst_cap);
+
+/**
+ * Crée un flux de compression ou de décompression. En compression, les
+ * données sont découpées en blocs indépendants de PAR_CHUNK_SIZE bytes
+ * (format du mode parallèle) et chaque bloc est transmis à "write" dès qu'il
+ * est complet. En décompression, chaque bloc est transmis décompressé dès
+ * qu'il est entièrement reçu (les fichiers qui ne sont pas découpés en blocs
+ * sont décompressés à la fin du flux).
+ * \param mode Compression ou décompression.
+ * \param algo Algorithme de compression (ignoré en décompression), ou
+ * ALGO_AUTO pour le choisir bloc par bloc (ALGO_PIPE n'est pas accepté, voir
+ * cmp_compress_buffer).
+ * \param write Fonction de sortie des données produites.
+ * \param p_opaque Pointeur transmis à "write".
+ * \return Pointeur vers le flux, à libérer avec cmp_stream_free, ou NULL si
+ * un paramètre est invalide ou si l'allocation échoue.
+ */
+cmp_stream_s *cmp_stream_new(const mode_e mode, const algo_e algo,
+                             const cmp_write_f write, void *p_opaque);
+
+/**
+ * Transmet des données au flux, qui appelle sa fonction de sortie pour chaque
+ * bloc terminé.
+ * \param stream Flux.
+ * \param p_src Données entrantes.
+ * \param size Taille des données entrantes en byte.
+ * \return 0 sur un succès, -1 sur une erreur (voir cmp_stream_error). Le flux
+ * n'est plus utilisable après une erreur.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_COMPRESSION_FAILED ou ERR_DECOMPRESSION_FAILED si une erreur
+ * survient lors du traitement d'un bloc.
+ * \error ERR_HEADER si l'en-tête des données compressées est invalide.
+ * \error ERR_IO_FWRITE si la fonction de sortie échoue.
+ */
+int cmp_stream_write(cmp_stream_s * stream, const void *p_src,
+                     const size_t size);
+
+/**
+ * Termine le flux : traite le dernier bloc et vérifie que les données
+ * compressées sont complètes.
+ * \param stream Flux.
+ * \return 0 sur un succès, -1 sur une erreur (voir cmp_stream_error).
+ * \error Voir cmp_stream_write.
+ * \error ERR_IO_SIZE si les données compressées sont tronquées ou si la taille
+ * originale n'est pas retrouvée.
+ * \error ERR_CHECKSUM si la somme de contrôle des données décompressées est
+ * incorrecte ou absente.
+ */
+int cmp_stream_end(cmp_stream_s * stream);
+
+/**
+ * Renvoie le code de la dernière erreur survenue sur un flux.
+ * \param stream Flux.
+ * \return Code d'erreur, ERR_NONE si aucune erreur n'est survenue.
+ */
+err_code_e cmp_stream_error(const cmp_stream_s * stream);
+
+/**
+ * Libère un flux.
+ * \param stream Flux à libérer (peut être NULL).
+ */
+void cmp_stream_free(cmp_stream_s * stream);
+
+#endif
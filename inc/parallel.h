@@ -0,0 +1,197 @@
+/**
+ * \file parallel.h
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Parallélisme.
+ * \details Module de compression et de décompression parallèle. Le fichier
+ * entrant est découpé en blocs indépendants de taille fixe, traités par un
+ * groupe de threads puis écrits dans l'ordre sur le fichier sortant.
+ */
+
+/* Format du fichier compressé : l'en-tête (voir header.h) avec le flag
+ * HDR_FLAG_PARALLEL, puis une suite de blocs indépendants, chacun
+ * précédé d'un en-tête de PAR_HEADER_SIZE bytes en little endian :
+ * - Taille des données originales du bloc (32 bits).
+ * - Taille des données compressées du bloc (32 bits).
+ * - Identifiant de l'algorithme utilisé pour le bloc (8 bits, "algo_e").
+ * - Avec le flag HDR_FLAG_CHECKSUM, somme de contrôle CRC32C des données
+ *   originales du bloc (32 bits, voir crc32c.h).
+ * Chaque bloc pouvant être décompressé seul, la décompression est elle aussi
+ * parallèle.
+ * Avec le flag HDR_FLAG_SEEK ou HDR_FLAG_CHECKSUM, les blocs sont suivis d'un
+ * en-tête de bloc nul (tailles et algorithme à 0), dont la somme de contrôle
+ * est celle de toutes les données originales : son absence signale un
+ * fichier tronqué. Avec HDR_FLAG_SEEK, il est suivi d'une table d'accès avec
+ * une entrée de PAR_SEEK_ENTRY_SIZE bytes par bloc, dans l'ordre :
+ * - Position des données originales du bloc (64 bits).
+ * - Position de l'en-tête du bloc dans le fichier compressé (64 bits).
+ * Le fichier se termine par PAR_SEEK_TRAILER_SIZE bytes : position de la
+ * table (64 bits), nombre de blocs (32 bits), nombre magique PAR_SEEK_MAGIC
+ * (4 bytes). Un intervalle des données originales est alors décompressé en
+ * ne lisant que les blocs qui le couvrent, trouvés par dichotomie dans la
+ * table. */
+
+#ifndef __PARALLEL_H
+#define __PARALLEL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "init.h"
+#include "header.h"
+#include "codec.h"
+#include "common.h"
+
+/* Macro-constantes publiques =============================================== */
+
+/** Taille des données originales d'un bloc indépendant en byte. */
+#define PAR_CHUNK_SIZE (1 << 20)
+/** Taille de l'en-tête d'un bloc indépendant sans la somme de contrôle en
+ * byte. */
+#define PAR_HEADER_SIZE 9
+/** Taille maximale de l'en-tête d'un bloc (avec la somme de contrôle) en
+ * byte. */
+#define PAR_HEADER_SIZE_MAX (PAR_HEADER_SIZE + 4)
+/** Nombre maximal de threads. */
+#define PAR_THREADS_MAX 256
+/** Nombre magique à la fin des fichiers avec une table d'accès. */
+#define PAR_SEEK_MAGIC "CMPS"
+/** Taille d'une entrée de la table d'accès en byte. */
+#define PAR_SEEK_ENTRY_SIZE 16
+/** Taille de la fin d'un fichier avec une table d'accès en byte. */
+#define PAR_SEEK_TRAILER_SIZE 16
+
+/* Fonctions publiques ====================================================== */
+
+/**
+ * Renvoie le nombre de threads utilisé par défaut : le nombre de processeurs
+ * disponibles, entre 1 et PAR_THREADS_MAX.
+ * \return Nombre de threads par défaut.
+ */
+int par_default_threads(void);
+
+/**
+ * Renvoie la taille de l'en-tête d'un bloc d'un fichier compressé.
+ * \param flags Flags de l'en-tête du fichier (HDR_FLAG_*).
+ * \return PAR_HEADER_SIZE_MAX avec le flag HDR_FLAG_CHECKSUM, sinon
+ * PAR_HEADER_SIZE.
+ */
+size_t par_header_size(const byte_t flags);
+
+/**
+ * Encode l'en-tête d'un bloc indépendant.
+ * \param p_dest Zone mémoire d'au moins par_header_size("flags") bytes.
+ * \param raw_size Taille des données originales du bloc.
+ * \param cmp_size Taille des données compressées du bloc.
+ * \param algo Algorithme utilisé pour le bloc.
+ * \param flags Flags de l'en-tête du fichier.
+ * \param checksum Somme de contrôle des données originales du bloc (ignorée
+ * sans le flag HDR_FLAG_CHECKSUM).
+ * \return Taille de l'en-tête encodé en byte.
+ */
+size_t par_chunk_encode(byte_t * p_dest, const uint32_t raw_size,
+                        const uint32_t cmp_size, const algo_e algo,
+                        const byte_t flags, const uint32_t checksum);
+
+/**
+ * Décode l'en-tête d'un bloc indépendant.
+ * \param p_src Zone mémoire de par_header_size("flags") bytes.
+ * \param p_raw_size Taille des données originales du bloc.
+ * \param p_cmp_size Taille des données compressées du bloc.
+ * \param p_algo Algorithme utilisé pour le bloc.
+ * \param flags Flags de l'en-tête du fichier.
+ * \param p_checksum Somme de contrôle des données originales du bloc (0 sans
+ * le flag HDR_FLAG_CHECKSUM).
+ */
+void par_chunk_decode(const byte_t * p_src, uint32_t * p_raw_size,
+                      uint32_t * p_cmp_size, algo_e * p_algo,
+                      const byte_t flags, uint32_t * p_checksum);
+
+/**
+ * Indique si un en-tête de bloc est l'en-tête nul qui termine les blocs d'un
+ * fichier avec une table d'accès ou des sommes de contrôle.
+ * \param p_src Zone mémoire de PAR_HEADER_SIZE bytes (la somme de contrôle
+ * éventuelle n'est pas lue).
+ * \return Vrai si l'en-tête est nul.
+ */
+int par_chunk_end(const byte_t * p_src);
+
+/**
+ * Compresse le fichier entrant par blocs indépendants répartis sur un groupe
+ * de threads, et écrit l'en-tête, les blocs dans l'ordre puis la table
+ * d'accès sur le fichier sortant. La somme de contrôle de chaque bloc est
+ * calculée par le thread qui le compresse. Les deux fichiers sont fermés par
+ * la fonction.
+ * \param fp_in Fichier entrant (fichier régulier ou tube).
+ * \param fp_out Fichier sortant.
+ * \param ctx Contexte donnant l'algorithme et le niveau de chaque bloc, qui
+ * reçoit les statistiques du traitement.
+ * \param nb_threads Nombre de threads de compression (>= 1).
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_COMPRESSION_FAILED si une erreur survient lors de la compression.
+ * \error ERR_NOT_TEXT si un bloc n'est pas du texte alors que l'algorithme
+ * n'a pas CODEC_CAP_BINARY.
+ */
+int par_compress(FILE * fp_in, FILE * fp_out, codec_ctx_s * ctx,
+                 const int nb_threads);
+
+/**
+ * Décompresse un fichier produit par par_compress en répartissant les blocs
+ * sur un groupe de threads, et écrit les blocs dans l'ordre sur le fichier
+ * sortant. L'algorithme est lu dans l'en-tête de chaque bloc. Si "ctx" le
+ * demande, la somme de contrôle de chaque bloc est vérifiée par le thread qui
+ * le décompresse, puis celle de toutes les données originales. Les deux
+ * fichiers sont fermés par la fonction.
+ * \param fp_in Fichier entrant, positionné après l'en-tête du fichier.
+ * \param fp_out Fichier sortant.
+ * \param hdr En-tête du fichier, avec le flag HDR_FLAG_PARALLEL.
+ * \param ctx Contexte de décompression, qui reçoit les statistiques du
+ * traitement.
+ * \param nb_threads Nombre de threads de décompression (>= 1).
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si un bloc est corrompu.
+ * \error ERR_IO_SIZE si la taille originale de l'en-tête n'est pas retrouvée.
+ * \error ERR_CHECKSUM si une somme de contrôle est incorrecte ou si le
+ * fichier est tronqué.
+ */
+int par_decompress(FILE * fp_in, FILE * fp_out, const header_s * hdr,
+                   codec_ctx_s * ctx, const int nb_threads);
+
+/**
+ * Décompresse un intervalle des données originales d'un fichier découpé en
+ * blocs, en ne décompressant que les blocs qui le couvrent, et l'écrit sur le
+ * fichier sortant. Avec une table d'accès, le premier bloc est trouvé par
+ * dichotomie dans la table, sinon en parcourant les en-têtes des blocs qui
+ * précèdent (sans lire leurs données si le fichier entrant est régulier). Un
+ * intervalle qui dépasse la fin des données est tronqué. Si "ctx" le
+ * demande, la somme de contrôle des blocs décompressés est vérifiée. Les deux
+ * fichiers sont fermés par la fonction.
+ * \param fp_in Fichier entrant, positionné après l'en-tête du fichier.
+ * \param fp_out Fichier sortant.
+ * \param hdr En-tête du fichier.
+ * \param ctx Contexte de décompression, qui reçoit les statistiques du
+ * traitement.
+ * \param offset Position du début de l'intervalle dans les données
+ * originales.
+ * \param len Longueur de l'intervalle en byte.
+ * \return 0 sur succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur correspondante.
+ * \error ERR_BAD_ADRESS si un pointeur est incorrect.
+ * \error ERR_RANGE si le fichier n'est pas découpé en blocs ou si
+ * l'algorithme d'un bloc ne permet pas de le décompresser seul
+ * (CODEC_CAP_SEEKABLE).
+ * \error ERR_DECOMPRESSION_FAILED si une erreur survient lors de la
+ * décompression ou si un bloc ou la table d'accès est corrompu.
+ * \error ERR_IO_FWRITE si l'intervalle ne peut pas être écrit.
+ * \error ERR_CHECKSUM si la somme de contrôle d'un bloc est incorrecte.
+ */
+int par_decompress_range(FILE * fp_in, FILE * fp_out, const header_s * hdr,
+                         codec_ctx_s * ctx, const uint64_t offset,
+                         const uint64_t len);
+
+#endif
@@ -8,9 +8,20 @@
  * processus et les fichiers.
  */
 
+/* Les formats STAT_JSON et STAT_CSV sont destinés aux scripts et aux outils de
+ * supervision : leurs champs ne changent pas avec les messages du programme.
+ * Ils donnent le temps réel (horloge monotone) et le temps CPU du programme,
+ * la taille des données lues et produites par l'algorithme (sans les
+ * en-têtes) et les débits correspondants en MB/s, le taux de compression
+ * (taille originale / taille compressée), la mémoire maximale utilisée, et le
+ * temps passé à lire, dans l'algorithme et à écrire. */
+
 #ifndef __STATS_H
 #define __STATS_H
 
+#include "init.h"
+#include "codec.h"
+
 /* Fonctions publiques ====================================================== */
 
 /**
@@ -21,12 +32,14 @@ void stat_init();
 
 /**
  * Affiche les statistiques sur le programme et les fichiers traités sur la
- * sortie standard. La fonction stat_init doit être appellée avant stat_print.
- * \param filepath_in Chemin vers le fichier entrant.
- * \param filepath_out Chemin vers le fichier sortant.
- * \return 0 sur un succès, ou -1 sur une erreur.
+ * sortie standard, ou sur la sortie d'erreur si le fichier sortant est la
+ * sortie standard (IO_STD_PATH), dans le format demandé. La fonction stat_init
+ * doit être appellée avant stat_print.
+ * \param pi Informations sur le programme (format, chemins des fichiers).
+ * \param ctx Contexte du traitement effectué, avec ses statistiques.
+ * \return ERR_NONE sur un succès, ou le code de l'erreur survenue.
  * \error ERR_STAT si une erreur est survenu.
  */
-int stat_print(const char *s_filepath_in, const char *s_filepath_out);
+err_code_e stat_print(const prog_info_s * pi, const codec_ctx_s * ctx);
 
 #endif
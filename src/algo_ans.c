@@ -0,0 +1,492 @@
+/**
+ * \file algo_ans.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief rANS.
+ * \details Module du codage entropique d'ordre 0 par rANS (range Asymmetric
+ * Numeral Systems), à quatre états entrelacés.
+ */
+
+/* Fonctionnement détaillé de l'algorithme : le fichier entrant est découpé en
+ * blocs de ANS_BLOCK_SIZE bytes. Les occurrences des octets d'un bloc sont
+ * ramenées à des fréquences dont la somme vaut 2^ANS_SCALE_BITS (chaque octet
+ * présent garde une fréquence d'au moins 1). Un état x de 31 bits code un
+ * octet de fréquence f et de fréquence cumulée c en devenant
+ * (x / f) * 2^ANS_SCALE_BITS + c + (x % f) ; la division est remplacée par une
+ * multiplication par l'inverse précalculé de f. Avant de coder un octet, les
+ * 16 bits de poids faible de l'état sont écrits s'il dépasserait 31 bits, ce
+ * qui le maintient dans [ANS_L, 2^31[. Le décodage dépile les octets dans
+ * l'ordre inverse du codage : le bloc est donc codé de sa fin vers son début.
+ * Les octets d'indice i sont codés par l'état i % ANS_NB_STATES : les quatre
+ * états sont indépendants, ce qui permet au processeur de les traiter en même
+ * temps.
+ * Format : une suite de blocs, chacun composé de sa taille originale sur 32
+ * bits en little endian, de la taille de ses données sur 32 bits, puis des
+ * données : la table des fréquences, les états finaux sur 32 bits et les mots
+ * de 16 bits écrits lors du codage, en little endian. Une taille originale
+ * nulle termine le flux. La table des fréquences est une carte de 256 bits
+ * des octets présents, suivie de la fréquence moins 1 de chaque octet présent
+ * sauf le dernier (déduite de la somme), sur 1 byte si elle est inférieure à
+ * 128, sinon sur 2 (7 bits de poids faible et bit de poids fort à 1, puis 7
+ * bits de poids fort). */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "algo_ans.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Nombre de symboles (valeurs d'un octet). */
+#define ANS_NB_SYMBOLS (1 << CHAR_BIT)
+/* Précision des fréquences en bits, et leur somme. 14 bits : table de
+ * décodage de 16 kB qui tient dans le cache L1. */
+#define ANS_SCALE_BITS 14
+#define ANS_SCALE (1u << ANS_SCALE_BITS)
+/* Borne basse des états : un état est dans [ANS_L, 2^31[. */
+#define ANS_L (1u << 15)
+/* Nombre de bits écrits ou lus à chaque renormalisation d'un état. */
+#define ANS_IO_BITS 16
+/* Nombre d'états entrelacés. */
+#define ANS_NB_STATES 4
+/* Taille originale maximale d'un bloc en byte, qui tient dans le cache L2 avec
+ * ses données compressées. */
+#define ANS_BLOCK_SIZE (1 << 18)
+/* Taille de l'en-tête d'un bloc (taille originale et taille des données). */
+#define ANS_BLOCK_HEADER 8
+/* Taille maximale de la table des fréquences : carte des octets présents et
+ * fréquences de tous sauf un sur 2 bytes. */
+#define ANS_TABLE_MAX (ANS_NB_SYMBOLS / CHAR_BIT + 2 * (ANS_NB_SYMBOLS - 1))
+/* Taille maximale des états finaux et des mots d'un bloc : au plus un mot par
+ * octet codé. */
+#define ANS_CODE_MAX (4 * ANS_NB_STATES + 2 * ANS_BLOCK_SIZE)
+/* Taille maximale des données d'un bloc. */
+#define ANS_DATA_MAX (ANS_TABLE_MAX + ANS_CODE_MAX)
+
+/* Structures privées ======================================================= */
+
+/* Paramètres du codage d'un octet, avec l'inverse de sa fréquence (méthode
+ * d'Alverson, exacte pour un état de moins de 31 bits). */
+typedef struct ans_enc_sym {
+    uint32_t x_max;             /* Borne (exclue) de l'état avant codage. */
+    uint32_t rcp_freq;          /* Inverse de la fréquence en virgule fixe. */
+    uint32_t bias;              /* Terme ajouté à l'état. */
+    uint16_t cmpl_freq;         /* Complément de la fréquence à la somme. */
+    uint16_t rcp_shift;         /* Décalage de l'inverse de la fréquence. */
+} ans_enc_sym_s;
+
+/* Fonctions privées ======================================================== */
+
+/* # Tables des fréquences ================================================== */
+
+/* Renvoie l'entier sur 32 bits en little endian à l'adresse "p". */
+static inline uint32_t ans_load_le32(const byte_t * p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/* Renvoie l'entier sur 64 bits en little endian à l'adresse "p", lu en une
+ * fois sur un processeur little endian. */
+static inline uint64_t ans_load_le64(const byte_t * p)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t val;
+    memcpy(&val, p, sizeof(val));
+#else
+    uint64_t val = 0;
+    for (int i = 7; i >= 0; i--)
+        val = (val << CHAR_BIT) | p[i];
+#endif
+    return val;
+}
+
+/* Écrit "val" sur 16 bits en little endian à l'adresse "p", en une fois sur
+ * un processeur little endian. */
+static inline void ans_store_le16(byte_t * p, const uint16_t val)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(p, &val, sizeof(val));
+#else
+    p[0] = val & 0xFF, p[1] = val >> CHAR_BIT;
+#endif
+}
+
+/* Écrit "val" sur 32 bits en little endian à l'adresse "p". */
+static inline void ans_store_le32(byte_t * p, const uint32_t val)
+{
+    for (int i = 0; i < 4; i++)
+        p[i] = (val >> (i * CHAR_BIT)) & 0xFF;
+}
+
+/* Ramène dans "a_freq" les occurrences "a_count" de "total" octets (non nul) à
+ * des fréquences de somme ANS_SCALE, d'au moins 1 pour chaque octet présent.
+ * L'écart d'arrondi est reporté sur les octets les plus fréquents. */
+static void ans_normalize(const uint32_t * a_count, const size_t total,
+                          uint16_t * a_freq)
+{
+    assert(total);
+    uint32_t sum = 0;
+    int max = 0;
+    for (int i = 0; i < ANS_NB_SYMBOLS; i++) {
+        a_freq[i] = 0;
+        if (a_count[i]) {
+            const uint64_t freq = (uint64_t) a_count[i] * ANS_SCALE / total;
+            a_freq[i] = freq ? freq : 1;
+            sum += a_freq[i];
+        }
+        max = a_freq[i] > a_freq[max] ? i : max;
+    }
+    if (sum < ANS_SCALE) {
+        a_freq[max] += ANS_SCALE - sum;
+        return;
+    }
+    /* Trop de fréquences relevées à 1 : la plus grande est diminuée à chaque
+     * tour. Tant que la somme dépasse ANS_SCALE, elle vaut plus de
+     * ANS_SCALE / ANS_NB_SYMBOLS. */
+    for (; sum > ANS_SCALE; sum--) {
+        for (int i = 0; i < ANS_NB_SYMBOLS; i++)
+            max = a_freq[i] > a_freq[max] ? i : max;
+        a_freq[max]--;
+    }
+}
+
+/* Écrit la table des fréquences "a_freq" à l'adresse "p_dest" (au moins
+ * ANS_TABLE_MAX bytes). Renvoie sa taille en byte. */
+static size_t ans_write_table(const uint16_t * a_freq, byte_t * p_dest)
+{
+    byte_t *p = p_dest + ANS_NB_SYMBOLS / CHAR_BIT;
+    int last = 0;
+    memset(p_dest, 0, ANS_NB_SYMBOLS / CHAR_BIT);
+    for (int i = 0; i < ANS_NB_SYMBOLS; i++) {
+        if (a_freq[i]) {
+            p_dest[i / CHAR_BIT] |= 1 << (i % CHAR_BIT);
+            last = i;
+        }
+    }
+    for (int i = 0; i < last; i++) {
+        if (!a_freq[i])
+            continue;
+        const uint32_t val = a_freq[i] - 1;
+        if (val < 0x80)
+            *p++ = val;
+        else
+            *p++ = (val & 0x7F) | 0x80, *p++ = val >> 7;
+    }
+    return p - p_dest;
+}
+
+/* Lit dans "a_freq" la table des fréquences au début des "size" bytes de
+ * "p_src". Renvoie sa taille en byte, 0 si elle est invalide. */
+static size_t ans_read_table(const byte_t * p_src, const size_t size,
+                             uint16_t * a_freq)
+{
+    const byte_t *p = p_src + ANS_NB_SYMBOLS / CHAR_BIT;
+    const byte_t *p_end = p_src + size;
+    uint32_t sum = 0;
+    int last = -1;
+    if (size < ANS_NB_SYMBOLS / CHAR_BIT)
+        return 0;
+    for (int i = 0; i < ANS_NB_SYMBOLS; i++) {
+        a_freq[i] = 0;
+        if (p_src[i / CHAR_BIT] & (1 << (i % CHAR_BIT)))
+            last = i;
+    }
+    if (last < 0)
+        return 0;
+    for (int i = 0; i < last; i++) {
+        if (!(p_src[i / CHAR_BIT] & (1 << (i % CHAR_BIT))))
+            continue;
+        if (p == p_end)
+            return 0;
+        uint32_t val = *p++;
+        if (val & 0x80) {
+            if (p == p_end)
+                return 0;
+            val = (val & 0x7F) | (uint32_t) * p++ << 7;
+        }
+        sum += val + 1;
+        if (sum >= ANS_SCALE)
+            return 0;
+        a_freq[i] = val + 1;
+    }
+    a_freq[last] = ANS_SCALE - sum;
+    return p - p_src;
+}
+
+/* # Codage ================================================================= */
+
+/* Calcule dans "a_enc" les paramètres de codage des octets de fréquences
+ * "a_freq". */
+static void ans_build_enc(const uint16_t * a_freq, ans_enc_sym_s * a_enc)
+{
+    uint32_t cum = 0;
+    for (int i = 0; i < ANS_NB_SYMBOLS; i++) {
+        const uint32_t freq = a_freq[i];
+        ans_enc_sym_s *e = a_enc + i;
+        if (!freq)
+            continue;
+        e->x_max = ((ANS_L >> ANS_SCALE_BITS) << ANS_IO_BITS) * freq;
+        e->cmpl_freq = ANS_SCALE - freq;
+        if (freq < 2) {
+            /* x * (2^32 - 1) >> 32 vaut x - 1 : l'état devient
+             * x * ANS_SCALE + cum. */
+            e->rcp_freq = UINT32_MAX;
+            e->rcp_shift = 0;
+            e->bias = cum + ANS_SCALE - 1;
+        } else {
+            uint32_t shift = 0;
+            while (freq > (1u << shift))
+                shift++;
+            e->rcp_freq = ((1ull << (shift + 31)) + freq - 1) / freq;
+            e->rcp_shift = shift - 1;
+            e->bias = cum;
+        }
+        e->rcp_shift += 32;
+        cum += freq;
+    }
+}
+
+/* Code l'octet de paramètres "e" sur l'état "*p_x", et écrit les mots de
+ * renormalisation avant "*pp" (qui recule). */
+static inline void ans_encode(uint32_t * p_x, byte_t ** pp,
+                              const ans_enc_sym_s * e)
+{
+    /* Sans branchement (renormalisation imprévisible) : le mot est toujours
+     * écrit avant "*pp", qui ne recule que s'il est gardé. */
+    uint32_t x = *p_x;
+    const int renorm = x >= e->x_max;
+    ans_store_le16(*pp - 2, x & 0xFFFF);
+    *pp -= 2 * renorm;
+    x >>= ANS_IO_BITS * renorm;
+    const uint32_t q = ((uint64_t) x * e->rcp_freq) >> e->rcp_shift;
+    *p_x = x + e->bias + q * e->cmpl_freq;
+}
+
+/* Code les "size" bytes (non nul) de "p_src" dans la zone de ANS_DATA_MAX
+ * bytes "p_dest" : la table des fréquences est au début, dont la taille est
+ * renvoyée dans "*p_table_size", et les états et les mots à la fin, dont
+ * l'adresse est renvoyée. */
+static byte_t *ans_encode_block(const byte_t * p_src, const size_t size,
+                                byte_t * p_dest, size_t * p_table_size)
+{
+    assert(size && size <= ANS_BLOCK_SIZE);
+    /* Histogramme sur quatre tables, pour que les octets répétés ne se
+     * succèdent pas sur le même compteur. */
+    uint32_t a_counts[4][ANS_NB_SYMBOLS] = { {0} };
+    uint16_t a_freq[ANS_NB_SYMBOLS];
+    ans_enc_sym_s a_enc[ANS_NB_SYMBOLS];
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        a_counts[0][p_src[i]]++, a_counts[1][p_src[i + 1]]++;
+        a_counts[2][p_src[i + 2]]++, a_counts[3][p_src[i + 3]]++;
+    }
+    for (; i < size; i++)
+        a_counts[0][p_src[i]]++;
+    for (int s = 0; s < ANS_NB_SYMBOLS; s++)
+        a_counts[0][s] += a_counts[1][s] + a_counts[2][s] + a_counts[3][s];
+    ans_normalize(a_counts[0], size, a_freq);
+    *p_table_size = ans_write_table(a_freq, p_dest);
+    ans_build_enc(a_freq, a_enc);
+
+    /* Codage de la fin vers le début : d'abord les octets qui dépassent un
+     * multiple de ANS_NB_STATES, puis par groupes. */
+    uint32_t a_x[ANS_NB_STATES] = { ANS_L, ANS_L, ANS_L, ANS_L };
+    byte_t *p = p_dest + ANS_DATA_MAX;
+    for (i = size; i % ANS_NB_STATES;) {
+        i--;
+        ans_encode(a_x + i % ANS_NB_STATES, &p, a_enc + p_src[i]);
+    }
+    while (i) {
+        i -= ANS_NB_STATES;
+        ans_encode(a_x + 3, &p, a_enc + p_src[i + 3]);
+        ans_encode(a_x + 2, &p, a_enc + p_src[i + 2]);
+        ans_encode(a_x + 1, &p, a_enc + p_src[i + 1]);
+        ans_encode(a_x + 0, &p, a_enc + p_src[i]);
+    }
+    p -= 4 * ANS_NB_STATES;
+    for (int k = 0; k < ANS_NB_STATES; k++)
+        ans_store_le32(p + 4 * k, a_x[k]);
+    return p;
+}
+
+/* # Décodage =============================================================== */
+
+/* Décode les "size" octets d'un bloc (non nul) dans "p_dest", à partir des
+ * "data_size" bytes de données "p_src". Renvoie 0 sur un succès, -1 si les
+ * données sont invalides. */
+static int ans_decode_block(const byte_t * p_src, const size_t data_size,
+                            byte_t * p_dest, const size_t size)
+{
+    uint16_t a_freq[ANS_NB_SYMBOLS], a_cum[ANS_NB_SYMBOLS];
+    byte_t a_sym[ANS_SCALE];
+    uint32_t a_x[ANS_NB_STATES], cum = 0;
+    const size_t table_size = ans_read_table(p_src, data_size, a_freq);
+    if (!table_size || data_size - table_size < 4 * ANS_NB_STATES)
+        return -1;
+    /* Chaque octet occupe les "freq" entrées qui suivent sa fréquence
+     * cumulée. */
+    for (int s = 0; s < ANS_NB_SYMBOLS; s++) {
+        a_cum[s] = cum;
+        memset(a_sym + cum, s, a_freq[s]);
+        cum += a_freq[s];
+    }
+    const byte_t *p = p_src + table_size, *p_end = p_src + data_size;
+    for (int k = 0; k < ANS_NB_STATES; k++, p += 4) {
+        a_x[k] = ans_load_le32(p);
+        if (a_x[k] < ANS_L || a_x[k] >> 31)
+            return -1;
+    }
+
+/* Décode l'octet d'indice "i" avec l'état "k". */
+#define ANS_DECODE(k, i) do {                                           \
+        const uint32_t slot = a_x[k] & (ANS_SCALE - 1);                 \
+        const byte_t sym = a_sym[slot];                                 \
+        p_dest[i] = sym;                                                \
+        a_x[k] = a_freq[sym] * (a_x[k] >> ANS_SCALE_BITS) + slot        \
+            - a_cum[sym];                                               \
+    } while (0)
+/* Recharge l'état "k" s'il est passé sous ANS_L avec le prochain mot de
+ * "words", sans branchement (renormalisation imprévisible). */
+#define ANS_RENORM(k) do {                                              \
+        const uint32_t renorm = a_x[k] < ANS_L;                         \
+        a_x[k] = a_x[k] << (ANS_IO_BITS * renorm)                       \
+            | ((uint32_t) words & 0xFFFF & (0u - renorm));              \
+        words >>= ANS_IO_BITS * renorm;                                 \
+        nb_words += renorm;                                             \
+    } while (0)
+
+    /* Un groupe lit au plus un mot par état : les quatre mots possibles sont
+     * chargés en une fois, pour que les états n'attendent pas chacun la
+     * lecture du précédent. */
+    size_t i = 0;
+    for (; i + ANS_NB_STATES <= size && p_end - p >= 2 * ANS_NB_STATES;
+         i += ANS_NB_STATES) {
+        uint64_t words = ans_load_le64(p);
+        int nb_words = 0;
+        ANS_DECODE(0, i);
+        ANS_DECODE(1, i + 1);
+        ANS_DECODE(2, i + 2);
+        ANS_DECODE(3, i + 3);
+        ANS_RENORM(0);
+        ANS_RENORM(1);
+        ANS_RENORM(2);
+        ANS_RENORM(3);
+        p += 2 * nb_words;
+    }
+    for (; i < size; i++) {
+        const int k = i % ANS_NB_STATES;
+        ANS_DECODE(k, i);
+        if (a_x[k] < ANS_L) {
+            if (p_end - p < 2)
+                return -1;
+            a_x[k] = a_x[k] << ANS_IO_BITS | p[0] | p[1] << 8;
+            p += 2;
+        }
+    }
+#undef ANS_DECODE
+#undef ANS_RENORM
+
+    /* Les états reviennent à leur valeur initiale après avoir consommé
+     * toutes les données. */
+    if (p != p_end)
+        return -1;
+    for (int k = 0; k < ANS_NB_STATES; k++)
+        if (a_x[k] != ANS_L)
+            return -1;
+    return 0;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int ans_compress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_header[ANS_BLOCK_HEADER];
+    size_t nb_bytes, table_size;
+    byte_t *p_in = malloc(ANS_BLOCK_SIZE);
+    byte_t *p_out = malloc(ANS_DATA_MAX);
+    if (!p_in || !p_out) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    while ((nb_bytes = cmpf_get_bytes(cf, p_in, ANS_BLOCK_SIZE))) {
+        const byte_t *p_code = ans_encode_block(p_in, nb_bytes, p_out,
+                                                &table_size);
+        const size_t code_size = p_out + ANS_DATA_MAX - p_code;
+        ans_store_le32(a_header, nb_bytes);
+        ans_store_le32(a_header + 4, table_size + code_size);
+        if (cmpf_put_bytes(cf, a_header, ANS_BLOCK_HEADER)
+            || cmpf_put_bytes(cf, p_out, table_size)
+            || cmpf_put_bytes(cf, p_code, code_size))
+            goto error;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    /* Fin du flux : bloc de taille nulle. */
+    ans_store_le32(a_header, 0);
+    if (cmpf_put_bytes(cf, a_header, 4))
+        goto error;
+    free(p_in), free(p_out);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_in), free(p_out);
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int ans_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_header[ANS_BLOCK_HEADER];
+    byte_t *p_in = malloc(ANS_DATA_MAX);
+    byte_t *p_out = malloc(ANS_BLOCK_SIZE);
+    if (!p_in || !p_out) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    /* Un fichier tronqué ou un bloc invalide donne ERR_DECOMPRESSION_FAILED
+     * (voir cmpf_fail), une erreur de lecture est conservée. */
+    while (TRUE) {
+        if (cmpf_get_bytes(cf, a_header, 4) != 4)
+            goto error;
+        const uint32_t size = ans_load_le32(a_header);
+        if (!size)
+            break;
+        if (cmpf_get_bytes(cf, a_header + 4, 4) != 4)
+            goto error;
+        const uint32_t data_size = ans_load_le32(a_header + 4);
+        if (size > ANS_BLOCK_SIZE || data_size > ANS_DATA_MAX)
+            goto error;
+        if (cmpf_get_bytes(cf, p_in, data_size) != data_size)
+            goto error;
+        if (ans_decode_block(p_in, data_size, p_out, size))
+            goto error;
+        if (cmpf_put_bytes(cf, p_out, size))
+            goto error;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    free(p_in), free(p_out);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_in), free(p_out);
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+}
@@ -0,0 +1,513 @@
+/**
+ * \file algo_bwt.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief BWT.
+ * \details Module de la chaîne de compression par blocs triés : transformée
+ * de Burrows-Wheeler, move-to-front, RLE binaire puis codage rANS.
+ */
+
+/* Fonctionnement détaillé de l'algorithme : le fichier entrant est découpé en
+ * blocs de BWT_BLOCK_SIZE bytes. Le tableau des suffixes du bloc, terminé par
+ * une sentinelle plus petite que tout octet, est construit par SA-IS
+ * (induced sorting) : les suffixes sont classés S (plus petit que le suivant)
+ * ou L, les sous-chaînes qui commencent aux suffixes S les plus à gauche (LMS)
+ * sont triées par induction depuis les seaux de leur premier octet, puis
+ * nommées ; si deux noms sont égaux, le texte réduit des noms (au plus la
+ * moitié du bloc) est trié récursivement. L'ordre des LMS permet enfin
+ * d'induire celui de tout les suffixes. La transformée est l'octet qui précède
+ * chaque suffixe dans cet ordre ; la ligne du suffixe entier (index primaire)
+ * remplace la sentinelle. Le move-to-front, puis les algorithmes RLE binaire
+ * et rANS sont ensuite appliqués en mémoire.
+ * À la décompression, la transformée est inversée en suivant le chaînage de
+ * chaque ligne vers celle du suffixe suivant. Ce parcours est une suite
+ * d'accès aléatoires dépendants : le bloc est coupé en BWT_NB_CHAINS chaînes
+ * de même longueur, suivies ensemble depuis la ligne de leur premier suffixe.
+ * Format : une suite de blocs, chacun composé de sa taille originale sur 32
+ * bits en little endian, de la taille de ses données sur 32 bits, de la ligne
+ * du premier suffixe de chaque chaîne sur 32 bits (l'index primaire en
+ * premier) puis des données (flux rANS du flux RLE binaire). Une taille
+ * originale nulle termine le flux. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "algo_rle.h"
+#include "algo_ans.h"
+#include "algo_bwt.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Taille originale maximale d'un bloc en byte, celle d'un bloc du mode
+ * parallèle : le bloc et son tableau des suffixes tiennent dans le cache
+ * L3. */
+#define BWT_BLOCK_SIZE (1 << 20)
+/* Nombre de chaînes suivies ensemble par l'inversion de la transformée. */
+#define BWT_NB_CHAINS 4
+/* Taille de l'en-tête d'un bloc (taille originale, taille des données et
+ * ligne du premier suffixe de chaque chaîne). */
+#define BWT_BLOCK_HEADER (8 + 4 * BWT_NB_CHAINS)
+/* Taille maximale acceptée des données d'un bloc (fichier corrompu). */
+#define BWT_DATA_MAX (3 * BWT_BLOCK_SIZE)
+/* Nombre de symboles (valeurs d'un octet). */
+#define BWT_NB_SYMBOLS (1 << CHAR_BIT)
+/* Nombre de rangs cherchés un à un par le move-to-front, avant memchr. */
+#define BWT_MTF_SCAN 8
+/* Nombre de bits de l'index d'une ligne dans le chaînage de l'inversion. */
+#define BWT_ROW_BITS 24
+
+/* Structures privées ======================================================= */
+
+/* Texte dont SA-IS trie les suffixes, terminé par une sentinelle unique de
+ * valeur 0. */
+typedef struct bwt_text {
+    const byte_t *p_bytes;      /* Octets du bloc (premier niveau), chacun
+                                   augmenté de 1, la sentinelle étant
+                                   implicite. */
+    const int32_t *p_names;     /* Noms du texte réduit (niveaux suivants),
+                                   sentinelle comprise, ou NULL. */
+    int32_t n;                  /* Longueur, sentinelle comprise. */
+} bwt_text_s;
+
+/* Fonctions privées ======================================================== */
+
+/* # Tableau des suffixes =================================================== */
+
+/* Renvoie le caractère d'indice "i" du texte "t". */
+static inline int32_t bwt_chr(const bwt_text_s * t, const int32_t i)
+{
+    if (t->p_names)
+        return t->p_names[i];
+    return i == t->n - 1 ? 0 : t->p_bytes[i] + 1;
+}
+
+/* Renvoie vrai si le suffixe "i" est LMS d'après les types "a_type" (1 pour
+ * S). */
+static inline int bwt_is_lms(const byte_t * a_type, const int32_t i)
+{
+    return i > 0 && a_type[i] && !a_type[i - 1];
+}
+
+/* Calcule dans "a_bkt" le début (ou la fin si "end" est vrai) du seau de
+ * chaque caractère, à partir de leurs nombres "a_count" (k + 1 caractères). */
+static void bwt_buckets(const int32_t * a_count, int32_t * a_bkt,
+                        const int32_t k, const int end)
+{
+    int32_t sum = 0;
+    for (int32_t c = 0; c <= k; c++) {
+        sum += a_count[c];
+        a_bkt[c] = end ? sum : sum - a_count[c];
+    }
+}
+
+/* Induit dans "p_sa" l'ordre des suffixes L (de gauche à droite), puis celui
+ * des suffixes S (de droite à gauche), à partir des suffixes déjà placés. */
+static void bwt_induce(const bwt_text_s * t, const byte_t * a_type,
+                       int32_t * p_sa, const int32_t * a_count,
+                       int32_t * a_bkt, const int32_t k)
+{
+    bwt_buckets(a_count, a_bkt, k, FALSE);
+    for (int32_t i = 0; i < t->n; i++) {
+        const int32_t j = p_sa[i] - 1;
+        if (j >= 0 && !a_type[j])
+            p_sa[a_bkt[bwt_chr(t, j)]++] = j;
+    }
+    bwt_buckets(a_count, a_bkt, k, TRUE);
+    for (int32_t i = t->n - 1; i >= 0; i--) {
+        const int32_t j = p_sa[i] - 1;
+        if (j >= 0 && a_type[j])
+            p_sa[--a_bkt[bwt_chr(t, j)]] = j;
+    }
+}
+
+/* Trie dans "p_sa" les suffixes du texte "t" (au moins 2 caractères, de 0 à
+ * "k"). Renvoie 0 sur un succès, -1 si une allocation échoue. */
+static int bwt_sais(const bwt_text_s * t, int32_t * p_sa, const int32_t k)
+{
+    const int32_t n = t->n;
+    assert(n >= 2);
+    byte_t *a_type = malloc(n);
+    int32_t *a_count = calloc(k + 1, sizeof(int32_t));
+    int32_t *a_bkt = malloc((k + 1) * sizeof(int32_t));
+    if (!a_type || !a_count || !a_bkt)
+        goto error;
+
+    /* Types des suffixes : la sentinelle est S, le suffixe qui la précède
+     * est L. */
+    a_type[n - 1] = TRUE;
+    a_type[n - 2] = FALSE;
+    for (int32_t i = n - 3; i >= 0; i--) {
+        const int32_t c = bwt_chr(t, i), c_next = bwt_chr(t, i + 1);
+        a_type[i] = c < c_next || (c == c_next && a_type[i + 1]);
+    }
+    for (int32_t i = 0; i < n; i++)
+        a_count[bwt_chr(t, i)]++;
+
+    /* Tri des sous-chaînes LMS : placées à la fin de leur seau, puis
+     * induites. */
+    bwt_buckets(a_count, a_bkt, k, TRUE);
+    for (int32_t i = 0; i < n; i++)
+        p_sa[i] = -1;
+    for (int32_t i = 1; i < n; i++)
+        if (bwt_is_lms(a_type, i))
+            p_sa[--a_bkt[bwt_chr(t, i)]] = i;
+    bwt_induce(t, a_type, p_sa, a_count, a_bkt, k);
+
+    /* Les LMS triés sont regroupés au début, puis nommés : deux sous-chaînes
+     * égales (mêmes caractères et mêmes types jusqu'au LMS suivant) ont le
+     * même nom. Le nom de la position "pos" est rangé à n1 + pos / 2 (deux LMS
+     * sont distants d'au moins 2). */
+    int32_t n1 = 0, name = 0, prev = -1;
+    for (int32_t i = 0; i < n; i++)
+        if (bwt_is_lms(a_type, p_sa[i]))
+            p_sa[n1++] = p_sa[i];
+    for (int32_t i = n1; i < n; i++)
+        p_sa[i] = -1;
+    for (int32_t i = 0; i < n1; i++) {
+        const int32_t pos = p_sa[i];
+        int diff = prev < 0;
+        /* La sentinelle, unique, arrête la comparaison. */
+        for (int32_t d = 0; !diff; d++) {
+            if (bwt_chr(t, pos + d) != bwt_chr(t, prev + d)
+                || a_type[pos + d] != a_type[prev + d])
+                diff = TRUE;
+            else if (d > 0 && (bwt_is_lms(a_type, pos + d)
+                               || bwt_is_lms(a_type, prev + d)))
+                break;
+        }
+        if (diff)
+            name++, prev = pos;
+        p_sa[n1 + pos / 2] = name - 1;
+    }
+    for (int32_t i = n - 1, j = n - 1; i >= n1; i--)
+        if (p_sa[i] >= 0)
+            p_sa[j--] = p_sa[i];
+
+    /* Ordre des LMS : tri récursif du texte réduit si des noms sont égaux,
+     * rangé au début de "p_sa", le texte réduit étant à la fin. */
+    int32_t *p_names = p_sa + n - n1;
+    if (name < n1) {
+        const bwt_text_s t1 = {.p_names = p_names,.n = n1 };
+        if (bwt_sais(&t1, p_sa, name - 1))
+            goto error;
+    } else {
+        for (int32_t i = 0; i < n1; i++)
+            p_sa[p_names[i]] = i;
+    }
+
+    /* Les LMS triés sont placés à la fin de leur seau, puis tout les suffixes
+     * sont induits. */
+    for (int32_t i = 1, j = 0; i < n; i++)
+        if (bwt_is_lms(a_type, i))
+            p_names[j++] = i;
+    for (int32_t i = 0; i < n1; i++)
+        p_sa[i] = p_names[p_sa[i]];
+    for (int32_t i = n1; i < n; i++)
+        p_sa[i] = -1;
+    bwt_buckets(a_count, a_bkt, k, TRUE);
+    for (int32_t i = n1 - 1; i >= 0; i--) {
+        const int32_t j = p_sa[i];
+        p_sa[i] = -1;
+        p_sa[--a_bkt[bwt_chr(t, j)]] = j;
+    }
+    bwt_induce(t, a_type, p_sa, a_count, a_bkt, k);
+    free(a_type), free(a_count), free(a_bkt);
+    return 0;
+
+ error:
+    free(a_type), free(a_count), free(a_bkt);
+    return -1;
+}
+
+/* # Transformées =========================================================== */
+
+/* Renvoie la longueur de la chaîne "c" parmi les BWT_NB_CHAINS chaînes d'un
+ * bloc de "size" bytes, qui couvrent chacune au plus "len" positions. */
+static inline size_t bwt_chain_len(const size_t size, const size_t len,
+                                   const int c)
+{
+    if (c * len >= size)
+        return 0;
+    return size - c * len < len ? size - c * len : len;
+}
+
+/* Écrit dans "p_dest" la transformée des "size" bytes (non nul) de "p_src",
+ * avec "p_sa" de size + 1 entiers, et dans "a_rows" la ligne du premier
+ * suffixe de chaque chaîne (celle du suffixe entier, l'index primaire, en
+ * premier). Renvoie 0 sur un succès, -1 si une allocation échoue. */
+static int bwt_forward(const byte_t * p_src, const size_t size,
+                       int32_t * p_sa, byte_t * p_dest,
+                       uint32_t a_rows[BWT_NB_CHAINS])
+{
+    assert(size && size <= BWT_BLOCK_SIZE);
+    const bwt_text_s t = {.p_bytes = p_src,.n = size + 1 };
+    const size_t len = (size + BWT_NB_CHAINS - 1) / BWT_NB_CHAINS;
+    if (bwt_sais(&t, p_sa, BWT_NB_SYMBOLS))
+        return -1;
+    memset(a_rows, 0, BWT_NB_CHAINS * sizeof(uint32_t));
+    /* La première ligne est celle de la sentinelle seule (suffixe "size"),
+     * jamais primaire. */
+    for (size_t i = 0, j = 0; i <= size; i++) {
+        const size_t pos = p_sa[i];
+        if (pos < size && pos % len == 0)
+            a_rows[pos / len] = i;
+        if (pos)
+            p_dest[j++] = p_src[pos - 1];
+    }
+    return 0;
+}
+
+/* Écrit dans "p_dest" les "size" bytes (non nul) dont "p_src" est la
+ * transformée, d'après la ligne du premier suffixe de chaque chaîne
+ * "a_rows", avec "p_next" de size + 1 entiers. Renvoie 0 sur un succès, -1 si
+ * une ligne est invalide. */
+static int bwt_inverse(const byte_t * p_src, const size_t size,
+                       const uint32_t a_rows[BWT_NB_CHAINS],
+                       uint32_t * p_next, byte_t * p_dest)
+{
+    assert(size && size < (1u << BWT_ROW_BITS));
+    const size_t len = (size + BWT_NB_CHAINS - 1) / BWT_NB_CHAINS;
+    const uint32_t primary = a_rows[0];
+    uint32_t a_pos[BWT_NB_SYMBOLS] = { 0 }, a_row[BWT_NB_CHAINS], sum = 1;
+    for (int c = 0; c < BWT_NB_CHAINS; c++) {
+        a_row[c] = a_rows[c];
+        if (bwt_chain_len(size, len, c) && (!a_row[c] || a_row[c] > size))
+            return -1;
+    }
+    for (size_t i = 0; i < size; i++)
+        a_pos[p_src[i]]++;
+    for (int c = 0; c < BWT_NB_SYMBOLS; c++) {
+        const uint32_t count = a_pos[c];
+        a_pos[c] = sum;
+        sum += count;
+    }
+    /* Chaque ligne (dans l'ordre de son premier octet) reçoit la ligne du
+     * suffixe suivant, et son premier octet sur les bits de poids fort. */
+    p_next[0] = primary;
+    for (uint32_t i = 0; i <= size; i++) {
+        if (i == primary)
+            continue;
+        const byte_t c = p_src[i - (i > primary)];
+        p_next[a_pos[c]++] = i | (uint32_t) c << BWT_ROW_BITS;
+    }
+    /* Les chaînes sont suivies ensemble, leurs accès à "p_next", sans
+     * dépendance entre eux, se recouvrent ; la dernière, la plus courte,
+     * fixe la partie commune. */
+    const size_t common = bwt_chain_len(size, len, BWT_NB_CHAINS - 1);
+    for (size_t k = 0; k < common; k++) {
+        for (int c = 0; c < BWT_NB_CHAINS; c++) {
+            const uint32_t entry = p_next[a_row[c]];
+            p_dest[c * len + k] = entry >> BWT_ROW_BITS;
+            a_row[c] = entry & ((1u << BWT_ROW_BITS) - 1);
+        }
+    }
+    for (int c = 0; c < BWT_NB_CHAINS; c++) {
+        for (size_t k = common; k < bwt_chain_len(size, len, c); k++) {
+            const uint32_t entry = p_next[a_row[c]];
+            p_dest[c * len + k] = entry >> BWT_ROW_BITS;
+            a_row[c] = entry & ((1u << BWT_ROW_BITS) - 1);
+        }
+    }
+    return 0;
+}
+
+/* Remplace chacun des "size" bytes de "p" par son rang dans la liste des
+ * octets, puis le place en tête de la liste. */
+static void bwt_mtf_encode(byte_t * p, const size_t size)
+{
+    byte_t a_order[BWT_NB_SYMBOLS];
+    for (int c = 0; c < BWT_NB_SYMBOLS; c++)
+        a_order[c] = c;
+    for (size_t i = 0; i < size; i++) {
+        const byte_t c = p[i];
+        int rank = 0;
+        /* Après la transformée, les rangs sont presque tous petits. */
+        while (rank < BWT_MTF_SCAN && a_order[rank] != c)
+            rank++;
+        if (rank == BWT_MTF_SCAN)
+            rank = (byte_t *) memchr(a_order + rank, c,
+                                     BWT_NB_SYMBOLS - rank) - a_order;
+        memmove(a_order + 1, a_order, rank);
+        a_order[0] = c;
+        p[i] = rank;
+    }
+}
+
+/* Inverse de bwt_mtf_encode sur les "size" bytes de "p". */
+static void bwt_mtf_decode(byte_t * p, const size_t size)
+{
+    byte_t a_order[BWT_NB_SYMBOLS];
+    for (int c = 0; c < BWT_NB_SYMBOLS; c++)
+        a_order[c] = c;
+    for (size_t i = 0; i < size; i++) {
+        const byte_t rank = p[i], c = a_order[rank];
+        memmove(a_order + 1, a_order, rank);
+        a_order[0] = c;
+        p[i] = c;
+    }
+}
+
+/* # Étapes ================================================================= */
+
+/* Lance l'algorithme "run" sur les "in_size" bytes de "p_in", dans une zone
+ * mémoire allouée dont l'adresse et la taille sont renvoyées dans "*pp_out" et
+ * "*p_out_size". Renvoie 0 sur un succès, ou -1 sur une erreur et positionne
+ * l'erreur de "cf" sur l'erreur produite par l'étape. */
+static int bwt_stage(cmp_file_s * cf, int (*run)(cmp_file_s *),
+                     const byte_t * p_in, const size_t in_size,
+                     byte_t ** pp_out, size_t * p_out_size)
+{
+    cmp_file_s *cf_mem = cmpf_open_mem(p_in, in_size);
+    *pp_out = NULL;
+    if (!cf_mem)
+        return cmpf_set_err(cf, ERR_OTHER), -1;
+    err_code_e err = run(cf_mem) ? cmpf_get_err(cf_mem) : ERR_NONE;
+    const err_code_e err_close = cmpf_close_mem(cf_mem, pp_out, p_out_size);
+    if (!err)
+        err = err_close;
+    if (err) {
+        free(*pp_out), *pp_out = NULL;
+        return cmpf_set_err(cf, err), -1;
+    }
+    return 0;
+}
+
+/* Renvoie l'entier sur 32 bits en little endian à l'adresse "p". */
+static inline uint32_t bwt_load_le32(const byte_t * p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/* Écrit "val" sur 32 bits en little endian à l'adresse "p". */
+static inline void bwt_store_le32(byte_t * p, const uint32_t val)
+{
+    for (int i = 0; i < 4; i++)
+        p[i] = (val >> (i * CHAR_BIT)) & 0xFF;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int bwt_compress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_header[BWT_BLOCK_HEADER], *p_rle = NULL, *p_ans = NULL;
+    uint32_t a_rows[BWT_NB_CHAINS];
+    size_t nb_bytes, rle_size, ans_size;
+    byte_t *p_in = malloc(BWT_BLOCK_SIZE), *p_bwt = malloc(BWT_BLOCK_SIZE);
+    int32_t *p_sa = malloc((BWT_BLOCK_SIZE + 1) * sizeof(int32_t));
+    if (!p_in || !p_bwt || !p_sa) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    /* Les étapes en mémoire positionnent elles-mêmes l'erreur de "cf". */
+    while ((nb_bytes = cmpf_get_bytes(cf, p_in, BWT_BLOCK_SIZE))) {
+        if (bwt_forward(p_in, nb_bytes, p_sa, p_bwt, a_rows)) {
+            cmpf_set_err(cf, ERR_OTHER);
+            goto error;
+        }
+        bwt_mtf_encode(p_bwt, nb_bytes);
+        if (bwt_stage(cf, rle_bin_compress, p_bwt, nb_bytes, &p_rle,
+                      &rle_size)
+            || bwt_stage(cf, ans_compress, p_rle, rle_size, &p_ans,
+                         &ans_size))
+            goto error;
+        bwt_store_le32(a_header, nb_bytes);
+        bwt_store_le32(a_header + 4, ans_size);
+        for (int c = 0; c < BWT_NB_CHAINS; c++)
+            bwt_store_le32(a_header + 8 + 4 * c, a_rows[c]);
+        if (cmpf_put_bytes(cf, a_header, BWT_BLOCK_HEADER)
+            || cmpf_put_bytes(cf, p_ans, ans_size))
+            goto error;
+        free(p_rle), free(p_ans);
+        p_rle = p_ans = NULL;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    /* Fin du flux : bloc de taille nulle. */
+    bwt_store_le32(a_header, 0);
+    if (cmpf_put_bytes(cf, a_header, 4))
+        goto error;
+    free(p_in), free(p_bwt), free(p_sa);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_in), free(p_bwt), free(p_sa), free(p_rle), free(p_ans);
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int bwt_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_header[BWT_BLOCK_HEADER], *p_in = NULL, *p_rle = NULL;
+    byte_t *p_mtf = NULL;
+    uint32_t a_rows[BWT_NB_CHAINS];
+    size_t rle_size, mtf_size;
+    byte_t *p_out = malloc(BWT_BLOCK_SIZE);
+    uint32_t *p_next = malloc((BWT_BLOCK_SIZE + 1) * sizeof(uint32_t));
+    if (!p_out || !p_next) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    /* Un fichier tronqué ou un bloc invalide donne ERR_DECOMPRESSION_FAILED
+     * (voir cmpf_fail), une erreur de lecture est conservée, et les étapes
+     * en mémoire positionnent elles-mêmes l'erreur de "cf". */
+    while (TRUE) {
+        if (cmpf_get_bytes(cf, a_header, 4) != 4)
+            goto error;
+        const uint32_t size = bwt_load_le32(a_header);
+        if (!size)
+            break;
+        if (cmpf_get_bytes(cf, a_header + 4, BWT_BLOCK_HEADER - 4)
+            != BWT_BLOCK_HEADER - 4)
+            goto error;
+        const uint32_t data_size = bwt_load_le32(a_header + 4);
+        for (int c = 0; c < BWT_NB_CHAINS; c++)
+            a_rows[c] = bwt_load_le32(a_header + 8 + 4 * c);
+        if (size > BWT_BLOCK_SIZE || data_size > BWT_DATA_MAX)
+            goto error;
+        if (!(p_in = malloc(data_size ? data_size : 1))) {
+            cmpf_set_err(cf, ERR_OTHER);
+            goto error;
+        }
+        if (cmpf_get_bytes(cf, p_in, data_size) != data_size
+            || bwt_stage(cf, ans_decompress, p_in, data_size, &p_rle,
+                         &rle_size)
+            || bwt_stage(cf, rle_bin_decompress, p_rle, rle_size, &p_mtf,
+                         &mtf_size))
+            goto error;
+        if (mtf_size != size)
+            goto error;
+        bwt_mtf_decode(p_mtf, size);
+        if (bwt_inverse(p_mtf, size, a_rows, p_next, p_out))
+            goto error;
+        if (cmpf_put_bytes(cf, p_out, size))
+            goto error;
+        free(p_in), free(p_rle), free(p_mtf);
+        p_in = p_rle = p_mtf = NULL;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    free(p_out), free(p_next);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_out), free(p_next), free(p_in), free(p_rle), free(p_mtf);
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+}
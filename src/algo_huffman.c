@@ -0,0 +1,381 @@
+/**
+ * \file algo_huffman.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Huffman.
+ * \details Module de l'algorithme de codage de Huffman.
+ */
+
+/* Fonctionnement détaillé de l'algorithme : un premier passage sur le fichier
+ * entrant compte les occurrences de chaque octet. L'arbre de Huffman est
+ * construit avec un tas binaire en fusionnant les deux noeuds les moins
+ * fréquents, et seule la profondeur de chaque feuille (longueur du code) est
+ * conservée. Les longueurs sont limitées à HUF_CODE_LENGHT_MAX bits en
+ * divisant les fréquences par deux tant que l'arbre est trop profond. Les
+ * codes sont ensuite attribués de manière canonique (par longueur puis par
+ * octet croissant), ce qui permet de ne transmettre que les longueurs.
+ * Format : taille originale sur 64 bits en little endian, longueur de code de
+ * chaque octet sur 4 bits (HUF_NB_SYMBOLS / 2 bytes), puis les codes écrits du
+ * bit de poids fort vers le bit de poids faible de chaque byte.
+ * À la décompression, les HUF_CODE_LENGHT_MAX prochains bits du flux indexent
+ * une table qui donne directement l'octet et la longueur de son code. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "errors.h"
+#include "io.h"
+#include "heap.h"
+#include "common.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Nombre de symboles (valeurs d'un octet). */
+#define HUF_NB_SYMBOLS (1 << CHAR_BIT)
+/* Longueur maximale d'un code, et nombre de bits d'index de la table de
+ * décodage. 12 bits : table de 8 kB qui tient dans le cache L1. */
+#define HUF_CODE_LENGHT_MAX 12
+/* Taille de l'en-tête : taille originale et longueurs des codes. */
+#define HUF_HEADER_SIZE (8 + HUF_NB_SYMBOLS / 2)
+/* Taille des buffers de lecture et d'écriture. */
+#define HUF_BUFFER_SIZE (1 << 16)
+/* Nombre de bits de l'index d'un noeud dans la clé du tas (départage les
+ * fréquences égales de façon déterministe). */
+#define HUF_NODE_BITS 10
+
+/* Structures privées ======================================================= */
+
+/* Lecteur de bits du flux compressé. */
+typedef struct huf_reader {
+    cmp_file_s *cf;             /* Fichier entrant. */
+    byte_t *p_buf;              /* Buffer de lecture. */
+    const byte_t *p;            /* Prochain byte à lire. */
+    const byte_t *p_end;        /* Fin des bytes lus dans "p_buf". */
+    uint64_t bits;              /* Bits en attente, alignés sur le bit de
+                                   poids fort. */
+    int nb_bits;                /* Nombre de bits en attente. */
+    size_t over;                /* Bytes nuls ajoutés après la fin du flux. */
+} huf_reader_s;
+
+/* Fonctions privées ======================================================== */
+
+/* # Construction des codes ================================================= */
+
+/* Calcule dans "a_len" la longueur du code de chaque octet à partir de leur
+ * nombre d'occurrences "a_freq", limitée à HUF_CODE_LENGHT_MAX bits.
+ * Renvoie 0 sur un succès, -1 si l'allocation du tas échoue. */
+static int huf_build_lengths(const uint64_t * a_freq, byte_t * a_len)
+{
+    uint64_t a_weight[HUF_NB_SYMBOLS];
+    int a_parent[2 * HUF_NB_SYMBOLS - 1], a_depth[2 * HUF_NB_SYMBOLS - 1];
+    heap_s *h = heap_new(HUF_NB_SYMBOLS);
+    if (!h)
+        return -1;
+    memcpy(a_weight, a_freq, sizeof(a_weight));
+    while (TRUE) {
+        int max_len = 0, nb_nodes = HUF_NB_SYMBOLS;
+        heap_node_s n1, n2;
+        memset(a_len, 0, HUF_NB_SYMBOLS);
+        for (int i = 0; i < HUF_NB_SYMBOLS; i++) {
+            if (a_weight[i])
+                heap_push(h, a_weight[i] << HUF_NODE_BITS | i, i);
+        }
+        /* Un seul octet présent : code sur 1 bit. */
+        if (heap_size(h) == 1) {
+            heap_pop(h, &n1);
+            a_len[n1.value] = 1;
+            break;
+        }
+        /* Fusion des deux noeuds les moins fréquents jusqu'à la racine. */
+        while (heap_size(h) > 1) {
+            heap_pop(h, &n1), heap_pop(h, &n2);
+            a_parent[n1.value] = a_parent[n2.value] = nb_nodes;
+            heap_push(h, ((n1.key >> HUF_NODE_BITS) + (n2.key >> HUF_NODE_BITS))
+                      << HUF_NODE_BITS | nb_nodes, nb_nodes);
+            nb_nodes++;
+        }
+        if (!heap_size(h))
+            break;              /* Fichier vide. */
+        heap_pop(h, &n1);
+        /* Profondeur des noeuds internes (créés après leurs fils), puis des
+         * feuilles. */
+        a_depth[nb_nodes - 1] = 0;
+        for (int i = nb_nodes - 2; i >= HUF_NB_SYMBOLS; i--)
+            a_depth[i] = a_depth[a_parent[i]] + 1;
+        for (int i = 0; i < HUF_NB_SYMBOLS; i++) {
+            if (a_weight[i]) {
+                a_len[i] = a_depth[a_parent[i]] + 1;
+                max_len = a_len[i] > max_len ? a_len[i] : max_len;
+            }
+        }
+        if (max_len <= HUF_CODE_LENGHT_MAX)
+            break;
+        /* Arbre trop profond : on aplatit les fréquences. */
+        for (int i = 0; i < HUF_NB_SYMBOLS; i++)
+            a_weight[i] = a_weight[i] ? (a_weight[i] >> 1) | 1 : 0;
+    }
+    heap_free(h);
+    return 0;
+}
+
+/* Attribue dans "a_code" les codes canoniques correspondant aux longueurs
+ * "a_len" : les codes d'une même longueur se suivent par octet croissant.
+ * Renvoie 0 sur un succès, -1 si les longueurs ne forment pas un code
+ * préfixe valide. */
+static int huf_build_codes(const byte_t * a_len, uint16_t * a_code)
+{
+    int a_count[HUF_CODE_LENGHT_MAX + 1] = { 0 };
+    uint32_t a_next[HUF_CODE_LENGHT_MAX + 1], code = 0;
+    for (int i = 0; i < HUF_NB_SYMBOLS; i++) {
+        if (a_len[i] > HUF_CODE_LENGHT_MAX)
+            return -1;
+        a_count[a_len[i]]++;
+    }
+    a_count[0] = 0;
+    for (int len = 1; len <= HUF_CODE_LENGHT_MAX; len++) {
+        code = (code + a_count[len - 1]) << 1;
+        a_next[len] = code;
+        /* Plus de codes que de valeurs possibles sur cette longueur. */
+        if (code + a_count[len] > (1u << len))
+            return -1;
+    }
+    for (int i = 0; i < HUF_NB_SYMBOLS; i++)
+        a_code[i] = a_len[i] ? a_next[a_len[i]]++ : 0;
+    return 0;
+}
+
+/* Ferme la zone mémoire "cf_src" ouverte sur les données conservées si
+ * "spool" est vrai. */
+static void huf_close_spool(cmp_file_s * cf_src, const int spool)
+{
+    byte_t *p_unused;
+    size_t unused_size;
+    if (spool && cf_src)
+        cmpf_close_mem(cf_src, &p_unused, &unused_size);
+}
+
+/* # Lecture du flux ======================================================== */
+
+/* Renvoie les 8 bytes à l'adresse "p" lus en big endian. */
+static inline uint64_t huf_load_be64(const byte_t * p)
+{
+    uint64_t val = 0;
+    for (int i = 0; i < 8; i++)
+        val = (val << CHAR_BIT) | p[i];
+    return val;
+}
+
+/* Complète les bits en attente de "r" pour en avoir au moins 56. Après la fin
+ * du flux, des bytes nuls sont ajoutés et comptés dans "over". */
+static inline void huf_refill(huf_reader_s * r)
+{
+    assert(r && r->nb_bits >= 0 && r->nb_bits < 64);
+    if (r->p_end - r->p < 8) {
+        /* Rechargement du buffer en gardant les bytes non lus. */
+        size_t left = r->p_end - r->p;
+        memmove(r->p_buf, r->p, left);
+        left += cmpf_get_bytes(r->cf, r->p_buf + left, HUF_BUFFER_SIZE - left);
+        r->p = r->p_buf;
+        r->p_end = r->p_buf + left;
+        /* Fin du flux : complétion byte par byte. */
+        if (left < 8) {
+            for (; r->nb_bits <= 56; r->nb_bits += CHAR_BIT) {
+                const byte_t byte = r->p < r->p_end ? *r->p++ : (r->over++, 0);
+                r->bits |= (uint64_t) byte << (56 - r->nb_bits);
+            }
+            return;
+        }
+    }
+    /* Les bits chargés au delà des bytes consommés sont ceux du flux, ils
+     * seront rechargés à l'identique. */
+    r->bits |= huf_load_be64(r->p) >> r->nb_bits;
+    r->p += (63 - r->nb_bits) >> 3;
+    r->nb_bits |= 56;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int huffman_compress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    uint64_t a_freq[HUF_NB_SYMBOLS] = { 0 }, size = 0, size_check = 0;
+    byte_t a_len[HUF_NB_SYMBOLS], a_header[HUF_HEADER_SIZE];
+    uint16_t a_code[HUF_NB_SYMBOLS];
+    size_t nb_bytes, spool_cap = 0;
+    /* Fichier de taille inconnue (tube) : il ne peut pas être relu, il est
+     * conservé en mémoire au premier passage. */
+    const int spool = cmpf_get_size(cf, &size) != 0;
+    cmp_file_s *cf_src = spool ? NULL : cf;
+    /* Le buffer d'écriture peut contenir un buffer de lecture entièrement codé
+     * sur HUF_CODE_LENGHT_MAX bits par octet. */
+    byte_t *p_in = malloc(HUF_BUFFER_SIZE), *p_spool = NULL;
+    byte_t *p_out = malloc(HUF_BUFFER_SIZE * 2);
+    if (!p_in || !p_out) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    /* Premier passage : histogramme des octets. */
+    size = 0;
+    while (TRUE) {
+        byte_t *p_chunk = p_in;
+        if (spool) {
+            if (spool_cap - size < HUF_BUFFER_SIZE) {
+                spool_cap = spool_cap ? spool_cap << 1 : HUF_BUFFER_SIZE;
+                byte_t *p_tmp = realloc(p_spool, spool_cap);
+                if (!p_tmp) {
+                    cmpf_set_err(cf, ERR_OTHER);
+                    goto error;
+                }
+                p_spool = p_tmp;
+            }
+            p_chunk = p_spool + size;
+        }
+        if (!(nb_bytes = cmpf_get_bytes(cf, p_chunk, HUF_BUFFER_SIZE)))
+            break;
+        for (size_t i = 0; i < nb_bytes; i++)
+            a_freq[p_chunk[i]]++;
+        size += nb_bytes;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD || huf_build_lengths(a_freq, a_len)
+        || huf_build_codes(a_len, a_code))
+        goto error;
+
+    /* En-tête : taille originale et longueurs des codes. */
+    for (int i = 0; i < 8; i++)
+        a_header[i] = (size >> (i * CHAR_BIT)) & 0xFF;
+    for (int i = 0; i < HUF_NB_SYMBOLS / 2; i++)
+        a_header[8 + i] = a_len[2 * i] | a_len[2 * i + 1] << 4;
+    if (cmpf_put_bytes(cf, a_header, HUF_HEADER_SIZE))
+        goto error;
+
+    /* Second passage : codage. Les bits sont accumulés à droite de "bits" et
+     * écrits par groupes de 32. */
+    uint64_t bits = 0;
+    int nb_bits = 0;
+    if (!spool)
+        cmpf_rewind(cf);
+    else if (!(cf_src = cmpf_open_mem(p_spool, size))) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+    cmpf_set_err(cf, ERR_NONE);
+    while ((nb_bytes = cmpf_get_bytes(cf_src, p_in, HUF_BUFFER_SIZE))) {
+        byte_t *p = p_out;
+        for (size_t i = 0; i < nb_bytes; i++) {
+            bits = (bits << a_len[p_in[i]]) | a_code[p_in[i]];
+            nb_bits += a_len[p_in[i]];
+            if (nb_bits >= 32) {
+                nb_bits -= 32;
+                const uint32_t word = bits >> nb_bits;
+                p[0] = word >> 24, p[1] = word >> 16, p[2] = word >> 8;
+                p[3] = word;
+                p += 4;
+            }
+        }
+        size_check += nb_bytes;
+        if (cmpf_put_bytes(cf, p_out, p - p_out))
+            goto error;
+    }
+    /* Le fichier doit être identique aux deux passages. */
+    if (cmpf_get_err(cf) == ERR_IO_FREAD || size_check != size)
+        goto error;
+    /* Derniers bits, complétés par des 0 jusqu'au byte. */
+    for (nb_bytes = 0; nb_bits > 0; nb_bits -= CHAR_BIT) {
+        p_out[nb_bytes++] = nb_bits >= CHAR_BIT ? bits >> (nb_bits - CHAR_BIT)
+            : bits << (CHAR_BIT - nb_bits);
+    }
+    if (cmpf_put_bytes(cf, p_out, nb_bytes))
+        goto error;
+    huf_close_spool(cf_src, spool);
+    free(p_in), free(p_out), free(p_spool);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    huf_close_spool(cf_src, spool);
+    free(p_in), free(p_out), free(p_spool);
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int huffman_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_len[HUF_NB_SYMBOLS], a_header[HUF_HEADER_SIZE];
+    uint16_t a_code[HUF_NB_SYMBOLS];
+    /* Table de décodage : octet sur les bits de poids faible, longueur du code
+     * sur les bits de poids fort (0 si aucun code ne correspond). */
+    uint16_t a_table[1 << HUF_CODE_LENGHT_MAX] = { 0 };
+    uint64_t size = 0;
+    huf_reader_s r = {.cf = cf };
+    byte_t *p_out = malloc(HUF_BUFFER_SIZE);
+    if (!p_out || !(r.p_buf = malloc(HUF_BUFFER_SIZE))) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+    r.p = r.p_end = r.p_buf;
+
+    /* En-tête : taille originale et longueurs des codes. */
+    if (cmpf_get_bytes(cf, a_header, HUF_HEADER_SIZE) != HUF_HEADER_SIZE)
+        goto error;
+    for (int i = 7; i >= 0; i--)
+        size = (size << CHAR_BIT) | a_header[i];
+    for (int i = 0; i < HUF_NB_SYMBOLS / 2; i++) {
+        a_len[2 * i] = a_header[8 + i] & 0xF;
+        a_len[2 * i + 1] = a_header[8 + i] >> 4;
+    }
+    if (huf_build_codes(a_len, a_code))
+        goto error;
+    /* Chaque code de longueur "len" occupe les 2^(MAX - len) entrées dont il
+     * est le préfixe. */
+    for (int i = 0; i < HUF_NB_SYMBOLS; i++) {
+        if (!a_len[i])
+            continue;
+        const int shift = HUF_CODE_LENGHT_MAX - a_len[i];
+        for (int j = a_code[i] << shift; j < (a_code[i] + 1) << shift; j++)
+            a_table[j] = i | a_len[i] << CHAR_BIT;
+    }
+
+    /* Décodage par paquets de 4 codes (au plus 48 bits) par rechargement. */
+    while (size) {
+        const size_t nb_bytes = size < HUF_BUFFER_SIZE ? size : HUF_BUFFER_SIZE;
+        size_t i = 0;
+        while (i < nb_bytes) {
+            huf_refill(&r);
+            for (int k = 0; k < 4 && i < nb_bytes; k++, i++) {
+                const uint16_t entry =
+                    a_table[r.bits >> (64 - HUF_CODE_LENGHT_MAX)];
+                const int len = entry >> CHAR_BIT;
+                if (!len)
+                    goto error;
+                p_out[i] = entry & 0xFF;
+                r.bits <<= len;
+                r.nb_bits -= len;
+            }
+        }
+        /* Les bits consommés ne doivent pas dépasser la fin du flux. */
+        if ((size_t)r.nb_bits < r.over * CHAR_BIT
+            || cmpf_put_bytes(cf, p_out, nb_bytes))
+            goto error;
+        size -= nb_bytes;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    free(r.p_buf), free(p_out);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(r.p_buf), free(p_out);
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+}
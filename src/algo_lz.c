@@ -0,0 +1,469 @@
+/**
+ * \file algo_lz.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief LZ.
+ * \details Module de l'algorithme LZ (famille LZ77), à fenêtre glissante et
+ * recherche des correspondances par chaînes de hachage.
+ */
+
+/* Fonctionnement détaillé de l'algorithme : le fichier entrant est lu dans un
+ * buffer qui conserve les LZ_WINDOW_SIZE derniers bytes déjà compressés (la
+ * fenêtre). Chaque position est insérée dans une table de hachage indexée par
+ * ses LZ_MIN_MATCH premiers octets, et chaînée à la position précédente de même
+ * hachage : la recherche d'une correspondance parcourt cette chaîne, sur une
+ * profondeur qui dépend du niveau de compression.
+ * Format : une suite de séquences, chacune composée d'un byte de jeton (nombre
+ * d'octets littéraux sur les 4 bits de poids fort, longueur de la
+ * correspondance moins LZ_MIN_MATCH sur les 4 bits de poids faible), des
+ * octets supplémentaires de la longueur des littéraux si elle vaut au moins
+ * 15, des littéraux, de la distance sur 16 bits en little endian, puis des
+ * octets supplémentaires de la longueur de la correspondance. Une longueur
+ * supplémentaire est une suite de bytes ajoutés tant qu'ils valent 255. Une
+ * distance nulle indique une séquence sans correspondance. Le flux se termine
+ * à la fin d'une séquence. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "algo_lz.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Longueur minimale d'une correspondance. */
+#define LZ_MIN_MATCH 4
+/* Longueur maximale d'une correspondance. */
+#define LZ_MATCH_MAX (1 << 16)
+/* Taille de la fenêtre, et distance maximale d'une correspondance. */
+#define LZ_WINDOW_SIZE (1 << 16)
+#define LZ_WINDOW_MASK (LZ_WINDOW_SIZE - 1)
+#define LZ_DIST_MAX (LZ_WINDOW_SIZE - 1)
+/* Taille des données lues ou décompressées à la suite de la fenêtre. */
+#define LZ_BUFFER_SIZE (1 << 20)
+#define LZ_BUFFER_CAP (LZ_WINDOW_SIZE + LZ_BUFFER_SIZE)
+/* Nombre de bytes qui doivent suivre la position courante avant de chercher
+ * une correspondance (sauf en fin de fichier). */
+#define LZ_LOOKAHEAD (LZ_MATCH_MAX + 1)
+/* Nombre de bits des hachages. */
+#define LZ_HASH_BITS 16
+/* Taille des buffers du flux compressé. */
+#define LZ_STREAM_SIZE (1 << 16)
+/* Valeur de la partie d'une longueur dans le jeton à partir de laquelle des
+ * bytes supplémentaires suivent. */
+#define LZ_TOKEN_LEN_MAX 15
+/* Longueur maximale acceptée à la décompression (fichier corrompu). */
+#define LZ_LEN_LIMIT (SIZE_MAX >> 1)
+/* Décalage de l'accélération sur les données sans correspondance : le pas
+ * augmente de 1 tous les 2^LZ_SKIP_SHIFT littéraux. */
+#define LZ_SKIP_SHIFT 6
+
+/* Structures privées ======================================================= */
+
+/* Paramètres d'un niveau de compression. */
+typedef struct lz_level {
+    int depth;                  /* Nombre maximal de positions examinées. */
+    int nice;                   /* Longueur suffisante pour arrêter la
+                                   recherche. */
+    char lazy;                  /* Flag, cherche une meilleure correspondance à
+                                   la position suivante avant d'écrire. */
+    char skip;                  /* Flag, accélère sur les données sans
+                                   correspondance. */
+} lz_level_s;
+
+/* État du compresseur. */
+typedef struct lz_encoder {
+    cmp_file_s *cf;             /* Fichiers entrant et sortant. */
+    const lz_level_s *p_lvl;    /* Paramètres du niveau de compression. */
+    byte_t *p_buf;              /* Fenêtre suivie des données à compresser. */
+    int32_t end;                /* Fin des données lues dans "p_buf". */
+    int32_t ins;                /* Prochaine position à insérer. */
+    int32_t *a_head;            /* Dernière position de chaque hachage. */
+    int32_t *a_chain;           /* Position précédente de même hachage, par
+                                   position modulo la taille de la fenêtre. */
+    byte_t *p_out;              /* Buffer du flux compressé. */
+    size_t out_len;             /* Nombre de bytes dans "p_out". */
+} lz_encoder_s;
+
+/* État du décompresseur. */
+typedef struct lz_decoder {
+    cmp_file_s *cf;             /* Fichiers entrant et sortant. */
+    byte_t *p_in;               /* Buffer du flux compressé. */
+    size_t in_pos;              /* Prochain byte à lire dans "p_in". */
+    size_t in_end;              /* Fin des bytes lus dans "p_in". */
+    byte_t *p_out;              /* Fenêtre suivie des données décompressées. */
+    size_t out_pos;             /* Fin des données décompressées. */
+    size_t out_flushed;         /* Fin des données déjà écrites. */
+} lz_decoder_s;
+
+/* Variables privées ======================================================== */
+
+/* Paramètres des niveaux de compression. */
+static const lz_level_s a_levels[LZ_LEVEL_MAX + 1] = {
+    [1] = {1, 16, FALSE, TRUE},
+    [2] = {2, 32, FALSE, FALSE},
+    [3] = {4, 32, FALSE, FALSE},
+    [4] = {8, 64, FALSE, FALSE},
+    [5] = {16, 64, TRUE, FALSE},
+    [6] = {32, 128, TRUE, FALSE},
+    [7] = {64, 256, TRUE, FALSE},
+    [8] = {256, 1024, TRUE, FALSE},
+    [9] = {4096, LZ_MATCH_MAX, TRUE, FALSE}
+};
+
+/* Fonctions privées ======================================================== */
+
+/* # Compression ============================================================ */
+
+/* Renvoie le hachage des LZ_MIN_MATCH octets à l'adresse "p". */
+static inline uint32_t lz_hash(const byte_t * p)
+{
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+    return (val * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/* Renvoie le nombre d'octets identiques au début de "p_a" et "p_b", au plus
+ * "max". */
+static inline int32_t lz_match_len(const byte_t * p_a, const byte_t * p_b,
+                                   const int32_t max)
+{
+    int32_t len = 0;
+    /* Comparaison par mots de 64 bits, puis octet par octet. */
+    for (uint64_t a, b; len + 8 <= max; len += 8) {
+        memcpy(&a, p_a + len, sizeof(a));
+        memcpy(&b, p_b + len, sizeof(b));
+        if (a != b)
+            break;
+    }
+    while (len < max && p_a[len] == p_b[len])
+        len++;
+    return len;
+}
+
+/* Insère dans les chaînes de hachage les positions jusqu'à "target" exclue. */
+static inline void lz_insert(lz_encoder_s * e, int32_t target)
+{
+    if (target > e->end - LZ_MIN_MATCH + 1)
+        target = e->end - LZ_MIN_MATCH + 1;
+    for (; e->ins < target; e->ins++) {
+        const uint32_t hash = lz_hash(e->p_buf + e->ins);
+        e->a_chain[e->ins & LZ_WINDOW_MASK] = e->a_head[hash];
+        e->a_head[hash] = e->ins;
+    }
+}
+
+/* Cherche la plus longue correspondance de la position "pos" dans la fenêtre.
+ * Renvoie sa longueur et positionne "p_dist" sur sa distance, ou renvoie 0 si
+ * aucune correspondance n'atteint LZ_MIN_MATCH. */
+static int32_t lz_find(lz_encoder_s * e, const int32_t pos, int32_t * p_dist)
+{
+    assert(pos + LZ_MIN_MATCH <= e->end);
+    const byte_t *p = e->p_buf;
+    const int32_t max_len =
+        e->end - pos < LZ_MATCH_MAX ? e->end - pos : LZ_MATCH_MAX;
+    int32_t best = LZ_MIN_MATCH - 1, cand;
+    lz_insert(e, pos);
+    cand = e->a_head[lz_hash(p + pos)];
+    /* Une position hors de la fenêtre arrête le parcours : son chaînage a pu
+     * être écrasé par une position plus récente. */
+    for (int depth = e->p_lvl->depth; cand >= 0 && pos - cand <= LZ_DIST_MAX
+         && depth; depth--, cand = e->a_chain[cand & LZ_WINDOW_MASK]) {
+        /* Rejet rapide : l'octet qui allongerait la meilleure correspondance
+         * doit être identique. */
+        if (p[cand + best] != p[pos + best])
+            continue;
+        const int32_t len = lz_match_len(p + cand, p + pos, max_len);
+        if (len > best) {
+            best = len;
+            *p_dist = pos - cand;
+            if (len >= e->p_lvl->nice || len == max_len)
+                break;
+        }
+    }
+    lz_insert(e, pos + 1);
+    return best >= LZ_MIN_MATCH ? best : 0;
+}
+
+/* Écris le buffer du flux compressé sur le fichier sortant. */
+static inline int lz_out_flush(lz_encoder_s * e)
+{
+    if (cmpf_put_bytes(e->cf, e->p_out, e->out_len))
+        return -1;
+    e->out_len = 0;
+    return 0;
+}
+
+/* Ajoute "byte" au flux compressé. */
+static inline int lz_out_byte(lz_encoder_s * e, const byte_t byte)
+{
+    if (e->out_len == LZ_STREAM_SIZE && lz_out_flush(e))
+        return -1;
+    e->p_out[e->out_len++] = byte;
+    return 0;
+}
+
+/* Ajoute "size" bytes de "p_src" au flux compressé. */
+static int lz_out_write(lz_encoder_s * e, const byte_t * p_src, size_t size)
+{
+    while (size) {
+        if (e->out_len == LZ_STREAM_SIZE && lz_out_flush(e))
+            return -1;
+        size_t nb_bytes = LZ_STREAM_SIZE - e->out_len;
+        nb_bytes = nb_bytes < size ? nb_bytes : size;
+        memcpy(e->p_out + e->out_len, p_src, nb_bytes);
+        e->out_len += nb_bytes, p_src += nb_bytes, size -= nb_bytes;
+    }
+    return 0;
+}
+
+/* Ajoute les bytes supplémentaires de la longueur "len". */
+static int lz_out_len(lz_encoder_s * e, size_t len)
+{
+    for (; len >= 255; len -= 255) {
+        if (lz_out_byte(e, 255))
+            return -1;
+    }
+    return lz_out_byte(e, len);
+}
+
+/* Ajoute au flux compressé la séquence des "nb_lit" littéraux de "p_lit"
+ * suivis de la correspondance de distance "dist" (0 si aucune) et de longueur
+ * "len". */
+static int lz_emit(lz_encoder_s * e, const byte_t * p_lit, const size_t nb_lit,
+                   const int32_t dist, const int32_t len)
+{
+    const size_t match = dist ? len - LZ_MIN_MATCH : 0;
+    const byte_t token =
+        (nb_lit < LZ_TOKEN_LEN_MAX ? nb_lit : LZ_TOKEN_LEN_MAX) << 4
+        | (match < LZ_TOKEN_LEN_MAX ? match : LZ_TOKEN_LEN_MAX);
+    if (lz_out_byte(e, token)
+        || (nb_lit >= LZ_TOKEN_LEN_MAX
+            && lz_out_len(e, nb_lit - LZ_TOKEN_LEN_MAX))
+        || lz_out_write(e, p_lit, nb_lit)
+        || lz_out_byte(e, dist & 0xFF) || lz_out_byte(e, dist >> 8)
+        || (match >= LZ_TOKEN_LEN_MAX && lz_out_len(e, match - LZ_TOKEN_LEN_MAX)))
+        return -1;
+    return 0;
+}
+
+/* Lit la suite du fichier entrant dans le buffer. S'il est plein, le fait
+ * d'abord glisser pour ne conserver que la fenêtre avant "p_pos" (les
+ * littéraux en attente avant la fenêtre sont alors écrits). Positionne
+ * "p_eof" si la fin du fichier est atteinte. */
+static int lz_fill(lz_encoder_s * e, int32_t * p_pos, int32_t * p_anchor,
+                   char *p_eof)
+{
+    if (e->end == LZ_BUFFER_CAP) {
+        const int32_t delta = *p_pos - LZ_WINDOW_SIZE;
+        assert(delta > 0);
+        if (*p_anchor < delta) {
+            if (lz_emit(e, e->p_buf + *p_anchor, *p_pos - *p_anchor, 0, 0))
+                return -1;
+            *p_anchor = *p_pos;
+        }
+        memmove(e->p_buf, e->p_buf + delta, e->end - delta);
+        e->end -= delta, *p_pos -= delta, *p_anchor -= delta;
+        e->ins = e->ins > delta ? e->ins - delta : 0;
+        for (int i = 0; i < 1 << LZ_HASH_BITS; i++)
+            e->a_head[i] = e->a_head[i] >= delta ? e->a_head[i] - delta : -1;
+        for (int i = 0; i < LZ_WINDOW_SIZE; i++)
+            e->a_chain[i] = e->a_chain[i] >= delta ? e->a_chain[i] - delta : -1;
+    }
+    const size_t nb_bytes =
+        cmpf_get_bytes(e->cf, e->p_buf + e->end, LZ_BUFFER_CAP - e->end);
+    if (!nb_bytes && cmpf_get_err(e->cf) == ERR_IO_FREAD)
+        return -1;
+    e->end += nb_bytes;
+    *p_eof = !nb_bytes;
+    return 0;
+}
+
+/* # Décompression ========================================================== */
+
+/* Recharge le buffer du flux compressé s'il contient moins de "size" bytes.
+ * Renvoie le nombre de bytes disponibles. */
+static inline size_t lz_in_fill(lz_decoder_s * d, const size_t size)
+{
+    if (d->in_end - d->in_pos < size) {
+        memmove(d->p_in, d->p_in + d->in_pos, d->in_end - d->in_pos);
+        d->in_end -= d->in_pos;
+        d->in_pos = 0;
+        d->in_end += cmpf_get_bytes(d->cf, d->p_in + d->in_end,
+                                    LZ_STREAM_SIZE - d->in_end);
+    }
+    return d->in_end - d->in_pos;
+}
+
+/* Ajoute à "p_len" ses bytes supplémentaires. */
+static int lz_in_len(lz_decoder_s * d, size_t * p_len)
+{
+    byte_t byte;
+    do {
+        if (!lz_in_fill(d, 1) || *p_len > LZ_LEN_LIMIT)
+            return -1;
+        byte = d->p_in[d->in_pos++];
+        *p_len += byte;
+    } while (byte == 255);
+    return 0;
+}
+
+/* S'assure que "size" bytes (au plus LZ_BUFFER_SIZE) peuvent être ajoutés aux
+ * données décompressées, en écrivant les données et en faisant glisser la
+ * fenêtre si besoin. */
+static int lz_out_reserve(lz_decoder_s * d, const size_t size)
+{
+    if (d->out_pos + size <= LZ_BUFFER_CAP)
+        return 0;
+    if (cmpf_put_bytes(d->cf, d->p_out + d->out_flushed,
+                       d->out_pos - d->out_flushed))
+        return -1;
+    memmove(d->p_out, d->p_out + d->out_pos - LZ_WINDOW_SIZE, LZ_WINDOW_SIZE);
+    d->out_pos = d->out_flushed = LZ_WINDOW_SIZE;
+    return 0;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int lz_compress(cmp_file_s * cf, const int level)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    const int lvl = level >= LZ_LEVEL_MIN && level <= LZ_LEVEL_MAX ? level
+        : LZ_LEVEL_DEFAULT;
+    lz_encoder_s e = {.cf = cf,.p_lvl = &a_levels[lvl] };
+    int32_t pos = 0, anchor = 0, len, dist = 0, len_next, dist_next = 0;
+    char eof = FALSE;
+    e.p_buf = malloc(LZ_BUFFER_CAP);
+    e.a_head = malloc(sizeof(int32_t) << LZ_HASH_BITS);
+    e.a_chain = malloc(sizeof(int32_t) * LZ_WINDOW_SIZE);
+    e.p_out = malloc(LZ_STREAM_SIZE);
+    if (!e.p_buf || !e.a_head || !e.a_chain || !e.p_out) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+    memset(e.a_head, 0xFF, sizeof(int32_t) << LZ_HASH_BITS);
+
+    while (TRUE) {
+        /* Rechargement tant que la correspondance la plus longue possible
+         * n'est pas entièrement lue. */
+        if (!eof && e.end - pos < LZ_LOOKAHEAD) {
+            if (lz_fill(&e, &pos, &anchor, &eof))
+                goto error;
+            continue;
+        }
+        if (pos + LZ_MIN_MATCH > e.end)
+            break;
+        if (!(len = lz_find(&e, pos, &dist))) {
+            pos += 1 + (e.p_lvl->skip ? (pos - anchor) >> LZ_SKIP_SHIFT : 0);
+            continue;
+        }
+        /* Évaluation paresseuse : la correspondance est abandonnée au profit
+         * d'un littéral si la position suivante en a une plus longue. */
+        while (e.p_lvl->lazy && len < e.p_lvl->nice
+               && pos + 1 + LZ_MIN_MATCH <= e.end
+               && (len_next = lz_find(&e, pos + 1, &dist_next)) > len) {
+            pos++;
+            len = len_next, dist = dist_next;
+        }
+        if (lz_emit(&e, e.p_buf + anchor, pos - anchor, dist, len))
+            goto error;
+        pos += len;
+        anchor = pos;
+    }
+    /* Derniers littéraux. */
+    if ((anchor < e.end && lz_emit(&e, e.p_buf + anchor, e.end - anchor, 0, 0))
+        || lz_out_flush(&e))
+        goto error;
+    free(e.p_buf), free(e.a_head), free(e.a_chain), free(e.p_out);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(e.p_buf), free(e.a_head), free(e.a_chain), free(e.p_out);
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int lz_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    lz_decoder_s d = {.cf = cf };
+    d.p_in = malloc(LZ_STREAM_SIZE);
+    /* Les correspondances sont copiées par mots de 8 bytes, qui peuvent
+     * déborder de 7 bytes. */
+    d.p_out = malloc(LZ_BUFFER_CAP + 8);
+    if (!d.p_in || !d.p_out) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    while (lz_in_fill(&d, 1)) {
+        const byte_t token = d.p_in[d.in_pos++];
+        size_t nb_lit = token >> 4, len = token & LZ_TOKEN_LEN_MAX, dist;
+
+        /* Littéraux. */
+        if (nb_lit == LZ_TOKEN_LEN_MAX && lz_in_len(&d, &nb_lit))
+            goto error;
+        while (nb_lit) {
+            size_t nb_bytes = lz_in_fill(&d, 1);
+            if (!nb_bytes)
+                goto error;
+            nb_bytes = nb_bytes < nb_lit ? nb_bytes : nb_lit;
+            if (lz_out_reserve(&d, nb_bytes))
+                goto error;
+            memcpy(d.p_out + d.out_pos, d.p_in + d.in_pos, nb_bytes);
+            d.out_pos += nb_bytes, d.in_pos += nb_bytes, nb_lit -= nb_bytes;
+        }
+
+        /* Correspondance. */
+        if (lz_in_fill(&d, 2) < 2)
+            goto error;
+        dist = d.p_in[d.in_pos] | d.p_in[d.in_pos + 1] << 8;
+        d.in_pos += 2;
+        if (!dist) {
+            if (len)
+                goto error;
+            continue;
+        }
+        if ((len == LZ_TOKEN_LEN_MAX && lz_in_len(&d, &len))
+            || dist > d.out_pos)
+            goto error;
+        len += LZ_MIN_MATCH;
+        while (len) {
+            const size_t nb_bytes = len < LZ_BUFFER_SIZE ? len : LZ_BUFFER_SIZE;
+            if (lz_out_reserve(&d, nb_bytes))
+                goto error;
+            byte_t *p_dst = d.p_out + d.out_pos;
+            const byte_t *p_src = p_dst - dist;
+            if (dist >= 8) {
+                for (size_t i = 0; i < nb_bytes; i += 8)
+                    memcpy(p_dst + i, p_src + i, 8);
+            } else {
+                for (size_t i = 0; i < nb_bytes; i++)
+                    p_dst[i] = p_src[i];
+            }
+            d.out_pos += nb_bytes, len -= nb_bytes;
+        }
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD
+        || cmpf_put_bytes(cf, d.p_out + d.out_flushed,
+                          d.out_pos - d.out_flushed))
+        goto error;
+    free(d.p_in), free(d.p_out);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(d.p_in), free(d.p_out);
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+}
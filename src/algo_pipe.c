@@ -0,0 +1,418 @@
+/**
+ * \file algo_pipe.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Chaîne de transformations.
+ * \details Module de la compression par une chaîne d'étages choisie sur la
+ * ligne de commande (--pipeline), appliqués en mémoire bloc par bloc.
+ */
+
+/* Fonctionnement détaillé de l'algorithme : le fichier entrant est découpé en
+ * blocs de PIPE_BLOCK_SIZE bytes, que les étages transforment l'un après
+ * l'autre de zone mémoire en zone mémoire. Les filtres (delta, transpose)
+ * gardent la taille des données ; les codeurs (RLE binaire, Huffman, rANS)
+ * sont les algorithmes existants, lancés sur des couples de zones mémoires
+ * (cmpf_open_mem) sans passer par un fichier. À la décompression, les étages
+ * sont inversés dans l'ordre inverse.
+ * Format : le nombre d'étages sur un byte, puis l'identifiant et le paramètre
+ * de chaque étage sur un byte chacun, puis une suite de blocs, chacun composé
+ * de sa taille originale sur 32 bits en little endian, de la taille de ses
+ * données sur 32 bits puis des données. Une taille originale nulle termine le
+ * flux. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "init.h"
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "algo_rle.h"
+#include "algo_huffman.h"
+#include "algo_ans.h"
+#include "algo_pipe.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Taille originale maximale d'un bloc en byte, celle d'un bloc du mode
+ * parallèle. */
+#define PIPE_BLOCK_SIZE (1 << 20)
+/* Taille maximale des données d'un bloc, et de chaque résultat intermédiaire,
+ * en byte : les codeurs n'agrandissent les données que de quelques pourcents,
+ * même enchaînés. */
+#define PIPE_DATA_MAX (4 * PIPE_BLOCK_SIZE)
+/* Taille de l'en-tête d'un bloc en byte (taille originale et taille des
+ * données). */
+#define PIPE_BLOCK_HEADER 8
+/* Paramètre maximal d'un étage, inscrit sur un byte. */
+#define PIPE_PARAM_MAX UINT8_MAX
+
+/* Structures privées ======================================================= */
+
+typedef struct pipe_stage_desc pipe_stage_desc_s;
+
+/* Description d'un étage : un filtre, qui garde la taille des données, ou un
+ * codeur sur un couple de fichiers. */
+struct pipe_stage_desc {
+    const char *s_name;         /* Nom dans la liste des étages. */
+    int param;                  /* Paramètre par défaut (0 : sans
+                                   paramètre). */
+    /* Transforme les "size" bytes de "p_src" dans "p_dest" (filtre). */
+    void (*encode)(const byte_t * p_src, byte_t * p_dest, const size_t size,
+                   const int param);
+    /* Inverse "encode" (filtre). */
+    void (*decode)(const byte_t * p_src, byte_t * p_dest, const size_t size,
+                   const int param);
+    int (*compress)(cmp_file_s * cf);   /* Compression (codeur). */
+    int (*decompress)(cmp_file_s * cf); /* Décompression (codeur). */
+};
+
+/* Fonctions privées ======================================================== */
+
+/* # Filtres ================================================================ */
+
+/* Remplace chaque octet par sa différence avec l'octet situé "dist" octets
+ * avant, les "dist" premiers étant recopiés. */
+static void pipe_delta_encode(const byte_t * p_src, byte_t * p_dest,
+                              const size_t size, const int dist)
+{
+    const size_t head = (size_t) dist < size ? (size_t) dist : size;
+    memcpy(p_dest, p_src, head);
+    for (size_t i = head; i < size; i++)
+        p_dest[i] = p_src[i] - p_src[i - dist];
+}
+
+static void pipe_delta_decode(const byte_t * p_src, byte_t * p_dest,
+                              const size_t size, const int dist)
+{
+    const size_t head = (size_t) dist < size ? (size_t) dist : size;
+    memcpy(p_dest, p_src, head);
+    for (size_t i = head; i < size; i++)
+        p_dest[i] = p_src[i] + p_dest[i - dist];
+}
+
+/* Range les octets de même rang des enregistrements de "stride" octets les uns
+ * à la suite des autres, rang par rang. Les octets qui ne forment pas un
+ * enregistrement complet sont recopiés à la fin. */
+static void pipe_transpose_encode(const byte_t * p_src, byte_t * p_dest,
+                                  const size_t size, const int stride)
+{
+    const size_t nb_rows = size / stride;
+    for (int j = 0; j < stride; j++) {
+        const byte_t *p = p_src + j;
+        for (size_t r = 0; r < nb_rows; r++, p += stride)
+            *p_dest++ = *p;
+    }
+    memcpy(p_dest, p_src + nb_rows * stride, size - nb_rows * stride);
+}
+
+static void pipe_transpose_decode(const byte_t * p_src, byte_t * p_dest,
+                                  const size_t size, const int stride)
+{
+    const size_t nb_rows = size / stride;
+    for (int j = 0; j < stride; j++) {
+        byte_t *p = p_dest + j;
+        for (size_t r = 0; r < nb_rows; r++, p += stride)
+            *p = *p_src++;
+    }
+    memcpy(p_dest + nb_rows * stride, p_src, size - nb_rows * stride);
+}
+
+/* # Étages ================================================================= */
+
+/* Étages, indexés par leur identifiant. */
+static const pipe_stage_desc_s PIPE_STAGES[STAGE_NB] = {
+    [STAGE_DELTA] = {"delta", 1, pipe_delta_encode, pipe_delta_decode,
+                     NULL, NULL},
+    [STAGE_TRANSPOSE] = {"transpose", 4, pipe_transpose_encode,
+                         pipe_transpose_decode, NULL, NULL},
+    [STAGE_RLE] = {"rle", 0, NULL, NULL, rle_bin_compress,
+                   rle_bin_decompress},
+    [STAGE_HUFFMAN] = {"huffman", 0, NULL, NULL, huffman_compress,
+                       huffman_decompress},
+    [STAGE_ANS] = {"ans", 0, NULL, NULL, ans_compress, ans_decompress}
+};
+
+/* Renvoie vrai si "stage" et son paramètre "param" sont valides. */
+static int pipe_stage_valid(const int stage, const int param)
+{
+    if (stage <= STAGE_NONE || stage >= STAGE_NB)
+        return FALSE;
+    return PIPE_STAGES[stage].param ? param >= 1 && param <= PIPE_PARAM_MAX
+        : !param;
+}
+
+/* Écrit le message d'erreur de pipe_parse au format "s_format" dans "s_err"
+ * (de "err_size" bytes, rien si NULL).
+ * Renvoie -1. */
+static int pipe_parse_fail(char *s_err, const size_t err_size,
+                           const char *s_format, ...)
+{
+    if (s_err && err_size) {
+        va_list args;
+        va_start(args, s_format);
+        vsnprintf(s_err, err_size, s_format, args);
+        va_end(args);
+    }
+    return -1;
+}
+
+/* Lance l'étage "stage" de paramètre "param" dans le sens "mode" sur les
+ * "in_size" bytes de "p_in", dans une zone mémoire allouée dont l'adresse et
+ * la taille sont renvoyées dans "*pp_out" et "*p_out_size". Renvoie 0 sur un
+ * succès, -1 sur une erreur et positionne l'erreur de "cf" sur l'erreur
+ * produite par l'étage. */
+static int pipe_stage_run(cmp_file_s * cf, const pipe_stage_e stage,
+                          const int param, const mode_e mode,
+                          const byte_t * p_in, const size_t in_size,
+                          byte_t ** pp_out, size_t * p_out_size)
+{
+    const pipe_stage_desc_s *desc = &PIPE_STAGES[stage];
+    *pp_out = NULL;
+    if (desc->encode) {
+        if (!(*pp_out = malloc(in_size ? in_size : 1)))
+            return cmpf_set_err(cf, ERR_OTHER), -1;
+        (mode == MODE_COMPRESS ? desc->encode : desc->decode)
+            (p_in, *pp_out, in_size, param);
+        *p_out_size = in_size;
+        return 0;
+    }
+    cmp_file_s *cf_mem = cmpf_open_mem(p_in, in_size);
+    if (!cf_mem)
+        return cmpf_set_err(cf, ERR_OTHER), -1;
+    int (*run)(cmp_file_s *) = mode == MODE_COMPRESS ? desc->compress
+        : desc->decompress;
+    err_code_e err = run(cf_mem) ? cmpf_get_err(cf_mem) : ERR_NONE;
+    const err_code_e err_close = cmpf_close_mem(cf_mem, pp_out, p_out_size);
+    if (!err)
+        err = err_close;
+    if (err) {
+        free(*pp_out), *pp_out = NULL;
+        return cmpf_set_err(cf, err), -1;
+    }
+    return 0;
+}
+
+/* Fait passer les "in_size" bytes de "p_in" par les étages de "spec", dans
+ * l'ordre en compression et dans l'ordre inverse en décompression. Le
+ * résultat est alloué, et son adresse et sa taille sont renvoyées dans
+ * "*pp_out" et "*p_out_size". Renvoie 0 sur un succès, -1 sur une erreur
+ * (positionnée sur "cf" par l'étage) ou si un résultat dépasse PIPE_DATA_MAX
+ * bytes. */
+static int pipe_apply(cmp_file_s * cf, const pipe_spec_s * spec,
+                      const mode_e mode, const byte_t * p_in,
+                      const size_t in_size, byte_t ** pp_out,
+                      size_t * p_out_size)
+{
+    assert(spec->nb_stages > 0);
+    const byte_t *p_cur = p_in;
+    size_t size = in_size;
+    byte_t *p_next = NULL;
+    for (int i = 0; i < spec->nb_stages; i++) {
+        const int k = mode == MODE_COMPRESS ? i : spec->nb_stages - 1 - i;
+        const int ret = pipe_stage_run(cf, spec->a_stages[k],
+                                       spec->a_params[k], mode, p_cur, size,
+                                       &p_next, &size);
+        if (p_cur != p_in)
+            free((byte_t *) p_cur);
+        if (ret || size > PIPE_DATA_MAX)
+            return free(p_next), *pp_out = NULL, -1;
+        p_cur = p_next;
+    }
+    *pp_out = p_next, *p_out_size = size;
+    return 0;
+}
+
+/* Renvoie l'entier sur 32 bits en little endian à l'adresse "p". */
+static inline uint32_t pipe_load_le32(const byte_t * p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+/* Écrit "val" sur 32 bits en little endian à l'adresse "p". */
+static inline void pipe_store_le32(byte_t * p, const uint32_t val)
+{
+    for (int i = 0; i < 4; i++)
+        p[i] = (val >> (i * CHAR_BIT)) & 0xFF;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int pipe_parse(const char *s_list, pipe_spec_s * spec, char *s_err,
+               const size_t err_size)
+{
+    if (!spec)
+        return -1;
+    spec->nb_stages = 0;
+    if (!s_list || !*s_list)
+        return pipe_parse_fail(s_err, err_size, "liste d'étages vide");
+    const char *s = s_list;
+    do {
+        const size_t len = strcspn(s, ",:");
+        if (!len)
+            return pipe_parse_fail(s_err, err_size, "étage %d vide",
+                                   spec->nb_stages + 1);
+        pipe_stage_e stage = STAGE_NONE + 1;
+        while (stage < STAGE_NB && (strlen(PIPE_STAGES[stage].s_name) != len
+                                    || strncmp(s, PIPE_STAGES[stage].s_name,
+                                               len)))
+            stage++;
+        if (stage == STAGE_NB) {
+            char s_names[64] = "";
+            for (pipe_stage_e i = STAGE_NONE + 1; i < STAGE_NB; i++) {
+                strcat(s_names, i > STAGE_NONE + 1 ? ", " : "");
+                strcat(s_names, PIPE_STAGES[i].s_name);
+            }
+            return pipe_parse_fail(s_err, err_size,
+                                   "étage \"%.*s\" inconnu (étages : %s)",
+                                   (int) len, s, s_names);
+        }
+        if (spec->nb_stages == PIPE_STAGES_MAX)
+            return pipe_parse_fail(s_err, err_size,
+                                   "étage \"%s\" en trop (%d étages au plus)",
+                                   PIPE_STAGES[stage].s_name,
+                                   PIPE_STAGES_MAX);
+        const char *s_name = PIPE_STAGES[stage].s_name;
+        int param = PIPE_STAGES[stage].param;
+        s += len;
+        if (*s == ':') {
+            const size_t param_len = strcspn(++s, ",");
+            char *s_end = (char *) s;
+            long val = 0;
+            if (!param)
+                return pipe_parse_fail(s_err, err_size,
+                                       "l'étage \"%s\" n'a pas de "
+                                       "paramètre", s_name);
+            if (*s >= '0' && *s <= '9')
+                val = strtol(s, &s_end, 10);
+            if (s_end != s + param_len
+                || !pipe_stage_valid(stage, val > PIPE_PARAM_MAX ? 0 : val))
+                return pipe_parse_fail(s_err, err_size,
+                                       "paramètre \"%.*s\" de l'étage "
+                                       "\"%s\" invalide (entier de 1 à %d)",
+                                       (int) param_len, s, s_name,
+                                       PIPE_PARAM_MAX);
+            param = val;
+            s = s_end;
+        }
+        spec->a_stages[spec->nb_stages] = stage;
+        spec->a_params[spec->nb_stages++] = param;
+    } while (*s++);
+    return 0;
+}
+
+int pipe_compress(cmp_file_s * cf, const pipe_spec_s * spec)
+{
+    if (!cf)
+        return -1;
+    if (!spec)
+        return cmpf_set_err(cf, ERR_BAD_ADRESS), -1;
+    /* Chaîne vide (bibliothèque, banc sans -p) ou invalide. */
+    if (spec->nb_stages < 1 || spec->nb_stages > PIPE_STAGES_MAX)
+        return cmpf_set_err(cf, ERR_COMPRESSION_FAILED), -1;
+    for (int i = 0; i < spec->nb_stages; i++)
+        if (!pipe_stage_valid(spec->a_stages[i], spec->a_params[i]))
+            return cmpf_set_err(cf, ERR_COMPRESSION_FAILED), -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_header[1 + 2 * PIPE_STAGES_MAX], *p_data = NULL;
+    size_t nb_bytes, data_size;
+    byte_t *p_in = malloc(PIPE_BLOCK_SIZE);
+    if (!p_in) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    /* Prologue : la chaîne. */
+    a_header[0] = spec->nb_stages;
+    for (int i = 0; i < spec->nb_stages; i++) {
+        a_header[1 + 2 * i] = spec->a_stages[i];
+        a_header[2 + 2 * i] = spec->a_params[i];
+    }
+    if (cmpf_put_bytes(cf, a_header, 1 + 2 * spec->nb_stages))
+        goto error;
+
+    while ((nb_bytes = cmpf_get_bytes(cf, p_in, PIPE_BLOCK_SIZE))) {
+        if (pipe_apply(cf, spec, MODE_COMPRESS, p_in, nb_bytes, &p_data,
+                       &data_size))
+            goto error;
+        pipe_store_le32(a_header, nb_bytes);
+        pipe_store_le32(a_header + 4, data_size);
+        if (cmpf_put_bytes(cf, a_header, PIPE_BLOCK_HEADER)
+            || cmpf_put_bytes(cf, p_data, data_size))
+            goto error;
+        free(p_data), p_data = NULL;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    /* Fin du flux : bloc de taille nulle. */
+    pipe_store_le32(a_header, 0);
+    if (cmpf_put_bytes(cf, a_header, 4))
+        goto error;
+    free(p_in);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_in), free(p_data);
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int pipe_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t a_header[2 * PIPE_STAGES_MAX], *p_in = NULL, *p_out = NULL;
+    size_t out_size;
+    pipe_spec_s spec;
+
+    /* Prologue : la chaîne. */
+    if (cmpf_get_bytes(cf, a_header, 1) != 1)
+        goto error;
+    spec.nb_stages = a_header[0];
+    if (spec.nb_stages < 1 || spec.nb_stages > PIPE_STAGES_MAX
+        || cmpf_get_bytes(cf, a_header, 2 * spec.nb_stages)
+        != (size_t) 2 * spec.nb_stages)
+        goto error;
+    for (int i = 0; i < spec.nb_stages; i++) {
+        if (!pipe_stage_valid(a_header[2 * i], a_header[2 * i + 1]))
+            goto error;
+        spec.a_stages[i] = a_header[2 * i];
+        spec.a_params[i] = a_header[2 * i + 1];
+    }
+
+    while (TRUE) {
+        if (cmpf_get_bytes(cf, a_header, 4) != 4)
+            goto error;
+        const uint32_t size = pipe_load_le32(a_header);
+        if (!size)
+            break;
+        if (cmpf_get_bytes(cf, a_header + 4, 4) != 4)
+            goto error;
+        const uint32_t data_size = pipe_load_le32(a_header + 4);
+        if (size > PIPE_BLOCK_SIZE || data_size > PIPE_DATA_MAX
+            || !(p_in = malloc(data_size ? data_size : 1))
+            || cmpf_get_bytes(cf, p_in, data_size) != data_size
+            || pipe_apply(cf, &spec, MODE_DECOMPRESS, p_in, data_size,
+                          &p_out, &out_size) || out_size != size
+            || cmpf_put_bytes(cf, p_out, size))
+            goto error;
+        free(p_in), free(p_out);
+        p_in = p_out = NULL;
+    }
+    if (cmpf_get_err(cf) == ERR_IO_FREAD)
+        goto error;
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_in), free(p_out);
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+}
@@ -18,34 +18,47 @@
  * L'algorithme nécessite des fichiers encodés en ASCII pour fonctionner. */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <limits.h>
 #include <assert.h>
 #include "errors.h"
 #include "io.h"
 #include "common.h"
+#include "algo_rle.h"
+
+/* Portabilité entre compilateur. */
+#ifndef __GNUC__
+#define  __attribute__(x)       /* Nothing. */
+#endif
+
+/* Recherche des répétitions avec les instructions SIMD des processeurs x86
+ * (désactivable avec -DRLE_NO_SIMD). */
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(RLE_NO_SIMD)
+#define RLE_BIN_SIMD
+#include <immintrin.h>
+#endif
 
 /* Macro-constantes privées ================================================= */
 
 /* Valeur maximal du code de répétition. */
 #define REP_CODE_MAX ((0b1 << REP_CODE_LENGHT)-1)
-/* Nombre de bit du code de répétition (sans compter le premier bit ID).
- * 2 <= REP_CODE_LENGHT <= 7. */
-#define REP_CODE_LENGHT 3       /* Valeur optimale déterminée empiriquement. */
 
-/* Utilisés pour gérer le déplacement dans les blocs en fonction de la
- * compression ou de la décompression. */
+/* Mode de déplacement sur les blocs lors de l'écriture et de la lecture,
+ * passé en paramètre "mov" des fonctions de bloc. RLE_MODE_COMPRESS permet une
+ * lecture du bit de poids faible vers le bit de fort du bloc et une écriture du
+ * bit de poids fort vers le bit de poids faible du bloc, et
+ * RLE_MODE_DECOMPRESS permet une lecture du bit de poids fort vers le bit de
+ * poids faible du bloc et une écriture du bit de poids faible vers le bit de
+ * poids fort du bloc. Le mode est une constante dans rle_compress et
+ * rle_decompress : les fonctions de bloc, toujours intégrées, y sont
+ * spécialisées à la compilation, sans calcul du déplacement à l'exécution ni
+ * état partagé entre les flux. */
 #define RLE_MODE_COMPRESS 0
 #define RLE_MODE_DECOMPRESS 1
 
-/* Variables globales privées =============================================== */
-
-/* Mode de déplacement sur les blocs lors de l'écriture et de la lecture. 0
- * permet une lecture du bit de poids faible vers le bit de fort du bloc et une
- * écriture du bit de poids fort vers le bit de poids faible du bloc, et 1
- * permet une lecture du bit de poids fort vers le bit de poids faible du bloc
- * et une écriture du bit de poids faible vers le bit de poids fort du bloc. */
-static int RLE_MODE_MOV;
-
 /* Fonctions privées ======================================================== */
 
 /* # Écriture =============================================================== */
@@ -59,43 +72,63 @@ static int RLE_MODE_MOV;
 
 /* Vide le bloc "blck" dans la structure "cf". Réinitialise le bloc à 0 et la
  * position "pos" pour la prochaine écriture.
- * Renvoie 0 sur un succès, -1 sur une erreur et positionne "CMP_err" sur
- * l'erreur correspondante.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de "cf"
+ * sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
  * erreur survient lors de l'écriture. */
-static int rle_blck_flush(cmp_file_s * cf, block_t * blck, int *pos);
-static inline int rle_blck_flush(cmp_file_s * cf, block_t * blck, int *pos)
+static int rle_blck_flush(cmp_file_s * cf, block_t * blck, int *pos,
+                          const int mov) __attribute__ ((always_inline));
+static inline int rle_blck_flush(cmp_file_s * cf, block_t * blck, int *pos,
+                                 const int mov)
 {
     assert(cf && blck && pos);
     block_t blck_tmp = *blck;
     *blck = 0;
-    *pos = !RLE_MODE_MOV ? BLOCK_LENGHT : 0;
+    *pos = !mov ? BLOCK_LENGHT : 0;
     return cmpf_put_block(cf, blck_tmp);
 }
 
+/* Écris le dernier bloc "blck" du flux dans "cf" sans ses octets à 0 de fin :
+ * les formats RLE et RLE rapide, comme les fichiers ASCII qu'ils compressent,
+ * ne contiennent aucun octet nul, ce ne sont donc que du bourrage.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de "cf"
+ * sur l'erreur correspondante.
+ * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
+ * erreur survient lors de l'écriture. */
+static int rle_blck_put_last(cmp_file_s * cf, const block_t blck)
+{
+    byte_t a_bytes[BLOCK_SIZE];
+    size_t size = BLOCK_SIZE;
+    memcpy(a_bytes, &blck, BLOCK_SIZE);
+    while (size && !a_bytes[size - 1])
+        size--;
+    return cmpf_put_bytes(cf, a_bytes, size);
+}
+
 /* Ajoute un bit à la position "pos" au bloc "blck". Le bloc sera vidé dans "cf"
  * automatiquement pour l'écriture du bit.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
  * erreur survient lors de l'écriture. */
 static int rle_blck_put_bit(cmp_file_s * cf, block_t * blck,
-                            const int bit, int *pos);
+                            const int bit, int *pos, const int mov)
+    __attribute__ ((always_inline));
 static inline int rle_blck_put_bit(cmp_file_s * cf, block_t * blck,
-                                   const int bit, int *pos)
+                                   const int bit, int *pos, const int mov)
 {
     assert(cf && blck && pos);
     assert(bit == 0 || bit == 1);
     /* Cas où le bloc est plein. */
-    if (*pos + RLE_MODE_MOV == 0 || *pos + RLE_MODE_MOV == BLOCK_LENGHT + 1) {
-        if ((rle_blck_flush(cf, blck, pos)))
+    if (*pos + mov == 0 || *pos + mov == BLOCK_LENGHT + 1) {
+        if ((rle_blck_flush(cf, blck, pos, mov)))
             return -1;
     }
     /* Déplacement avant l'écriture si on compresse. */
-    *pos -= 1 - RLE_MODE_MOV;
+    *pos -= 1 - mov;
     PUT_BIT(*blck, bit, *pos);
     /* Déplacement après l'écriture si on décompresse. */
-    *pos += RLE_MODE_MOV;
+    *pos += mov;
     return 0;
 }
 
@@ -103,23 +136,25 @@ static inline int rle_blck_put_bit(cmp_file_s * cf, block_t * blck,
  * position "pos" (bit de poids faible). Le bloc sera vidé automatiquement dans
  * "cf" s'il n'y a plus de place pour le mot. La position sera modifiée
  * automatiquement pour l'écriture du mot.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
  * erreur survient lors de l'écriture. */
 static int rle_blck_put_word_by_bit(cmp_file_s * cf, block_t * blck, int *pos,
-                                    const byte_t byte, const int w_len);
+                                    const byte_t byte, const int w_len,
+                                    const int mov)
+    __attribute__ ((always_inline));
 static inline int rle_blck_put_word_by_bit(cmp_file_s * cf, block_t * blck,
                                            int *pos, const byte_t byte,
-                                           const int w_len)
+                                           const int w_len, const int mov)
 {
     assert(cf && blck && pos);
     assert((unsigned int)w_len <= CHAR_BIT);
-    for (int i = (1 - RLE_MODE_MOV) * (w_len - 1); (unsigned int)i < w_len;
-         i += -(1 - RLE_MODE_MOV) + RLE_MODE_MOV) {
+    for (int i = (1 - mov) * (w_len - 1); (unsigned int)i < w_len;
+         i += -(1 - mov) + mov) {
         byte_t bit;
         GET_BIT(byte, bit, i);
-        if (rle_blck_put_bit(cf, blck, bit, pos))
+        if (rle_blck_put_bit(cf, blck, bit, pos, mov))
             return -1;
     }
     return 0;
@@ -130,27 +165,29 @@ static inline int rle_blck_put_word_by_bit(cmp_file_s * cf, block_t * blck,
  * "CHAR_BIT" (meilleur performance), ou bit par bit s'il est plus petit. Le
  * bloc sera vidé automatiquement dans "cf" s'il n'y a plus de place pour le
  * mot. La position sera modifiée automatiquement pour l'écriture du mot.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
  * erreur survient lors de l'écriture. */
 static int rle_blck_put_word(cmp_file_s * cf, block_t * blck, int *pos,
-                             const byte_t byte, const int w_len);
+                             const byte_t byte, const int w_len, const int mov)
+    __attribute__ ((always_inline));
 static inline int rle_blck_put_word(cmp_file_s * cf, block_t * blck, int *pos,
-                                    const byte_t byte, const int w_len)
+                                    const byte_t byte, const int w_len,
+                                    const int mov)
 {
     assert(cf && blck && pos);
     assert((unsigned int)w_len <= CHAR_BIT);
     /* Cas où le mot est plus petit que 8 bits (code de répétition), ou qu'il
      * n'y a pas la place pour écrire le mot. */
-    if (w_len < CHAR_BIT || (!RLE_MODE_MOV && *pos < CHAR_BIT)
-        || (RLE_MODE_MOV && *pos > BLOCK_LENGHT - CHAR_BIT)) {
-        if (rle_blck_put_word_by_bit(cf, blck, pos, byte, w_len))
+    if (w_len < CHAR_BIT || (!mov && *pos < CHAR_BIT)
+        || (mov && *pos > BLOCK_LENGHT - CHAR_BIT)) {
+        if (rle_blck_put_word_by_bit(cf, blck, pos, byte, w_len, mov))
             return -1;
     } else {
-        *pos -= (1 - RLE_MODE_MOV) * CHAR_BIT;  /* Déplacement compression. */
+        *pos -= (1 - mov) * CHAR_BIT;  /* Déplacement compression. */
         *blck = blck_put_byte(*blck, byte, *pos);
-        *pos += RLE_MODE_MOV * CHAR_BIT;        /* Déplacement décompression. */
+        *pos += mov * CHAR_BIT;        /* Déplacement décompression. */
     }
     return 0;
 }
@@ -159,42 +196,45 @@ static inline int rle_blck_put_word(cmp_file_s * cf, block_t * blck, int *pos,
 
 /* Recharge le bloc "blck" depuis la structure "cf". Réinitialise la position
  * "pos" pour la prochaine lecture.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FREAD si une
  * erreur survient lors de la lecture, ERR_IO_FREAD_EOF si on à déjà lu la fin
  * du fichier. */
-static int rle_blck_reload(cmp_file_s * cf, block_t * blck, int *pos);
-static inline int rle_blck_reload(cmp_file_s * cf, block_t * blck, int *pos)
+static int rle_blck_reload(cmp_file_s * cf, block_t * blck, int *pos,
+                           const int mov) __attribute__ ((always_inline));
+static inline int rle_blck_reload(cmp_file_s * cf, block_t * blck, int *pos,
+                                  const int mov)
 {
     assert(cf && blck && pos);
-    *pos = RLE_MODE_MOV ? BLOCK_LENGHT : 0;
+    *pos = mov ? BLOCK_LENGHT : 0;
     return cmpf_get_block(cf, blck);
 }
 
 /* Récupère un bit à la position "pos" au bloc "blck". Le bloc sera recharger
  * depuis "cf" si besoin. La position sera modifiée automatiquement pour la
  * lecture du bit.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FREAD si une
  * erreur survient lors de la lecture, ERR_IO_FREAD_EOF si on à déjà lu la fin
  * du fichier. */
 static int rle_blck_get_bit(cmp_file_s * cf, block_t * blck,
-                            int *bit, int *pos);
+                            int *bit, int *pos, const int mov)
+    __attribute__ ((always_inline));
 static inline int rle_blck_get_bit(cmp_file_s * cf, block_t * blck,
-                                   int *bit, int *pos)
+                                   int *bit, int *pos, const int mov)
 {
     assert(cf && blck && bit && pos);
     /* Cas où le bloc est vide. */
-    if (*pos + (1 - RLE_MODE_MOV) == 0
-        || *pos + (1 - RLE_MODE_MOV) == BLOCK_LENGHT + 1) {
-        if (rle_blck_reload(cf, blck, pos))
+    if (*pos + (1 - mov) == 0
+        || *pos + (1 - mov) == BLOCK_LENGHT + 1) {
+        if (rle_blck_reload(cf, blck, pos, mov))
             return -1;
     }
-    *pos -= RLE_MODE_MOV;
+    *pos -= mov;
     GET_BIT(*blck, *bit, *pos);
-    *pos += 1 - RLE_MODE_MOV;
+    *pos += 1 - mov;
     assert(*bit == 0 || *bit == 1);
     return 0;
 }
@@ -203,22 +243,24 @@ static inline int rle_blck_get_bit(cmp_file_s * cf, block_t * blck,
  * position "pos" (bit de poids faible) et le stocke dans "byte". Le bloc sera
  * recharger automatiquement dans "cf" si besoin. La position sera modifiée
  * automatiquement pour la lecture du mot.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FREAD si une
  * erreur survient lors de la lecture, ERR_IO_FREAD_EOF si on à déjà lu la fin
  * du fichier. */
 static int rle_blck_get_word_by_bit(cmp_file_s * cf, block_t * blck, int *pos,
-                                    byte_t * byte, const int w_len);
+                                    byte_t * byte, const int w_len,
+                                    const int mov)
+    __attribute__ ((always_inline));
 static inline int rle_blck_get_word_by_bit(cmp_file_s * cf, block_t * blck,
                                            int *pos, byte_t * byte,
-                                           const int w_len)
+                                           const int w_len, const int mov)
 {
     assert(cf && blck && pos);
     assert((unsigned int)w_len <= CHAR_BIT);
-    for (int i = (RLE_MODE_MOV) * (w_len - 1), bit = 0; (unsigned int)i < w_len;
-         i -= -(1 - RLE_MODE_MOV) + RLE_MODE_MOV) {
-        if (rle_blck_get_bit(cf, blck, &bit, pos))
+    for (int i = (mov) * (w_len - 1), bit = 0; (unsigned int)i < w_len;
+         i -= -(1 - mov) + mov) {
+        if (rle_blck_get_bit(cf, blck, &bit, pos, mov))
             return -1;
         PUT_BIT(*byte, bit, i);
     }
@@ -230,32 +272,443 @@ static inline int rle_blck_get_word_by_bit(cmp_file_s * cf, block_t * blck,
  * possible, ou si le mot est coupé entre deux bloc ou plus petit que 8 bits, on
  * lit le mot bit à bit et récupère un nouveau bloc dans "cf" si besoin. Modifie
  * la position pour la lecture du mot.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et "CMP_err" sera positionné
- * sur l'erreur correspondante.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
  * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FREAD si une
  * erreur survient lors de la lecture, ERR_IO_FREAD_EOF si on à déjà lu la fin
  * du fichier. */
 static int rle_blck_get_word(cmp_file_s * cf, block_t * blck, int *pos,
-                             byte_t * byte, const int w_len);
+                             byte_t * byte, const int w_len, const int mov)
+    __attribute__ ((always_inline));
 static inline int rle_blck_get_word(cmp_file_s * cf, block_t * blck, int *pos,
-                                    byte_t * byte, const int w_len)
+                                    byte_t * byte, const int w_len,
+                                    const int mov)
 {
     assert(cf && blck && pos && byte);
     assert((unsigned int)w_len <= CHAR_BIT);
     /* Cas où le mot est coupé entre deux blocs, ou qu'il est plus petit que 8
      * bits : il faut le lire bit par bit. */
-    if (w_len < CHAR_BIT || (RLE_MODE_MOV && *pos < CHAR_BIT)
-        || (!RLE_MODE_MOV && *pos > BLOCK_LENGHT - CHAR_BIT)) {
-        if (rle_blck_get_word_by_bit(cf, blck, pos, byte, w_len))
+    if (w_len < CHAR_BIT || (mov && *pos < CHAR_BIT)
+        || (!mov && *pos > BLOCK_LENGHT - CHAR_BIT)) {
+        if (rle_blck_get_word_by_bit(cf, blck, pos, byte, w_len, mov))
             return -1;
     } else {
-        *pos -= RLE_MODE_MOV * CHAR_BIT;
+        *pos -= mov * CHAR_BIT;
         *byte = blck_get_byte(*blck, *pos);
-        *pos += (1 - RLE_MODE_MOV) * CHAR_BIT;
+        *pos += (1 - mov) * CHAR_BIT;
     }
     /* Si byte == 0, on est à la fin de notre bloc. */
     if (!(*byte))
-        return CMP_err = ERR_IO_FREAD_EOF, -1;
+        return cmpf_set_err(cf, ERR_IO_FREAD_EOF), -1;
+    return 0;
+}
+
+/* # Moteur rapide ========================================================= */
+
+/* Le moteur rapide produit exactement le même format que les fonctions
+ * ci-dessus, mais au lieu de traiter les mots bit par bit, il accumule les
+ * champs entiers (caractère sur 8 bits, ou code de répétition et caractère sur
+ * 12 bits) dans un accumulateur de 64 bits. La décompression lit une fenêtre
+ * de bits sur deux blocs et décode chaque champ grâce à une table indexée par
+ * le bit d'identification et le code de répétition. Le sens de déplacement est
+ * fixé par la fonction utilisée, "mov" n'est donc pas utilisé. */
+
+/* Longueur en bit d'un code de répétition avec son bit d'identification. */
+#define RLE_FAST_CODE_LENGHT (REP_CODE_LENGHT + 1)
+/* Longueur en bit d'un champ de répétition (code puis caractère). */
+#define RLE_FAST_REP_LENGHT (RLE_FAST_CODE_LENGHT + CHAR_BIT)
+/* Nombre maximal de champs de répétition écrits d'un seul coup. */
+#define RLE_FAST_REP_GROUP (BLOCK_LENGHT / RLE_FAST_REP_LENGHT)
+/* Bloc dont tout les octets valent 1, permet de répliquer un octet. */
+#define RLE_FAST_BYTE_REPLICATE 0x0101010101010101ULL
+
+/* Entrée de la table de décodage. */
+typedef struct rle_fast_code {
+    int lenght;                 /* Longueur du champ en bit. */
+    int count;                  /* Nombre de répétition du caractère (0 si le
+                                   code est invalide). */
+} rle_fast_code_s;
+
+/* Écris le champ "field" de longueur "f_len" (< BLOCK_LENGHT) sur le bloc
+ * "blck" dont "pos" bits sont déjà remplis à partir du bit de poids fort. Le
+ * bloc sera vidé dans "cf" dès qu'il est plein.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
+ * erreur survient lors de l'écriture. */
+static int rle_fast_put_field(cmp_file_s * cf, block_t * blck, int *pos,
+                              const block_t field, const int f_len);
+static inline int rle_fast_put_field(cmp_file_s * cf, block_t * blck,
+                                     int *pos, const block_t field,
+                                     const int f_len)
+{
+    assert(cf && blck && pos);
+    assert(f_len > 0 && f_len < BLOCK_LENGHT);
+    assert(*pos >= 0 && *pos < BLOCK_LENGHT);
+    const int spill = *pos + f_len - BLOCK_LENGHT;
+    /* Cas où le champ tient dans le bloc. */
+    if (spill < 0) {
+        *blck = (*blck << f_len) | field;
+        *pos += f_len;
+        return 0;
+    }
+    /* Sinon, on complète le bloc avec le début du champ, on le vide, et on
+     * garde la fin du champ pour le bloc suivant. */
+    block_t blck_tmp = (*blck << (f_len - spill)) | (field >> spill);
+    *blck = field & (((block_t) 1 << spill) - 1);
+    *pos = spill;
+    return cmpf_put_block(cf, blck_tmp);
+}
+
+/* Écris "count" répétitions du caractère "byte" sur le bloc "blck" à la
+ * position "pos", sous la forme de caractères seuls ou de codes de répétition.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
+ * erreur survient lors de l'écriture. */
+static int rle_fast_put_run(cmp_file_s * cf, block_t * blck, int *pos,
+                            const byte_t byte, size_t count);
+static inline int rle_fast_put_run(cmp_file_s * cf, block_t * blck, int *pos,
+                                   const byte_t byte, size_t count)
+{
+    assert(cf && blck && pos);
+    /* Champ d'une répétition pleine : bit d'identification, code maximal puis
+     * le caractère. */
+    const block_t rep_full = (((block_t) 1 << REP_CODE_LENGHT | REP_CODE_MAX)
+                              << CHAR_BIT) | byte;
+    /* Longues répétitions : plusieurs codes pleins écrits d'un seul coup. */
+    if (count >= RLE_FAST_REP_GROUP * REP_CODE_MAX) {
+        block_t group = 0;
+        for (int i = 0; i < RLE_FAST_REP_GROUP; i++)
+            group = (group << RLE_FAST_REP_LENGHT) | rep_full;
+        do {
+            if (rle_fast_put_field(cf, blck, pos, group,
+                                   RLE_FAST_REP_GROUP * RLE_FAST_REP_LENGHT))
+                return -1;
+            count -= RLE_FAST_REP_GROUP * REP_CODE_MAX;
+        } while (count >= RLE_FAST_REP_GROUP * REP_CODE_MAX);
+    }
+    for (; count >= REP_CODE_MAX; count -= REP_CODE_MAX) {
+        if (rle_fast_put_field(cf, blck, pos, rep_full, RLE_FAST_REP_LENGHT))
+            return -1;
+    }
+    /* Reste de la répétition. */
+    if (count == 1)
+        return rle_fast_put_field(cf, blck, pos, byte, CHAR_BIT);
+    else if (count > 1)
+        return rle_fast_put_field(cf, blck, pos,
+                                  (((block_t) 1 << REP_CODE_LENGHT | count)
+                                   << CHAR_BIT) | byte, RLE_FAST_REP_LENGHT);
+    return 0;
+}
+
+/* Écris les "b_len" bits de poids faible de "bytes" (multiple de CHAR_BIT,
+ * < BLOCK_LENGHT) sur le bloc "blck" dont "pos" bits sont déjà remplis à
+ * partir du bit de poids faible. Le bloc sera vidé dans "cf" dès qu'il est
+ * plein.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_BAD_ADRESS si un pointeur est incorrect, ERR_IO_FWRITE si une
+ * erreur survient lors de l'écriture. */
+static int rle_fast_put_bytes(cmp_file_s * cf, block_t * blck, int *pos,
+                              const block_t bytes, const int b_len);
+static inline int rle_fast_put_bytes(cmp_file_s * cf, block_t * blck,
+                                     int *pos, const block_t bytes,
+                                     const int b_len)
+{
+    assert(cf && blck && pos);
+    assert(b_len > 0 && b_len < BLOCK_LENGHT);
+    *blck |= bytes << *pos;
+    /* Cas où le bloc n'est pas encore plein. */
+    if (*pos + b_len < BLOCK_LENGHT) {
+        *pos += b_len;
+        return 0;
+    }
+    /* Sinon, on le vide et on garde la fin des octets pour le suivant. */
+    block_t blck_tmp = *blck;
+    const int spill = *pos + b_len - BLOCK_LENGHT;
+    *blck = spill ? bytes >> (b_len - spill) : 0;
+    *pos = spill;
+    return cmpf_put_block(cf, blck_tmp);
+}
+
+/* # Moteur binaire ======================================================== */
+
+/* Le moteur binaire utilise son propre format, orienté octet (de la famille
+ * PackBits), qui accepte tout les octets. Le flux est une suite de paquets,
+ * chacun commençant par un byte de contrôle "c" :
+ * - c < RLE_BIN_CODE_RUN : c + 1 octets littéraux suivent ;
+ * - RLE_BIN_CODE_RUN <= c < RLE_BIN_CODE_LONG : l'octet qui suit est répété
+ *   c - RLE_BIN_CODE_RUN + RLE_BIN_RUN_MIN fois ;
+ * - c == RLE_BIN_CODE_LONG : une longueur supplémentaire (entier de longueur
+ *   variable, 7 bits par byte, bit de poids fort à 1 si un byte suit) puis
+ *   l'octet répété RLE_BIN_RUN_LONG_MIN + longueur fois.
+ * Le flux se termine à la fin d'un paquet. Une répétition est décompressée
+ * avec "memset", et sa longueur n'est limitée que par celle du fichier. */
+
+/* Nombre maximal d'octets littéraux d'un paquet. */
+#define RLE_BIN_LIT_MAX 128
+/* Premier byte de contrôle d'une répétition. */
+#define RLE_BIN_CODE_RUN 0x80
+/* Byte de contrôle d'une longue répétition. */
+#define RLE_BIN_CODE_LONG 0xFF
+/* Longueur minimale d'une répétition : une répétition plus courte n'est pas
+ * plus petite que ses octets littéraux. */
+#define RLE_BIN_RUN_MIN 3
+/* Longueur minimale d'une longue répétition. */
+#define RLE_BIN_RUN_LONG_MIN (RLE_BIN_RUN_MIN + RLE_BIN_CODE_LONG \
+                              - RLE_BIN_CODE_RUN)
+/* Nombre maximal de bytes de la longueur d'une longue répétition. */
+#define RLE_BIN_VARINT_MAX 10
+/* Taille maximale d'un paquet. */
+#define RLE_BIN_PACKET_MAX (1 + RLE_BIN_LIT_MAX)
+/* Taille des buffers de lecture et d'écriture. */
+#define RLE_BIN_BUFFER_SIZE (1 << 16)
+
+/* État du compresseur binaire. */
+typedef struct rle_bin_encoder {
+    cmp_file_s *cf;             /* Couple de fichiers. */
+    byte_t *p_out;              /* Buffer d'écriture. */
+    size_t out_len;             /* Nombre de bytes dans le buffer. */
+    byte_t a_lit[RLE_BIN_LIT_MAX];      /* Littéraux en attente. */
+    int lit_len;                /* Nombre de littéraux en attente. */
+    byte_t run_byte;            /* Octet de la répétition en cours. */
+    uint64_t run_len;           /* Longueur de la répétition en cours. */
+} rle_bin_encoder_s;
+
+/* Détection des répétitions : les fonctions de recherche comparent 32 octets
+ * à la fois avec AVX2, 16 avec SSE2, ou 8 (un bloc) sinon. Le jeu
+ * d'instructions est choisi à l'exécution selon le processeur, par
+ * rle_bin_scan_select. */
+
+/* Fonctions de recherche des répétitions. */
+typedef struct rle_bin_scan {
+    /* Renvoie le nombre d'octets égaux à "*p" à partir de "p", sans dépasser
+     * "p_end" (au moins 1). */
+    size_t (*run_lenght)(const byte_t * p, const byte_t * p_end);
+    /* Renvoie la première position à partir de "p" où commence une
+     * répétition d'au moins RLE_BIN_RUN_MIN octets, ou la position des
+     * RLE_BIN_RUN_MIN - 1 derniers octets avant "p_end" s'il n'y en a pas
+     * (ou "p" si la zone est plus courte). */
+    const byte_t *(*run_find)(const byte_t * p, const byte_t * p_end);
+} rle_bin_scan_s;
+
+static size_t rle_bin_run_lenght(const byte_t * p, const byte_t * p_end)
+{
+    assert(p && p_end && p < p_end);
+    const block_t pattern = *p * RLE_FAST_BYTE_REPLICATE;
+    const byte_t *p_run = p + 1;
+    while (p_end - p_run >= (ptrdiff_t) BLOCK_SIZE) {
+        block_t blck;
+        memcpy(&blck, p_run, BLOCK_SIZE);
+        if (blck != pattern)
+            break;
+        p_run += BLOCK_SIZE;
+    }
+    while (p_run < p_end && *p_run == *p)
+        p_run++;
+    return p_run - p;
+}
+
+static const byte_t *rle_bin_run_find(const byte_t * p, const byte_t * p_end)
+{
+    assert(p && p_end && p <= p_end);
+    for (; p_end - p >= RLE_BIN_RUN_MIN; p++) {
+        if (p[0] == p[1] && p[0] == p[2])
+            return p;
+    }
+    return p;
+}
+
+#ifdef RLE_BIN_SIMD
+static size_t rle_bin_run_lenght_sse2(const byte_t * p, const byte_t * p_end)
+{
+    assert(p && p_end && p < p_end);
+    const __m128i pattern = _mm_set1_epi8(*p);
+    const byte_t *p_run = p + 1;
+    for (; p_end - p_run >= 16; p_run += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)p_run);
+        const unsigned int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, pattern))
+            ^ 0xFFFF;
+        if (mask)
+            return p_run + __builtin_ctz(mask) - p;
+    }
+    while (p_run < p_end && *p_run == *p)
+        p_run++;
+    return p_run - p;
+}
+
+static const byte_t *rle_bin_run_find_sse2(const byte_t * p,
+                                           const byte_t * p_end)
+{
+    assert(p && p_end && p <= p_end);
+    for (; p_end - p >= 16 + RLE_BIN_RUN_MIN - 1; p += 16) {
+        const __m128i v0 = _mm_loadu_si128((const __m128i *)p);
+        const __m128i v1 = _mm_loadu_si128((const __m128i *)(p + 1));
+        const __m128i v2 = _mm_loadu_si128((const __m128i *)(p + 2));
+        const unsigned int mask =
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v0, v1),
+                                            _mm_cmpeq_epi8(v0, v2)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+    return rle_bin_run_find(p, p_end);
+}
+
+__attribute__ ((target("avx2")))
+static size_t rle_bin_run_lenght_avx2(const byte_t * p, const byte_t * p_end)
+{
+    assert(p && p_end && p < p_end);
+    const __m256i pattern = _mm256_set1_epi8(*p);
+    const byte_t *p_run = p + 1;
+    for (; p_end - p_run >= 32; p_run += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)p_run);
+        const unsigned int mask =
+            ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, pattern));
+        if (mask)
+            return p_run + __builtin_ctz(mask) - p;
+    }
+    while (p_run < p_end && *p_run == *p)
+        p_run++;
+    return p_run - p;
+}
+
+__attribute__ ((target("avx2")))
+static const byte_t *rle_bin_run_find_avx2(const byte_t * p,
+                                           const byte_t * p_end)
+{
+    assert(p && p_end && p <= p_end);
+    for (; p_end - p >= 32 + RLE_BIN_RUN_MIN - 1; p += 32) {
+        const __m256i v0 = _mm256_loadu_si256((const __m256i *)p);
+        const __m256i v1 = _mm256_loadu_si256((const __m256i *)(p + 1));
+        const __m256i v2 = _mm256_loadu_si256((const __m256i *)(p + 2));
+        const unsigned int mask =
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(v0, v1),
+                                                  _mm256_cmpeq_epi8(v0, v2)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+    return rle_bin_run_find(p, p_end);
+}
+#endif
+
+/* Renvoie les fonctions de recherche des répétitions les plus rapides
+ * supportées par le processeur. */
+static const rle_bin_scan_s *rle_bin_scan_select(void)
+{
+    static const rle_bin_scan_s scan = {
+        rle_bin_run_lenght, rle_bin_run_find
+    };
+#ifdef RLE_BIN_SIMD
+    static const rle_bin_scan_s scan_sse2 = {
+        rle_bin_run_lenght_sse2, rle_bin_run_find_sse2
+    };
+    static const rle_bin_scan_s scan_avx2 = {
+        rle_bin_run_lenght_avx2, rle_bin_run_find_avx2
+    };
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return &scan_avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return &scan_sse2;
+#endif
+    return &scan;
+}
+
+/* Vide le buffer d'écriture de "e" dans le fichier sortant s'il ne reste pas
+ * "size" bytes de libres.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient lors de l'écriture. */
+static int rle_bin_reserve(rle_bin_encoder_s * e, const size_t size)
+{
+    assert(e && size <= RLE_BIN_BUFFER_SIZE);
+    if (e->out_len + size <= RLE_BIN_BUFFER_SIZE)
+        return 0;
+    if (cmpf_put_bytes(e->cf, e->p_out, e->out_len))
+        return -1;
+    e->out_len = 0;
+    return 0;
+}
+
+/* Écris le paquet des littéraux en attente de "e", s'il y en a.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient lors de l'écriture. */
+static int rle_bin_put_lit(rle_bin_encoder_s * e)
+{
+    assert(e);
+    if (!e->lit_len)
+        return 0;
+    if (rle_bin_reserve(e, 1 + e->lit_len))
+        return -1;
+    e->p_out[e->out_len++] = e->lit_len - 1;
+    memcpy(e->p_out + e->out_len, e->a_lit, e->lit_len);
+    e->out_len += e->lit_len;
+    e->lit_len = 0;
+    return 0;
+}
+
+/* Ajoute les "size" octets littéraux de "p" à ceux en attente de "e". Les
+ * paquets complets sont écrits directement depuis "p".
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient lors de l'écriture. */
+static int rle_bin_put_lits(rle_bin_encoder_s * e, const byte_t * p,
+                            size_t size)
+{
+    assert(e && p);
+    while (size) {
+        if (!e->lit_len && size >= RLE_BIN_LIT_MAX) {
+            if (rle_bin_reserve(e, 1 + RLE_BIN_LIT_MAX))
+                return -1;
+            e->p_out[e->out_len++] = RLE_BIN_LIT_MAX - 1;
+            memcpy(e->p_out + e->out_len, p, RLE_BIN_LIT_MAX);
+            e->out_len += RLE_BIN_LIT_MAX;
+            p += RLE_BIN_LIT_MAX, size -= RLE_BIN_LIT_MAX;
+            continue;
+        }
+        const size_t nb_bytes = RLE_BIN_LIT_MAX - e->lit_len < size
+            ? RLE_BIN_LIT_MAX - e->lit_len : size;
+        memcpy(e->a_lit + e->lit_len, p, nb_bytes);
+        e->lit_len += nb_bytes;
+        p += nb_bytes, size -= nb_bytes;
+        if (e->lit_len == RLE_BIN_LIT_MAX && rle_bin_put_lit(e))
+            return -1;
+    }
+    return 0;
+}
+
+/* Termine la répétition en cours de "e" : l'écris sous forme de paquet de
+ * répétition si elle est assez longue, ou l'ajoute aux littéraux en attente.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et l'erreur de "cf" sera
+ * positionnée sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient lors de l'écriture. */
+static int rle_bin_put_run(rle_bin_encoder_s * e)
+{
+    assert(e);
+    uint64_t len = e->run_len;
+    e->run_len = 0;
+    if (len < RLE_BIN_RUN_MIN) {
+        for (; len; len--) {
+            if (e->lit_len == RLE_BIN_LIT_MAX && rle_bin_put_lit(e))
+                return -1;
+            e->a_lit[e->lit_len++] = e->run_byte;
+        }
+        return 0;
+    }
+    if (rle_bin_put_lit(e)
+        || rle_bin_reserve(e, 2 + RLE_BIN_VARINT_MAX))
+        return -1;
+    if (len < RLE_BIN_RUN_LONG_MIN)
+        e->p_out[e->out_len++] = RLE_BIN_CODE_RUN + len - RLE_BIN_RUN_MIN;
+    else {
+        e->p_out[e->out_len++] = RLE_BIN_CODE_LONG;
+        for (len -= RLE_BIN_RUN_LONG_MIN; len >= 0x80; len >>= 7)
+            e->p_out[e->out_len++] = (len & 0x7F) | 0x80;
+        e->p_out[e->out_len++] = len;
+    }
+    e->p_out[e->out_len++] = e->run_byte;
     return 0;
 }
 
@@ -272,39 +725,45 @@ static inline int rle_blck_get_word(cmp_file_s * cf, block_t * blck, int *pos,
 int rle_compress(cmp_file_s * cf)
 {
     if (!cf)
-        return CMP_err = ERR_BAD_ADRESS, -1;
-    CMP_err = ERR_NONE;
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
 
-    RLE_MODE_MOV = RLE_MODE_COMPRESS;   /* Déplacement pour ce mode (compression). */
+    const int mov = RLE_MODE_COMPRESS;  /* Déplacement (compression). */
     block_t blck_in = 0, blck_out = 0;  /* Blocs de données. */
     byte_t byte_1 = 0, byte_2 = 0;      /* Octets temporaires pour comparaisons. */
     int count = 1, ind_in = BLOCK_LENGHT, ind_out = BLOCK_LENGHT;       /* Compteur et indice. */
 
-    rle_blck_get_word(cf, &blck_in, &ind_in, &byte_2, CHAR_BIT);
+    /* Une lecture échouée en début de bloc laisse l'octet inchangé : on le
+     * remet à 0 pour marquer la fin des données. */
+    if (rle_blck_get_word(cf, &blck_in, &ind_in, &byte_2, CHAR_BIT, mov))
+        byte_2 = 0;
     /* Parsing des blocs de données entrant (récupération des blocs
      * automatiques). */
-    while (!CMP_err) {
+    while (!cmpf_get_err(cf)) {
         /* Switch, relecture, comptage. */
         byte_1 = byte_2;
-        rle_blck_get_word(cf, &blck_in, &ind_in, &byte_2, CHAR_BIT);
+        if (rle_blck_get_word(cf, &blck_in, &ind_in, &byte_2, CHAR_BIT, mov))
+            byte_2 = 0;
         count += (byte_1 == byte_2);
         /* Cas sans répétition, écriture du caractère. */
         if (count == 1)
-            rle_blck_put_word(cf, &blck_out, &ind_out, byte_1, CHAR_BIT);
+            rle_blck_put_word(cf, &blck_out, &ind_out, byte_1, CHAR_BIT, mov);
         /* Cas avec répétition terminée ou code de répétition plein. */
         else if (byte_1 != byte_2 || count == REP_CODE_MAX) {
             /* Switch pour forcer la terminaison de la répétition. */
             if (count == REP_CODE_MAX) {
                 byte_1 = byte_2;
-                rle_blck_get_word(cf, &blck_in, &ind_in, &byte_2, CHAR_BIT);
+                if (rle_blck_get_word(cf, &blck_in, &ind_in, &byte_2,
+                                      CHAR_BIT, mov))
+                    byte_2 = 0;
             }
             /* Éciture de l'ID d'un code : 1 bit à 1. */
             PUT_BIT(count, 1, REP_CODE_LENGHT);
             /* Écriture du code de répétition. */
             rle_blck_put_word(cf, &blck_out, &ind_out, count,
-                              REP_CODE_LENGHT + 1);
+                              REP_CODE_LENGHT + 1, mov);
             /* Écriture du caractère à répeter et reset du compteur. */
-            rle_blck_put_word(cf, &blck_out, &ind_out, byte_1, CHAR_BIT);
+            rle_blck_put_word(cf, &blck_out, &ind_out, byte_1, CHAR_BIT, mov);
             count = 1;
 
         }
@@ -314,53 +773,321 @@ int rle_compress(cmp_file_s * cf)
     /* Écriture du dernier byte du bloc s'il n'a pas été comparé (passer dans
      * byte_1). */
     if (byte_2)
-        rle_blck_put_word(cf, &blck_out, &ind_out, byte_2, CHAR_BIT);
+        rle_blck_put_word(cf, &blck_out, &ind_out, byte_2, CHAR_BIT, mov);
     /* Si erreur pendant la compression ou l'écriture du dernier bloc. */
-    if ((CMP_err != ERR_IO_FREAD_EOF && CMP_err)
-        || cmpf_put_block(cf, blck_out))
-        return err_print(CMP_err), CMP_err = ERR_COMPRESSION_FAILED, -1;
+    if ((cmpf_get_err(cf) != ERR_IO_FREAD_EOF && cmpf_get_err(cf))
+        || rle_blck_put_last(cf, blck_out))
+        return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
     return 0;
 }
 
 int rle_decompress(cmp_file_s * cf)
 {
     if (!cf)
-        return CMP_err = ERR_BAD_ADRESS, -1;
-    CMP_err = ERR_NONE;
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
 
-    RLE_MODE_MOV = RLE_MODE_DECOMPRESS; /* Déplacement pour ce mode (décompression). */
+    const int mov = RLE_MODE_DECOMPRESS;        /* Déplacement (décomp.). */
     block_t blck_in = 0, blck_out = 0;  /* Blocs de données. */
     byte_t byte = 1, rep_code = 1;      /* Octet de lecture, code de répétition. */
     int ind_in = 0, ind_out = 0, bit = 0;       /* Indice et bit. */
 
     /* Parsing des blocs de données entrant (récupération des blocs
      * automatiques). */
-    while (!CMP_err) {
-        /* Récupération du premier bit d'identification. */
-        rle_blck_get_bit(cf, &blck_in, &bit, &ind_in);
+    while (!cmpf_get_err(cf)) {
+        /* Récupération du premier bit d'identification. Une lecture échouée
+         * signifie la fin du flux, le mot en cours n'est alors pas écrit. */
+        if (rle_blck_get_bit(cf, &blck_in, &bit, &ind_in, mov))
+            break;
         /* Cas sans répétition, écriture du caractère. */
         if (!bit) {
             /* Récupération du caractère (relecture bit de poids fort). */
             ind_in++;
-            rle_blck_get_word(cf, &blck_in, &ind_in, &byte, CHAR_BIT);
+            if (rle_blck_get_word(cf, &blck_in, &ind_in, &byte, CHAR_BIT, mov))
+                break;
             /* Écriture du caractère. */
-            rle_blck_put_word(cf, &blck_out, &ind_out, byte, CHAR_BIT);
+            rle_blck_put_word(cf, &blck_out, &ind_out, byte, CHAR_BIT, mov);
         }
         /* Cas avec répétition. */
         else {
-            /* Récupération du code. */
-            rle_blck_get_word(cf, &blck_in, &ind_in, &rep_code,
-                              REP_CODE_LENGHT);
-            /* Récupération du caractère. */
-            rle_blck_get_word(cf, &blck_in, &ind_in, &byte, CHAR_BIT);
+            /* Récupération du code et du caractère. */
+            if (rle_blck_get_word(cf, &blck_in, &ind_in, &rep_code,
+                                  REP_CODE_LENGHT, mov)
+                || rle_blck_get_word(cf, &blck_in, &ind_in, &byte, CHAR_BIT,
+                                     mov))
+                break;
             /* Écriture du caractère REP_CODE fois. */
             for (int i = 0; i < rep_code; i++)
-                rle_blck_put_word(cf, &blck_out, &ind_out, byte, CHAR_BIT);
+                rle_blck_put_word(cf, &blck_out, &ind_out, byte, CHAR_BIT, mov);
         }
     }
     /* Si erreur pendant la décompression ou l'écriture du dernier bloc. */
-    if ((CMP_err != ERR_IO_FREAD_EOF && CMP_err)
-        || cmpf_put_block(cf, blck_out))
-        return err_print(CMP_err), CMP_err = ERR_DECOMPRESSION_FAILED, -1;
+    if ((cmpf_get_err(cf) != ERR_IO_FREAD_EOF && cmpf_get_err(cf))
+        || rle_blck_put_last(cf, blck_out))
+        return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+    return 0;
+}
+
+int rle_fast_compress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    block_t blck_in = 0, blck_out = 0;  /* Blocs de données. */
+    byte_t byte = 0;            /* Caractère de la répétition en cours. */
+    size_t count = 0;           /* Longueur de la répétition en cours. */
+    int ind_out = 0, end = FALSE;       /* Bits remplis, fin des données. */
+
+    while (!end && !cmpf_get_block(cf, &blck_in)) {
+        /* Bloc entièrement constitué du caractère en cours : la répétition
+         * s'allonge d'un bloc entier. */
+        if (count && blck_in == byte * RLE_FAST_BYTE_REPLICATE) {
+            count += BLOCK_SIZE;
+            continue;
+        }
+        for (int i = 0; i < BLOCK_SIZE; i++, blck_in >>= CHAR_BIT) {
+            const byte_t byte_in = blck_in & 0xFF;
+            /* Un octet nul marque la fin des données. */
+            if (!byte_in) {
+                end = TRUE;
+                break;
+            }
+            if (count && byte_in == byte) {
+                count++;
+                continue;
+            }
+            /* Fin de la répétition précédente (caractère seul dans la
+             * majorité des cas). */
+            if (count == 1 ? rle_fast_put_field(cf, &blck_out, &ind_out, byte,
+                                                CHAR_BIT)
+                : rle_fast_put_run(cf, &blck_out, &ind_out, byte, count))
+                goto error;
+            byte = byte_in;
+            count = 1;
+        }
+    }
+    if (cmpf_get_err(cf) && cmpf_get_err(cf) != ERR_IO_FREAD_EOF)
+        goto error;
+    cmpf_set_err(cf, ERR_NONE);
+    /* Écriture de la dernière répétition et du dernier bloc entamé. */
+    if (rle_fast_put_run(cf, &blck_out, &ind_out, byte, count)
+        || (ind_out && rle_blck_put_last(cf, blck_out << (BLOCK_LENGHT
+                                                          - ind_out))))
+        goto error;
+    return 0;
+
+ error:
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int rle_fast_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    /* Table de décodage indexée par le bit d'identification et le code de
+     * répétition, soit les RLE_FAST_CODE_LENGHT premiers bits d'un champ. */
+    rle_fast_code_s a_codes[1 << RLE_FAST_CODE_LENGHT];
+    for (int i = 0; i < (1 << RLE_FAST_CODE_LENGHT); i++) {
+        a_codes[i].lenght = i >> REP_CODE_LENGHT ? RLE_FAST_REP_LENGHT
+            : CHAR_BIT;
+        a_codes[i].count = i >> REP_CODE_LENGHT ? i & REP_CODE_MAX : 1;
+    }
+
+    /* Fenêtre de lecture sur le bloc courant et le bloc suivant. */
+    block_t blck_hi = 0, blck_lo = 0, blck_out = 0;
+    int ind_in = 0, ind_out = 0;        /* Bits consommés, bits remplis. */
+    int avail = 0;              /* Bits valides restants dans la fenêtre. */
+    if (!cmpf_get_block(cf, &blck_hi))
+        avail += BLOCK_LENGHT;
+    if (avail && !cmpf_get_block(cf, &blck_lo))
+        avail += BLOCK_LENGHT;
+
+    while (avail >= CHAR_BIT) {
+        /* Les 64 prochains bits du flux, alignés sur le bit de poids fort. */
+        const block_t win = (blck_hi << ind_in) | ((blck_lo >> 1) >>
+                                                   (BLOCK_LENGHT - 1 -
+                                                    ind_in));
+        const rle_fast_code_s code =
+            a_codes[win >> (BLOCK_LENGHT - RLE_FAST_CODE_LENGHT)];
+        const byte_t byte = (win >> (BLOCK_LENGHT - code.lenght)) & 0xFF;
+        /* Bourrage de fin de flux : champ tronqué, caractère nul, ou code de
+         * répétition nul. */
+        if (code.lenght > avail || !byte || !code.count)
+            break;
+        if (rle_fast_put_bytes(cf, &blck_out, &ind_out,
+                               (byte * RLE_FAST_BYTE_REPLICATE) >>
+                               (BLOCK_LENGHT - code.count * CHAR_BIT),
+                               code.count * CHAR_BIT))
+            goto error;
+        /* Consommation du champ et rechargement de la fenêtre. */
+        ind_in += code.lenght;
+        avail -= code.lenght;
+        if (ind_in >= BLOCK_LENGHT) {
+            ind_in -= BLOCK_LENGHT;
+            blck_hi = blck_lo;
+            if (!cmpf_get_block(cf, &blck_lo))
+                avail += BLOCK_LENGHT;
+            else
+                blck_lo = 0;
+        }
+    }
+    if (cmpf_get_err(cf) && cmpf_get_err(cf) != ERR_IO_FREAD_EOF)
+        goto error;
+    cmpf_set_err(cf, ERR_NONE);
+    /* Écriture du dernier bloc entamé. */
+    if (ind_out && rle_blck_put_last(cf, blck_out))
+        goto error;
+    return 0;
+
+ error:
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
+}
+
+int rle_bin_compress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    const rle_bin_scan_s *scan = rle_bin_scan_select();
+    rle_bin_encoder_s e = {.cf = cf };
+    byte_t *p_in = malloc(RLE_BIN_BUFFER_SIZE);
+    size_t nb_bytes;
+    if (!p_in || !(e.p_out = malloc(RLE_BIN_BUFFER_SIZE))) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    /* Une répétition peut continuer sur le buffer suivant : les derniers
+     * octets du buffer sont toujours traités comme une répétition. */
+    while ((nb_bytes = cmpf_get_bytes(cf, p_in, RLE_BIN_BUFFER_SIZE))) {
+        const byte_t *p = p_in, *p_end = p_in + nb_bytes;
+        while (p < p_end) {
+            if (e.run_len && *p == e.run_byte) {
+                const size_t len = scan->run_lenght(p, p_end);
+                e.run_len += len, p += len;
+                continue;
+            }
+            if (rle_bin_put_run(&e))
+                goto error;
+            /* Octets littéraux jusqu'à la prochaine répétition, copiés d'un
+             * seul coup. */
+            const byte_t *p_run = scan->run_find(p, p_end);
+            if (p_run != p) {
+                if (rle_bin_put_lits(&e, p, p_run - p))
+                    goto error;
+                p = p_run;
+                continue;
+            }
+            e.run_byte = *p;
+            e.run_len = scan->run_lenght(p, p_end);
+            p += e.run_len;
+        }
+    }
+    /* Écriture de la dernière répétition, des derniers littéraux et du
+     * buffer d'écriture. */
+    if (cmpf_get_err(cf) == ERR_IO_FREAD || rle_bin_put_run(&e)
+        || rle_bin_put_lit(&e) || cmpf_put_bytes(cf, e.p_out, e.out_len))
+        goto error;
+    free(p_in), free(e.p_out);
+    cmpf_set_err(cf, ERR_NONE);
+    return 0;
+
+ error:
+    free(p_in), free(e.p_out);
+    return cmpf_fail(cf, ERR_COMPRESSION_FAILED);
+}
+
+int rle_bin_decompress(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cmpf_set_err(cf, ERR_NONE);
+
+    byte_t *p_in = malloc(RLE_BIN_BUFFER_SIZE);
+    byte_t *p_out = malloc(RLE_BIN_BUFFER_SIZE);
+    size_t in_pos = 0, in_end = 0, out_len = 0;
+    int eof = FALSE;
+    if (!p_in || !p_out) {
+        cmpf_set_err(cf, ERR_OTHER);
+        goto error;
+    }
+
+    while (TRUE) {
+        /* Rechargement du buffer de lecture pour qu'il contienne un paquet
+         * entier. Un paquet tronqué ou une longueur trop grande signifie que
+         * le fichier est corrompu. */
+        if (!eof && in_end - in_pos < RLE_BIN_PACKET_MAX) {
+            memmove(p_in, p_in + in_pos, in_end - in_pos);
+            in_end -= in_pos, in_pos = 0;
+            const size_t size = RLE_BIN_BUFFER_SIZE - in_end;
+            const size_t nb_bytes = cmpf_get_bytes(cf, p_in + in_end, size);
+            in_end += nb_bytes;
+            if (nb_bytes < size) {
+                if (cmpf_get_err(cf) == ERR_IO_FREAD)
+                    goto error;
+                eof = TRUE;
+            }
+        }
+        if (in_pos == in_end)
+            break;
+        const byte_t code = p_in[in_pos++];
+        /* Paquet de littéraux. */
+        if (code < RLE_BIN_CODE_RUN) {
+            const size_t len = code + 1;
+            if (in_end - in_pos < len)
+                goto error;
+            if (out_len + len > RLE_BIN_BUFFER_SIZE) {
+                if (cmpf_put_bytes(cf, p_out, out_len))
+                    goto error;
+                out_len = 0;
+            }
+            memcpy(p_out + out_len, p_in + in_pos, len);
+            out_len += len, in_pos += len;
+            continue;
+        }
+        /* Paquet de répétition. */
+        uint64_t len = code - RLE_BIN_CODE_RUN + RLE_BIN_RUN_MIN;
+        if (code == RLE_BIN_CODE_LONG) {
+            uint64_t extra = 0;
+            int shift = 0;
+            byte_t part;
+            do {
+                if (in_pos == in_end || shift >= 64)
+                    goto error;
+                part = p_in[in_pos++];
+                extra |= (uint64_t) (part & 0x7F) << shift;
+                shift += 7;
+            } while (part & 0x80);
+            if (extra > UINT64_MAX - RLE_BIN_RUN_LONG_MIN)
+                goto error;
+            len = RLE_BIN_RUN_LONG_MIN + extra;
+        }
+        if (in_pos == in_end)
+            goto error;
+        const byte_t byte = p_in[in_pos++];
+        while (len) {
+            if (out_len == RLE_BIN_BUFFER_SIZE) {
+                if (cmpf_put_bytes(cf, p_out, out_len))
+                    goto error;
+                out_len = 0;
+            }
+            const size_t room = RLE_BIN_BUFFER_SIZE - out_len;
+            const size_t size = len < room ? len : room;
+            memset(p_out + out_len, byte, size);
+            out_len += size, len -= size;
+        }
+    }
+    if (cmpf_put_bytes(cf, p_out, out_len))
+        goto error;
+    free(p_in), free(p_out);
+    cmpf_set_err(cf, ERR_NONE);
     return 0;
+
+ error:
+    free(p_in), free(p_out);
+    return cmpf_fail(cf, ERR_DECOMPRESSION_FAILED);
 }
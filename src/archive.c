@@ -0,0 +1,872 @@
+/**
+ * \file archive.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Archives.
+ * \details Module de création et d'extraction des archives, qui regroupent
+ * plusieurs fichiers compressés dans un seul conteneur. Les fichiers sont
+ * compressés et décompressés en parallèle par un groupe de threads.
+ */
+
+/* Fonctionnement : la liste des membres est établie par le thread principal,
+ * puis les threads de travail prennent les membres dans l'ordre et les
+ * traitent entièrement en mémoire. À la création, le thread principal écrit
+ * les membres compressés dans l'ordre, et les threads ne prennent pas plus de
+ * ARC_SLOTS_BY_THREAD membres d'avance par thread sur l'écriture, ce qui
+ * borne la mémoire utilisée. À l'extraction, chaque thread lit les données de
+ * son membre à leur position dans l'archive et écrit lui-même le fichier
+ * extrait. */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "archive.h"
+#include "header.h"
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "codec.h"
+#include "crc32c.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Nombre de membres compressés en avance sur l'écriture, par thread. */
+#define ARC_SLOTS_BY_THREAD 2
+/* Taille d'une entrée de l'index sans le nom en byte. */
+#define ARC_ENTRY_SIZE 27
+/* Longueur des nombres magiques. */
+#define ARC_MAGIC_SIZE 4
+/* Droits des répertoires créés à l'extraction (modifiés par le umask). */
+#define ARC_DIR_MODE (S_IRWXU | S_IRWXG | S_IRWXO)
+
+/* Énumérations privées ===================================================== */
+
+/* États d'un membre. */
+typedef enum arc_state {
+    ARC_WAITING = 0,            /* Membre en attente ou en traitement. */
+    ARC_DONE                    /* Membre traité. */
+} arc_state_e;
+
+/* Structures privées ======================================================= */
+
+/* Membre de l'archive. */
+typedef struct arc_member {
+    char *s_path;               /* Chemin du fichier sur le disque (alloué). */
+    const char *s_name;         /* Nom dans l'archive (fin de "s_path"). */
+    uint64_t offset;            /* Position des données dans l'archive. */
+    uint64_t cmp_size;          /* Taille des données, en-tête et somme de
+                                   contrôle compris. */
+    uint64_t raw_size;          /* Taille du fichier original. */
+    algo_e algo;                /* Algorithme du membre. */
+    byte_t *p_data;             /* Données compressées en attente d'écriture
+                                   (allouées). */
+    size_t data_size;           /* Taille de "p_data". */
+    uint32_t checksum;          /* Somme de contrôle du fichier original. */
+    arc_state_e state;          /* État du membre. */
+    err_code_e err;             /* Erreur du traitement du membre. */
+} arc_member_s;
+
+typedef struct arc_pool arc_pool_s;
+
+/* Groupe de threads et liste des membres partagée. */
+struct arc_pool {
+    pthread_mutex_t mutex;      /* Protège les compteurs et les états. */
+    pthread_cond_t cond_ready;  /* Signalé quand un membre peut être pris. */
+    pthread_cond_t cond_done;   /* Signalé quand un membre est traité. */
+    pthread_t *a_threads;       /* Threads de travail. */
+    int nb_threads;             /* Nombre de threads de travail. */
+    arc_member_s *a_members;    /* Membres, dans l'ordre de l'archive. */
+    size_t nb_members;          /* Nombre de membres. */
+    size_t members_cap;         /* Capacité de "a_members". */
+    size_t nb_taken;            /* Nombre de membres pris par les threads. */
+    size_t nb_written;          /* Nombre de membres écrits (création). */
+    size_t window;              /* Avance maximale des threads sur
+                                   l'écriture. */
+    int stop;                   /* Vrai pour arrêter les threads. */
+    int (*p_task)(const arc_pool_s *, arc_member_s *);  /* Traitement d'un
+                                                           membre. */
+    int fd;                     /* Descripteur de l'archive (extraction). */
+    algo_e algo;                /* Algorithme de compression. */
+    int level;                  /* Niveau de compression. */
+    pipe_spec_s pipe;           /* Chaîne de transformations. */
+    int verify;                 /* Vrai pour vérifier les sommes de contrôle
+                                   (extraction). */
+    err_code_e err;             /* Erreur du traitement de l'archive. */
+    char *s_err_path;           /* Chemin du fichier en cause dans l'erreur
+                                   (alloué), NULL si aucun. */
+};
+
+/* Fonctions privées ======================================================== */
+
+/* # Format ================================================================= */
+
+/* Écris l'entier "val" sur "nb_bytes" bytes en little endian à l'adresse
+ * "p_dest". */
+static void arc_put_le(byte_t * p_dest, const uint64_t val, const int nb_bytes)
+{
+    for (int i = 0; i < nb_bytes; i++)
+        p_dest[i] = (val >> (i * CHAR_BIT)) & 0xFF;
+}
+
+/* Renvoie l'entier sur "nb_bytes" bytes en little endian à l'adresse
+ * "p_src". */
+static uint64_t arc_get_le(const byte_t * p_src, const int nb_bytes)
+{
+    uint64_t val = 0;
+    for (int i = nb_bytes - 1; i >= 0; i--)
+        val = (val << CHAR_BIT) | p_src[i];
+    return val;
+}
+
+/* Renvoie vrai si le nom "s_name" reste dans le répertoire de destination :
+ * non vide, relatif et sans composant "..". */
+static int arc_name_safe(const char *s_name)
+{
+    assert(s_name);
+    if (!*s_name || *s_name == '/')
+        return FALSE;
+    for (const char *s = s_name; s; s = strchr(s, '/')) {
+        s += *s == '/';
+        if (!strncmp(s, "..", 2) && (s[2] == '/' || !s[2]))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Renvoie vrai si le membre de nom "s_name" est sélectionné par "s_sel" : son
+ * nom, ou celui d'un des répertoires qui le contiennent. */
+static int arc_name_match(const char *s_name, const char *s_sel)
+{
+    assert(s_name && s_sel);
+    const size_t len = strlen(s_sel);
+    return !strncmp(s_name, s_sel, len) && (!s_name[len] || s_name[len] == '/'
+                                             || (len && s_sel[len - 1] == '/'));
+}
+
+/* # Liste des membres ====================================================== */
+
+/* Positionne l'erreur de "pool" sur "err", causée par le fichier "s_path".
+ * Renvoie -1. */
+static int arc_fail(arc_pool_s * pool, const err_code_e err,
+                    const char *s_path)
+{
+    assert(pool && s_path);
+    pool->err = err;
+    free(pool->s_err_path);
+    pool->s_err_path = strdup(s_path);
+    return -1;
+}
+
+/* Ajoute à "pool" un membre de chemin "s_path" (alloué, confié au membre),
+ * dont le nom commence à la position "name_pos".
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int arc_add_member(arc_pool_s * pool, char *s_path,
+                          const size_t name_pos)
+{
+    assert(pool && s_path);
+    if (strlen(s_path + name_pos) > ARC_NAME_MAX)
+        return arc_fail(pool, ERR_ARCHIVE, s_path), free(s_path), -1;
+    if (pool->nb_members == pool->members_cap) {
+        const size_t cap = pool->members_cap ? pool->members_cap * 2 : 64;
+        arc_member_s *a_tmp = realloc(pool->a_members,
+                                      cap * sizeof(arc_member_s));
+        if (!a_tmp)
+            return free(s_path), pool->err = ERR_OTHER, -1;
+        pool->a_members = a_tmp;
+        pool->members_cap = cap;
+    }
+    arc_member_s *m = &pool->a_members[pool->nb_members++];
+    memset(m, 0, sizeof(arc_member_s));
+    m->s_path = s_path;
+    m->s_name = s_path + name_pos;
+    m->algo = pool->algo;
+    return 0;
+}
+
+/* Compare deux noms de "qsort". */
+static int arc_cmp_names(const void *p_a, const void *p_b)
+{
+    return strcmp(*(char *const *)p_a, *(char *const *)p_b);
+}
+
+static int arc_add_path(arc_pool_s * pool, char *s_path, size_t name_pos,
+                        const int follow);
+
+/* Ajoute à "pool" les fichiers du répertoire "s_dir", dont le nom commence à
+ * la position "name_pos", dans l'ordre alphabétique.
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int arc_add_dir(arc_pool_s * pool, const char *s_dir,
+                       const size_t name_pos)
+{
+    assert(pool && s_dir);
+    DIR *dir = opendir(s_dir);
+    if (!dir)
+        return arc_fail(pool, ERR_IO_FOPEN, s_dir);
+    /* Noms des entrées, triés pour que l'archive ne dépende pas de l'ordre
+     * du système de fichiers. */
+    char **a_s_names = NULL;
+    size_t nb_names = 0, cap = 0;
+    int ret = 0;
+    for (struct dirent * entry; !ret && (entry = readdir(dir));) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+            continue;
+        if (nb_names == cap) {
+            cap = cap ? cap * 2 : 16;
+            char **a_tmp = realloc(a_s_names, cap * sizeof(char *));
+            if (!a_tmp) {
+                ret = -1;
+                break;
+            }
+            a_s_names = a_tmp;
+        }
+        if (!(a_s_names[nb_names] = strdup(entry->d_name)))
+            ret = -1;
+        else
+            nb_names++;
+    }
+    closedir(dir);
+    if (ret)
+        pool->err = ERR_OTHER;
+    qsort(a_s_names, nb_names, sizeof(char *), arc_cmp_names);
+    /* Un répertoire dont le nom est vide ("." ou "/") donne des noms qui
+     * commencent à ses entrées. */
+    const size_t dir_len = strlen(s_dir);
+    const int slash = dir_len && s_dir[dir_len - 1] == '/';
+    for (size_t i = 0; i < nb_names; i++) {
+        char *s_path = NULL;
+        if (!ret && !(s_path = malloc(dir_len + !slash +
+                                      strlen(a_s_names[i]) + 1)))
+            ret = -1, pool->err = ERR_OTHER;
+        if (!ret) {
+            sprintf(s_path, "%s%s%s", s_dir, slash ? "" : "/", a_s_names[i]);
+            ret = arc_add_path(pool, s_path, name_pos < dir_len ? name_pos
+                               : dir_len + !slash, FALSE);
+        }
+        free(a_s_names[i]);
+    }
+    free(a_s_names);
+    return ret;
+}
+
+/* Ajoute à "pool" le fichier ou le répertoire "s_path" (alloué, confié à la
+ * fonction), dont le nom commence à la position "name_pos". Les liens
+ * symboliques ne sont suivis que si "follow" est vrai ; les liens non suivis
+ * et les fichiers spéciaux sont ignorés.
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int arc_add_path(arc_pool_s * pool, char *s_path, size_t name_pos,
+                        const int follow)
+{
+    assert(pool && s_path);
+    struct stat file_stat;
+    if ((follow ? stat : lstat) (s_path, &file_stat))
+        return arc_fail(pool, ERR_IO_FOPEN, s_path), free(s_path), -1;
+    if (S_ISREG(file_stat.st_mode))
+        return arc_add_member(pool, s_path, name_pos);
+    int ret = 0;
+    if (S_ISDIR(file_stat.st_mode))
+        ret = arc_add_dir(pool, s_path, name_pos);
+    free(s_path);
+    return ret;
+}
+
+/* Compare deux membres de "qsort" par leur nom, puis par leur position dans
+ * la liste. */
+static int arc_cmp_members(const void *p_a, const void *p_b)
+{
+    const arc_member_s *m_a = *(const arc_member_s * const *)p_a;
+    const arc_member_s *m_b = *(const arc_member_s * const *)p_b;
+    const int cmp = strcmp(m_a->s_name, m_b->s_name);
+    return cmp ? cmp : (m_a > m_b) - (m_a < m_b);
+}
+
+/* Vérifie que les membres de "pool" ont des noms distincts : un même fichier
+ * donné deux fois, ou deux chemins identiques une fois "/", "./" et "../"
+ * retirés, donneraient des membres qui s'écrasent à l'extraction.
+ * Renvoie 0 sur un succès, -1 sur une erreur (ERR_ARCHIVE, causée par le
+ * second chemin). */
+static int arc_check_unique(arc_pool_s * pool)
+{
+    assert(pool);
+    if (pool->nb_members < 2)
+        return 0;
+    const arc_member_s **a_sorted = malloc(pool->nb_members *
+                                           sizeof(arc_member_s *));
+    if (!a_sorted)
+        return pool->err = ERR_OTHER, -1;
+    for (size_t i = 0; i < pool->nb_members; i++)
+        a_sorted[i] = &pool->a_members[i];
+    qsort(a_sorted, pool->nb_members, sizeof(arc_member_s *),
+          arc_cmp_members);
+    int ret = 0;
+    for (size_t i = 1; !ret && i < pool->nb_members; i++)
+        if (!strcmp(a_sorted[i - 1]->s_name, a_sorted[i]->s_name))
+            ret = arc_fail(pool, ERR_ARCHIVE, a_sorted[i]->s_path);
+    free(a_sorted);
+    return ret;
+}
+
+/* Libère les membres de "pool". */
+static void arc_free_members(arc_pool_s * pool)
+{
+    assert(pool);
+    for (size_t i = 0; i < pool->nb_members; i++)
+        free(pool->a_members[i].s_path), free(pool->a_members[i].p_data);
+    free(pool->a_members);
+    pool->a_members = NULL;
+    pool->nb_members = pool->members_cap = 0;
+}
+
+/* # Traitement des membres ================================================= */
+
+/* Charge le fichier du membre "m" en mémoire dans "*pp_data" (alloué) de
+ * taille "*p_size".
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "m". */
+static int arc_load(arc_member_s * m, byte_t ** pp_data, size_t * p_size)
+{
+    assert(m && pp_data && p_size);
+    const char *s_path = m->s_path;
+    *pp_data = NULL, *p_size = 0;
+    FILE *fp = fopen(s_path, "rb");
+    if (!fp)
+        return m->err = ERR_IO_FOPEN, -1;
+    struct stat file_stat;
+    int ret = 0;
+    if (fstat(fileno(fp), &file_stat))
+        ret = -1, m->err = ERR_IO_FREAD;
+    else if (file_stat.st_size
+             && !(*pp_data = malloc(file_stat.st_size)))
+        ret = -1, m->err = ERR_OTHER;
+    else if (file_stat.st_size) {
+        /* Un fichier raccourci pendant la lecture est archivé tel quel. */
+        *p_size = fread(*pp_data, sizeof(byte_t), file_stat.st_size, fp);
+        if (ferror(fp))
+            ret = -1, m->err = ERR_IO_FREAD;
+    }
+    fclose(fp);
+    if (ret)
+        free(*pp_data), *pp_data = NULL;
+    return ret;
+}
+
+/* Compresse le fichier du membre "m" en mémoire avec l'algorithme et au
+ * niveau de "pool", et calcule sa somme de contrôle.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "m". */
+static int arc_compress_member(const arc_pool_s * pool, arc_member_s * m)
+{
+    assert(pool && m);
+    byte_t *p_in;
+    size_t in_size;
+    if (arc_load(m, &p_in, &in_size))
+        return -1;
+    codec_ctx_s ctx;
+    codec_init(&ctx, MODE_COMPRESS, m->algo, pool->level);
+    ctx.pipe = pool->pipe;
+    const int ret = codec_run_mem(&ctx, p_in, in_size, CODEC_SIZE_UNKNOWN,
+                                  &m->p_data, &m->data_size);
+    m->checksum = crc32c_update(CRC32C_INIT, p_in, in_size);
+    free(p_in);
+    m->raw_size = in_size;
+    /* Algorithme retenu pour le membre en choix automatique. */
+    m->algo = ctx.algo;
+    m->err = ctx.err;
+    return ret;
+}
+
+/* Crée les répertoires parents du fichier "s_path", au-delà des "skip"
+ * premiers caractères (répertoire de destination déjà créé).
+ * Renvoie 0 sur un succès, -1 si un répertoire ne peut pas être créé. */
+static int arc_mkdirs(char *s_path, const size_t skip)
+{
+    assert(s_path && skip <= strlen(s_path));
+    for (char *s = strchr(s_path + skip, '/'); s; s = strchr(s + 1, '/')) {
+        /* Racine d'un chemin absolu, ou "//". */
+        if (s == s_path || s[-1] == '/')
+            continue;
+        *s = '\0';
+        const int ret = mkdir(s_path, ARC_DIR_MODE) && errno != EEXIST;
+        *s = '/';
+        if (ret)
+            return -1;
+    }
+    return 0;
+}
+
+/* Lit les données du membre "m" dans l'archive de "pool", les décompresse en
+ * mémoire, vérifie leur somme de contrôle si "pool" le demande et écris le
+ * fichier extrait.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "m". */
+static int arc_extract_member(const arc_pool_s * pool, arc_member_s * m)
+{
+    assert(pool && m);
+    /* Lecture des seules données du membre. */
+    byte_t *p_in = malloc(m->cmp_size ? m->cmp_size : 1);
+    if (!p_in)
+        return m->err = ERR_OTHER, -1;
+    size_t done = 0;
+    while (done < m->cmp_size) {
+        const ssize_t nb_bytes = pread(pool->fd, p_in + done,
+                                       m->cmp_size - done, m->offset + done);
+        if (nb_bytes < 0 && errno == EINTR)
+            continue;
+        if (nb_bytes <= 0)
+            break;
+        done += nb_bytes;
+    }
+    /* L'en-tête du membre doit correspondre à son entrée dans l'index. */
+    header_s hdr;
+    int len = done == m->cmp_size ? hdr_decode(&hdr, p_in, done) : -1;
+    if (len <= 0 || hdr.algo != m->algo || hdr.flags & HDR_FLAG_PARALLEL
+        || !(hdr.flags & HDR_FLAG_SIZE) || hdr.size != m->raw_size)
+        return free(p_in), m->err = ERR_ARCHIVE, -1;
+    /* Somme de contrôle du fichier original après les données. */
+    size_t in_size = done - len;
+    uint32_t checksum = 0;
+    if (hdr.flags & HDR_FLAG_CHECKSUM) {
+        if (in_size < HDR_TRAILER_SIZE)
+            return free(p_in), m->err = ERR_CHECKSUM, -1;
+        in_size -= HDR_TRAILER_SIZE;
+        checksum = hdr_decode_trailer(p_in + len + in_size);
+    }
+    byte_t *p_out;
+    size_t out_size;
+    codec_ctx_s ctx;
+    codec_init(&ctx, MODE_DECOMPRESS, hdr.algo, 0);
+    int ret = codec_run_mem(&ctx, p_in + len, in_size, hdr.size, &p_out,
+                            &out_size);
+    free(p_in);
+    if (ret)
+        return m->err = ctx.err, -1;
+    if (hdr.flags & HDR_FLAG_CHECKSUM && pool->verify
+        && crc32c_update(CRC32C_INIT, p_out, out_size) != checksum)
+        return free(p_out), m->err = ERR_CHECKSUM, -1;
+    /* Écriture du fichier extrait. */
+    FILE *fp = NULL;
+    if (arc_mkdirs(m->s_path, m->s_name - m->s_path))
+        ret = -1, m->err = ERR_IO_FOPEN;
+    else if (!(fp = fopen(m->s_path, "wb")))
+        ret = -1, m->err = ERR_IO_FOPEN;
+    else if (fwrite(p_out, sizeof(byte_t), out_size, fp) != out_size)
+        ret = -1, m->err = ERR_IO_FWRITE;
+    if (fp && fclose(fp) && !ret)
+        ret = -1, m->err = ERR_IO_FCLOSE;
+    free(p_out);
+    return ret;
+}
+
+/* # Groupe de threads ====================================================== */
+
+/* Boucle d'un thread de travail : prend les membres dans l'ordre, sans
+ * dépasser l'avance permise sur l'écriture, jusqu'au dernier ou jusqu'à
+ * l'arrêt du groupe. Le traitement positionne l'erreur de son membre, que le
+ * thread principal ne lit qu'une fois le membre traité. */
+static void *arc_worker(void *p_arg)
+{
+    arc_pool_s *pool = p_arg;
+    pthread_mutex_lock(&pool->mutex);
+    while (TRUE) {
+        while (!pool->stop && pool->nb_taken < pool->nb_members
+               && pool->nb_taken >= pool->nb_written + pool->window)
+            pthread_cond_wait(&pool->cond_ready, &pool->mutex);
+        if (pool->stop || pool->nb_taken == pool->nb_members)
+            break;
+        arc_member_s *m = &pool->a_members[pool->nb_taken++];
+        pthread_mutex_unlock(&pool->mutex);
+        if (pool->p_task(pool, m) && !m->err)
+            m->err = ERR_OTHER;
+        pthread_mutex_lock(&pool->mutex);
+        m->state = ARC_DONE;
+        pthread_cond_broadcast(&pool->cond_done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+static void arc_pool_stop(arc_pool_s * pool);
+
+/* Démarre "nb_threads" threads de travail sur les membres de "pool" avec le
+ * traitement "p_task" et l'avance "window".
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "pool". */
+static int arc_pool_start(arc_pool_s * pool, const int nb_threads,
+                          int (*p_task)(const arc_pool_s *, arc_member_s *),
+                          const size_t window)
+{
+    assert(pool && nb_threads > 0 && p_task);
+    pool->p_task = p_task;
+    pool->window = window;
+    pool->nb_taken = pool->nb_written = 0;
+    pool->stop = FALSE;
+    if (!(pool->a_threads = calloc(nb_threads, sizeof(pthread_t))))
+        return pool->err = ERR_OTHER, -1;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond_ready, NULL);
+    pthread_cond_init(&pool->cond_done, NULL);
+    for (pool->nb_threads = 0; pool->nb_threads < nb_threads;
+         pool->nb_threads++) {
+        if (pthread_create(&pool->a_threads[pool->nb_threads], NULL,
+                           arc_worker, pool))
+            return pool->err = ERR_OTHER, arc_pool_stop(pool), -1;
+    }
+    return 0;
+}
+
+/* Attend que le membre "m" de "pool" soit traité.
+ * Renvoie 0 si son traitement a réussi, -1 sinon et positionne l'erreur de
+ * "pool" sur celle du membre, causée par son fichier. */
+static int arc_pool_wait(arc_pool_s * pool, const arc_member_s * m)
+{
+    assert(pool && m);
+    pthread_mutex_lock(&pool->mutex);
+    while (m->state != ARC_DONE)
+        pthread_cond_wait(&pool->cond_done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+    return m->err ? arc_fail(pool, m->err, m->s_path) : 0;
+}
+
+/* Arrête les threads de "pool" une fois leur membre en cours traité, et
+ * libère les ressources du groupe. */
+static void arc_pool_stop(arc_pool_s * pool)
+{
+    assert(pool);
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = TRUE;
+    pthread_cond_broadcast(&pool->cond_ready);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->nb_threads; i++)
+        pthread_join(pool->a_threads[i], NULL);
+    pthread_cond_destroy(&pool->cond_done);
+    pthread_cond_destroy(&pool->cond_ready);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->a_threads), pool->a_threads = NULL;
+    pool->nb_threads = 0;
+}
+
+/* Termine le traitement de "pool" de résultat "ret" : positionne "err" de
+ * "ctx", confie à "*ps_err_path" (si demandé) le chemin en cause dans
+ * l'erreur et libère les membres.
+ * Renvoie "ret". */
+static int arc_finish(arc_pool_s * pool, codec_ctx_s * ctx, const int ret,
+                      char **ps_err_path)
+{
+    assert(pool && ctx);
+    ctx->err = ret ? pool->err : ERR_NONE;
+    if (ps_err_path && ret)
+        *ps_err_path = pool->s_err_path;
+    else
+        free(pool->s_err_path);
+    pool->s_err_path = NULL;
+    arc_free_members(pool);
+    return ret;
+}
+
+/* # Création =============================================================== */
+
+/* Écris les "size" bytes de "p_src" sur "fp".
+ * Renvoie 0 sur un succès, -1 sur une erreur d'écriture. */
+static int arc_fwrite(const void *p_src, const size_t size, FILE * fp)
+{
+    if (fwrite(p_src, sizeof(byte_t), size, fp) != size)
+        return -1;
+    return 0;
+}
+
+/* Écris le membre compressé "m" à la position "*p_offset" de l'archive "fp",
+ * précédé de son en-tête et suivi de sa somme de contrôle, libère ses données
+ * et avance "*p_offset".
+ * Renvoie 0 sur un succès, -1 sur une erreur d'écriture. */
+static int arc_write_member(arc_member_s * m, FILE * fp, uint64_t * p_offset)
+{
+    assert(m && fp && p_offset);
+    header_s hdr;
+    byte_t a_hdr[HDR_SIZE_MAX], a_trailer[HDR_TRAILER_SIZE];
+    hdr_init(&hdr, m->algo);
+    hdr.flags |= HDR_FLAG_SIZE | HDR_FLAG_CHECKSUM;
+    hdr.size = m->raw_size;
+    const size_t hdr_size = hdr_encode(&hdr, a_hdr);
+    hdr_encode_trailer(a_trailer, m->checksum);
+    if (arc_fwrite(a_hdr, hdr_size, fp)
+        || arc_fwrite(m->p_data, m->data_size, fp)
+        || arc_fwrite(a_trailer, HDR_TRAILER_SIZE, fp))
+        return -1;
+    m->offset = *p_offset;
+    m->cmp_size = hdr_size + m->data_size + HDR_TRAILER_SIZE;
+    *p_offset += m->cmp_size;
+    free(m->p_data), m->p_data = NULL;
+    return 0;
+}
+
+/* Écris l'index des membres de "pool", positionné à "offset", et la fin de
+ * l'archive sur "fp".
+ * Renvoie 0 sur un succès, -1 sur une erreur d'écriture. */
+static int arc_write_index(const arc_pool_s * pool, FILE * fp,
+                           const uint64_t offset)
+{
+    assert(pool && fp);
+    byte_t a_buf[ARC_ENTRY_SIZE];
+    for (size_t i = 0; i < pool->nb_members; i++) {
+        const arc_member_s *m = &pool->a_members[i];
+        const size_t len = strlen(m->s_name);
+        arc_put_le(a_buf, m->offset, 8);
+        arc_put_le(a_buf + 8, m->cmp_size, 8);
+        arc_put_le(a_buf + 16, m->raw_size, 8);
+        a_buf[24] = m->algo;
+        arc_put_le(a_buf + 25, len, 2);
+        if (arc_fwrite(a_buf, ARC_ENTRY_SIZE, fp)
+            || arc_fwrite(m->s_name, len, fp))
+            return -1;
+    }
+    arc_put_le(a_buf, offset, 8);
+    arc_put_le(a_buf + 8, pool->nb_members, 4);
+    memcpy(a_buf + 12, ARC_INDEX_MAGIC, ARC_MAGIC_SIZE);
+    return arc_fwrite(a_buf, ARC_TRAILER_SIZE, fp);
+}
+
+/* # Extraction ============================================================= */
+
+/* Lit la fin et l'index de l'archive "fp", et ajoute à "pool" les membres
+ * dont le nom est dans "a_s_names" (ou tous si "a_s_names" est NULL), avec
+ * leur chemin dans le répertoire "s_dir". Les erreurs d'un index invalide
+ * sont causées par l'archive "s_archive".
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de
+ * "pool". */
+static int arc_read_index(arc_pool_s * pool, FILE * fp,
+                          const char *s_archive, const char *s_dir,
+                          char *const *a_s_names, const int nb_names)
+{
+    assert(pool && fp && s_archive && s_dir);
+    /* En-tête, puis fin de l'archive qui donne la position de l'index. */
+    byte_t a_buf[ARC_ENTRY_SIZE + ARC_NAME_MAX + 1];
+    off_t end;
+    if (fread(a_buf, sizeof(byte_t), ARC_HEADER_SIZE, fp) != ARC_HEADER_SIZE
+        || memcmp(a_buf, ARC_MAGIC, ARC_MAGIC_SIZE) || a_buf[4] != ARC_VERSION
+        || fseeko(fp, -ARC_TRAILER_SIZE, SEEK_END) || (end = ftello(fp)) < 0
+        || fread(a_buf, sizeof(byte_t), ARC_TRAILER_SIZE, fp)
+        != ARC_TRAILER_SIZE
+        || memcmp(a_buf + 12, ARC_INDEX_MAGIC, ARC_MAGIC_SIZE))
+        return arc_fail(pool, ERR_ARCHIVE, s_archive);
+    const uint64_t index = arc_get_le(a_buf, 8);
+    uint32_t nb_entries = arc_get_le(a_buf + 8, 4);
+    if (index < ARC_HEADER_SIZE || index > (uint64_t) end
+        || fseeko(fp, index, SEEK_SET))
+        return arc_fail(pool, ERR_ARCHIVE, s_archive);
+    /* Entrées de l'index. */
+    const size_t dir_len = strlen(s_dir);
+    const int slash = dir_len && s_dir[dir_len - 1] == '/';
+    for (; nb_entries; nb_entries--) {
+        if (fread(a_buf, sizeof(byte_t), ARC_ENTRY_SIZE, fp) != ARC_ENTRY_SIZE)
+            return arc_fail(pool, ERR_ARCHIVE, s_archive);
+        const uint64_t offset = arc_get_le(a_buf, 8);
+        const uint64_t cmp_size = arc_get_le(a_buf + 8, 8);
+        const uint64_t raw_size = arc_get_le(a_buf + 16, 8);
+        const algo_e algo = a_buf[24];
+        const size_t len = arc_get_le(a_buf + 25, 2);
+        char *s_name = (char *)a_buf + ARC_ENTRY_SIZE;
+        if (len > ARC_NAME_MAX || fread(s_name, sizeof(byte_t), len, fp) != len
+            || offset < ARC_HEADER_SIZE || offset > index
+            || cmp_size > index - offset || cmp_size > SIZE_MAX
+            || raw_size > SIZE_MAX || algo <= ALGO_NONE || algo >= ALGO_NB)
+            return arc_fail(pool, ERR_ARCHIVE, s_archive);
+        s_name[len] = '\0';
+        if (memchr(s_name, '\0', len) || !arc_name_safe(s_name))
+            return arc_fail(pool, ERR_ARCHIVE, s_archive);
+        /* Sélection : le nom d'un membre, ou d'un de ses répertoires. */
+        int selected = !a_s_names;
+        for (int i = 0; !selected && i < nb_names; i++)
+            selected = arc_name_match(s_name, a_s_names[i]);
+        if (!selected)
+            continue;
+        char *s_path = malloc(dir_len + !slash + len + 1);
+        if (!s_path)
+            return pool->err = ERR_OTHER, -1;
+        sprintf(s_path, "%s%s%s", s_dir, slash ? "" : "/", s_name);
+        if (arc_add_member(pool, s_path, dir_len + !slash))
+            return -1;
+        arc_member_s *m = &pool->a_members[pool->nb_members - 1];
+        m->offset = offset;
+        m->cmp_size = cmp_size;
+        m->raw_size = raw_size;
+        m->algo = algo;
+    }
+    return 0;
+}
+
+/* Vérifie que chacun des "nb_names" noms de "a_s_names" a sélectionné au
+ * moins un membre de "pool".
+ * Renvoie 0 sur un succès, -1 sinon et positionne l'erreur de "pool". */
+static int arc_check_names(arc_pool_s * pool, char *const *a_s_names,
+                           const int nb_names)
+{
+    assert(pool);
+    for (int i = 0; i < nb_names; i++) {
+        size_t j = 0;
+        while (j < pool->nb_members
+               && !arc_name_match(pool->a_members[j].s_name, a_s_names[i]))
+            j++;
+        if (j == pool->nb_members)
+            return arc_fail(pool, ERR_ARCHIVE_MEMBER, a_s_names[i]);
+    }
+    return 0;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int arc_create(const char *s_archive, char *const *a_s_paths,
+               const int nb_paths, codec_ctx_s * ctx, const int nb_threads,
+               char **ps_err_path)
+{
+    if (ps_err_path)
+        *ps_err_path = NULL;
+    if (!ctx)
+        return -1;
+    if (!s_archive || (!a_s_paths && nb_paths))
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    assert(nb_threads > 0);
+    const uint64_t start = io_time_ns();
+    arc_pool_s pool;
+    memset(&pool, 0, sizeof(arc_pool_s));
+    pool.algo = ctx->algo;
+    pool.level = ctx->level;
+    pool.pipe = ctx->pipe;
+    /* Liste des membres. Les noms ne commencent pas par "/", "./" ou
+     * "../". */
+    for (int i = 0; i < nb_paths; i++) {
+        size_t name_pos = 0;
+        const char *s = a_s_paths[i];
+        while (TRUE) {
+            if (s[name_pos] == '/')
+                name_pos++;
+            else if (!strncmp(s + name_pos, "./", 2))
+                name_pos += 2;
+            else if (!strncmp(s + name_pos, "../", 3))
+                name_pos += 3;
+            else
+                break;
+        }
+        char *s_path = strdup(s);
+        if (!s_path)
+            return pool.err = ERR_OTHER,
+                arc_finish(&pool, ctx, -1, ps_err_path);
+        if (arc_add_path(&pool, s_path, name_pos, TRUE))
+            return arc_finish(&pool, ctx, -1, ps_err_path);
+    }
+    if (arc_check_unique(&pool))
+        return arc_finish(&pool, ctx, -1, ps_err_path);
+    FILE *fp = io_fopen(s_archive, "wb");
+    if (!fp)
+        return arc_fail(&pool, ERR_IO_FOPEN, s_archive),
+            arc_finish(&pool, ctx, -1, ps_err_path);
+    /* En-tête, puis membres écrits dans l'ordre dès qu'ils sont compressés. */
+    byte_t a_hdr[ARC_HEADER_SIZE] = { 0 };
+    memcpy(a_hdr, ARC_MAGIC, ARC_MAGIC_SIZE);
+    a_hdr[4] = ARC_VERSION;
+    uint64_t offset = ARC_HEADER_SIZE, write_ns = 0;
+    int ret = arc_fwrite(a_hdr, ARC_HEADER_SIZE, fp);
+    if (ret)
+        arc_fail(&pool, ERR_IO_FWRITE, s_archive);
+    if (!ret && pool.nb_members) {
+        ret = arc_pool_start(&pool, nb_threads < (int)pool.nb_members
+                             ? nb_threads : (int)pool.nb_members,
+                             arc_compress_member,
+                             (size_t)nb_threads * ARC_SLOTS_BY_THREAD);
+        for (size_t i = 0; !ret && i < pool.nb_members; i++) {
+            arc_member_s *m = &pool.a_members[i];
+            if (arc_pool_wait(&pool, m))
+                ret = -1;
+            else {
+                const uint64_t write_start = io_time_ns();
+                if ((ret = arc_write_member(m, fp, &offset)))
+                    arc_fail(&pool, ERR_IO_FWRITE, s_archive);
+                write_ns += io_time_ns() - write_start;
+                ctx->in_total += m->raw_size;
+                ctx->out_total += m->cmp_size;
+            }
+            /* Le membre écrit libère une place d'avance aux threads. */
+            pthread_mutex_lock(&pool.mutex);
+            pool.nb_written++;
+            pthread_cond_broadcast(&pool.cond_ready);
+            pthread_mutex_unlock(&pool.mutex);
+        }
+        if (pool.a_threads)
+            arc_pool_stop(&pool);
+    }
+    const uint64_t write_start = io_time_ns();
+    if (!ret && (ret = arc_write_index(&pool, fp, offset)))
+        arc_fail(&pool, ERR_IO_FWRITE, s_archive);
+    if (fclose(fp) && !ret)
+        ret = arc_fail(&pool, ERR_IO_FCLOSE, s_archive);
+    write_ns += io_time_ns() - write_start;
+    ctx->write_ns += write_ns;
+    ctx->codec_ns += io_time_ns() - start - write_ns;
+    return arc_finish(&pool, ctx, ret, ps_err_path);
+}
+
+int arc_extract(const char *s_archive, const char *s_dir,
+                char *const *a_s_names, const int nb_names,
+                codec_ctx_s * ctx, const int nb_threads, char **ps_err_path)
+{
+    if (ps_err_path)
+        *ps_err_path = NULL;
+    if (!ctx)
+        return -1;
+    if (!s_archive || !s_dir || (!a_s_names && nb_names))
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    assert(nb_threads > 0);
+    const uint64_t start = io_time_ns();
+    arc_pool_s pool;
+    memset(&pool, 0, sizeof(arc_pool_s));
+    FILE *fp = fopen(s_archive, "rb");
+    if (!fp)
+        return arc_fail(&pool, ERR_IO_FOPEN, s_archive),
+            arc_finish(&pool, ctx, -1, ps_err_path);
+    /* Seuls l'index et les membres demandés sont lus. Le répertoire de
+     * destination est créé avec ses parents. */
+    char *s_root = malloc(strlen(s_dir) + 2);
+    if (s_root)
+        sprintf(s_root, "%s/", s_dir);
+    else
+        pool.err = ERR_OTHER;
+    int ret = !s_root || arc_read_index(&pool, fp, s_archive, s_dir, nb_names
+                                        ? a_s_names : NULL, nb_names)
+        || arc_check_names(&pool, a_s_names, nb_names) ? -1 : 0;
+    if (!ret && arc_mkdirs(s_root, 0))
+        ret = arc_fail(&pool, ERR_IO_FOPEN, s_dir);
+    if (ret)
+        return free(s_root), fclose(fp),
+            arc_finish(&pool, ctx, -1, ps_err_path);
+    free(s_root);
+    const uint64_t read_ns = io_time_ns() - start;
+    pool.fd = fileno(fp);
+    pool.verify = ctx->verify;
+    if (pool.nb_members) {
+        ret = arc_pool_start(&pool, nb_threads < (int)pool.nb_members
+                             ? nb_threads : (int)pool.nb_members,
+                             arc_extract_member, pool.nb_members);
+        for (size_t i = 0; !ret && i < pool.nb_members; i++) {
+            arc_member_s *m = &pool.a_members[i];
+            if (arc_pool_wait(&pool, m))
+                ret = -1;
+            ctx->in_total += m->cmp_size;
+            ctx->out_total += m->raw_size;
+        }
+        if (pool.a_threads)
+            arc_pool_stop(&pool);
+    }
+    fclose(fp);
+    ctx->read_ns += read_ns;
+    ctx->codec_ns += io_time_ns() - start - read_ns;
+    return arc_finish(&pool, ctx, ret, ps_err_path);
+}
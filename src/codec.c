@@ -0,0 +1,467 @@
+/**
+ * \file codec.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Codecs.
+ * \details Module d'aiguillage vers les algorithmes de compression, sur un
+ * couple de fichiers ou directement sur des zones mémoires.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "codec.h"
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "algo_rle.h"
+#include "algo_huffman.h"
+#include "algo_lz.h"
+#include "algo_ans.h"
+#include "algo_bwt.h"
+#include "algo_pipe.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Nombre de tranches de l'échantillon de codec_pick. */
+#define CODEC_SAMPLE_SLICES 4
+/* Taille d'une tranche de l'échantillon en byte. */
+#define CODEC_SAMPLE_SLICE (16 * 1024)
+/* Nombre de bits de hachage de l'estimation de LZ. */
+#define CODEC_LZ_HASH_BITS 12
+/* Longueur minimale d'une correspondance de LZ. */
+#define CODEC_LZ_MIN_MATCH 4
+/* Décalage du nombre d'échecs consécutifs de l'estimation de LZ qui donne le
+ * pas supplémentaire de la recherche (comme LZ_SKIP_SHIFT de LZ). */
+#define CODEC_LZ_SKIP_SHIFT 5
+/* Taille de l'en-tête du codage de Huffman (taille originale et longueurs des
+ * codes) en byte. */
+#define CODEC_HUFFMAN_HEADER 136
+/* Longueur d'une répétition de RLE-BIN à partir de laquelle un entier de
+ * longueur variable est ajouté. */
+#define CODEC_RLE_LONG_MIN 130
+/* Taux minimal (en centièmes) en dessous duquel les données sont jugées
+ * incompressibles. */
+#define CODEC_AUTO_RATIO_MIN 105
+/* Taille du buffer de recopie des données stockées. */
+#define CODEC_COPY_SIZE (64 * 1024)
+/* Part du meilleur taux estimé (en pourcentage) qu'un algorithme plus rapide
+ * doit atteindre pour être choisi. */
+#define CODEC_AUTO_SHARE 85
+
+/* Fonctions privées ======================================================== */
+
+/* # Choix de l'algorithme ================================================== */
+
+/* Renvoie le logarithme en base 2 de "x" (>= 1) en 256èmes de bit. */
+static uint32_t codec_log2(const uint32_t x)
+{
+    assert(x);
+    const int exp = 31 - __builtin_clz(x);
+    /* Mantisse dans [1, 2[ en virgule fixe sur 16 bits, dont chaque mise au
+     * carré donne un bit de la partie fractionnaire. */
+    uint64_t mant = ((uint64_t) x << 16) >> exp;
+    uint32_t log = exp << 8;
+    for (int bit = 7; bit >= 0; bit--) {
+        mant = (mant * mant) >> 16;
+        if (mant >= 2 << 16) {
+            log |= 1 << bit;
+            mant >>= 1;
+        }
+    }
+    return log;
+}
+
+/* Renvoie la taille estimée par RLE-BIN des "size" bytes de "p_src" : un byte
+ * de contrôle par paquet de 128 littéraux, deux bytes par répétition. */
+static uint64_t codec_cost_rle(const byte_t * p_src, const size_t size)
+{
+    uint64_t cost = 0, nb_lits = 0;
+    size_t i = 0;
+    while (i < size) {
+        size_t len = 1;
+        while (i + len < size && p_src[i + len] == p_src[i])
+            len++;
+        if (len < 3)
+            nb_lits += len;
+        else {
+            cost += nb_lits + (nb_lits + 127) / 128 + 2;
+            nb_lits = 0;
+            for (size_t rest = len; rest >= CODEC_RLE_LONG_MIN; rest >>= 7)
+                cost++;
+        }
+        i += len;
+    }
+    return cost + nb_lits + (nb_lits + 127) / 128;
+}
+
+/* Renvoie le hachage des CODEC_LZ_MIN_MATCH bytes à l'adresse "p_src". */
+static uint32_t codec_lz_hash(const byte_t * p_src)
+{
+    uint32_t seq;
+    memcpy(&seq, p_src, sizeof(seq));
+    return (seq * 2654435761u) >> (32 - CODEC_LZ_HASH_BITS);
+}
+
+/* Renvoie la taille estimée par LZ des "size" bytes de "p_src", par un
+ * découpage glouton avec une seule position par hachage : un jeton et une
+ * distance par correspondance, et les littéraux. Les données sans
+ * correspondance sont parcourues à pas croissant. */
+static uint64_t codec_cost_lz(const byte_t * p_src, const size_t size)
+{
+    uint16_t a_table[1 << CODEC_LZ_HASH_BITS] = { 0 };
+    uint64_t cost = 1;
+    size_t i = 0, nb_misses = 0;
+    assert(size < UINT16_MAX);
+    while (i + CODEC_LZ_MIN_MATCH <= size) {
+        const uint32_t hash = codec_lz_hash(p_src + i);
+        /* Positions décalées de 1 : 0 indique une entrée vide. */
+        const size_t cand = a_table[hash];
+        a_table[hash] = i + 1;
+        if (!cand || memcmp(p_src + cand - 1, p_src + i, CODEC_LZ_MIN_MATCH)) {
+            const size_t step = 1 + (nb_misses++ >> CODEC_LZ_SKIP_SHIFT);
+            cost += step, i += step;
+            continue;
+        }
+        nb_misses = 0;
+        size_t len = CODEC_LZ_MIN_MATCH;
+        while (i + len < size && p_src[cand - 1 + len] == p_src[i + len])
+            len++;
+        cost += 3;
+        /* Les positions de la correspondance restent des candidates. */
+        const size_t end = i + len;
+        for (i++; i < end && i + CODEC_LZ_MIN_MATCH <= size; i++)
+            a_table[codec_lz_hash(p_src + i)] = i + 1;
+        i = end;
+    }
+    return i < size ? cost + size - i : cost - (i - size);
+}
+
+/* Renvoie la taille estimée par le codage de Huffman, en 256èmes de bit, des
+ * bytes dont l'histogramme est "a_counts" et le nombre "size" : l'entropie
+ * d'ordre 0, avec au moins un bit par byte. */
+static uint64_t codec_cost_huffman(const uint32_t * a_counts,
+                                   const uint32_t size)
+{
+    const uint32_t log_size = codec_log2(size);
+    uint64_t cost = 0;
+    for (int c = 0; c <= UINT8_MAX; c++) {
+        if (!a_counts[c])
+            continue;
+        const uint32_t bits = log_size - codec_log2(a_counts[c]);
+        cost += (uint64_t) a_counts[c] * (bits < 256 ? 256 : bits);
+    }
+    return cost;
+}
+
+/* # Traitement ============================================================= */
+
+/* Recopie le fichier entrant de "cf" sur le fichier sortant (données
+ * stockées, dans les deux sens).
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de "cf"
+ * sur l'erreur correspondante. */
+static int codec_copy(cmp_file_s * cf)
+{
+    byte_t a_buf[CODEC_COPY_SIZE];
+    size_t nb_bytes;
+    cmpf_set_err(cf, ERR_NONE);
+    while ((nb_bytes = cmpf_get_bytes(cf, a_buf, CODEC_COPY_SIZE)))
+        if (cmpf_put_bytes(cf, a_buf, nb_bytes))
+            return -1;
+    return cmpf_get_err(cf) == ERR_IO_FREAD ? -1 : 0;
+}
+
+/* # Registre =============================================================== */
+
+/* Réglages et compressions des algorithmes qui en ont, au format des
+ * descriptions du registre. */
+
+/* Lit le niveau de compression de LZ, de "1" à "9" (NULL : niveau par
+ * défaut, résolu ici pour que les statistiques donnent le niveau effectif). */
+static int codec_lz_parse(codec_ctx_s * ctx, const char *s_arg, char *s_err,
+                          const size_t err_size)
+{
+    if (!s_arg) {
+        ctx->level = LZ_LEVEL_DEFAULT;
+        return 0;
+    }
+    if (s_arg[0] < '1' || s_arg[0] > '9' || s_arg[1]) {
+        if (s_err && err_size)
+            snprintf(s_err, err_size, "niveau \"%s\" invalide (entier de 1 "
+                     "à 9)", s_arg);
+        return -1;
+    }
+    ctx->level = s_arg[0] - '0';
+    return 0;
+}
+
+static int codec_lz_compress(cmp_file_s * cf, const codec_ctx_s * ctx)
+{
+    return lz_compress(cf, ctx->level);
+}
+
+/* Lit la chaîne de transformations, obligatoire. */
+static int codec_pipe_parse(codec_ctx_s * ctx, const char *s_arg,
+                            char *s_err, const size_t err_size)
+{
+    return pipe_parse(s_arg, &ctx->pipe, s_err, err_size);
+}
+
+static int codec_pipe_compress(cmp_file_s * cf, const codec_ctx_s * ctx)
+{
+    return pipe_compress(cf, &ctx->pipe);
+}
+
+/* Registre des algorithmes, indexé par leur identifiant. Le choix automatique
+ * n'a pas de fonctions : codec_run_mem le remplace par l'algorithme choisi
+ * pour chaque bloc. */
+static const codec_desc_s CODEC_REGISTRY[ALGO_NB] = {
+    [ALGO_RLE] = {ALGO_RLE, "RLE", "RLE", CODEC_CAP_SEEKABLE,
+                  NULL, rle_compress, NULL, rle_decompress},
+    [ALGO_RLE_FAST] = {ALGO_RLE_FAST, "RLE-FAST", "RLE-FAST",
+                       CODEC_CAP_SEEKABLE,
+                       NULL, rle_fast_compress, NULL, rle_fast_decompress},
+    [ALGO_HUFFMAN] = {ALGO_HUFFMAN, "HUFFMAN", "HUFFMAN",
+                      CODEC_CAP_BINARY | CODEC_CAP_SEEKABLE,
+                      NULL, huffman_compress, NULL, huffman_decompress},
+    [ALGO_LZ] = {ALGO_LZ, "LZ", "LZ", CODEC_CAP_BINARY | CODEC_CAP_SEEKABLE,
+                 codec_lz_parse, NULL, codec_lz_compress, lz_decompress},
+    [ALGO_RLE_BIN] = {ALGO_RLE_BIN, "RLE-BIN", "RLE-BIN",
+                      CODEC_CAP_BINARY | CODEC_CAP_SEEKABLE,
+                      NULL, rle_bin_compress, NULL, rle_bin_decompress},
+    [ALGO_AUTO] = {ALGO_AUTO, "AUTO", "auto",
+                   CODEC_CAP_BINARY | CODEC_CAP_PARALLEL,
+                   NULL, NULL, NULL, NULL},
+    [ALGO_STORED] = {ALGO_STORED, "STORED", NULL,
+                     CODEC_CAP_BINARY | CODEC_CAP_SEEKABLE,
+                     NULL, codec_copy, NULL, codec_copy},
+    [ALGO_ANS] = {ALGO_ANS, "ANS", "ANS",
+                  CODEC_CAP_BINARY | CODEC_CAP_SEEKABLE,
+                  NULL, ans_compress, NULL, ans_decompress},
+    [ALGO_BWT] = {ALGO_BWT, "BWT", "BWT",
+                  CODEC_CAP_BINARY | CODEC_CAP_PARALLEL | CODEC_CAP_SEEKABLE,
+                  NULL, bwt_compress, NULL, bwt_decompress},
+    [ALGO_PIPE] = {ALGO_PIPE, "PIPE", "pipeline",
+                   CODEC_CAP_BINARY | CODEC_CAP_PARALLEL | CODEC_CAP_SEEKABLE,
+                   codec_pipe_parse, NULL, codec_pipe_compress,
+                   pipe_decompress}
+};
+
+/* Lance l'algorithme de "ctx" dans son sens sur "cf", par la fonction de sa
+ * description.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne l'erreur de "cf"
+ * sur l'erreur correspondante (celle de l'échec de l'algorithme si sa cause
+ * n'est pas connue). */
+static int codec_dispatch(const codec_ctx_s * ctx, cmp_file_s * cf)
+{
+    assert(ctx && cf);
+    const codec_desc_s *desc = ctx->p_desc;
+    int ret;
+    /* Un algorithme sans CODEC_CAP_BINARY ne compresse que du texte : les
+     * autres données donneraient un fichier indécompressable. */
+    if (ctx->mode == MODE_COMPRESS && desc
+        && !(desc->caps & CODEC_CAP_BINARY) && cmpf_set_text(cf))
+        return -1;
+    if (ctx->mode == MODE_COMPRESS && desc && desc->compress_ctx)
+        ret = desc->compress_ctx(cf, ctx);
+    else if (ctx->mode == MODE_COMPRESS)
+        ret = desc && desc->compress ? desc->compress(cf) : -1;
+    else
+        ret = desc && desc->decompress ? desc->decompress(cf) : -1;
+    return ret ? cmpf_fail(cf, ctx->mode == MODE_COMPRESS
+                           ? ERR_COMPRESSION_FAILED
+                           : ERR_DECOMPRESSION_FAILED) : 0;
+}
+
+/* Remplace l'algorithme de "ctx" par "algo" et résout sa description. */
+static void codec_set_algo(codec_ctx_s * ctx, const algo_e algo)
+{
+    ctx->algo = algo;
+    ctx->p_desc = codec_desc(algo);
+}
+
+/* Copie les "in_size" bytes de "p_in" (données stockées) dans une zone
+ * mémoire allouée, dont l'adresse et la taille sont renvoyées dans "*pp_out"
+ * et "*p_out_size", et met à jour les statistiques de "ctx" depuis "start".
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur correspondante. */
+static int codec_store(codec_ctx_s * ctx, const byte_t * p_in,
+                       const size_t in_size, const uint64_t raw_size,
+                       byte_t ** pp_out, size_t * p_out_size,
+                       const uint64_t start)
+{
+    assert(ctx && pp_out && p_out_size);
+    if ((!p_in && in_size) || (ctx->mode == MODE_DECOMPRESS
+                               && raw_size != CODEC_SIZE_UNKNOWN
+                               && raw_size != in_size))
+        return ctx->err = ctx->mode == MODE_COMPRESS
+            ? ERR_COMPRESSION_FAILED : ERR_DECOMPRESSION_FAILED, -1;
+    byte_t *p_out = malloc(in_size ? in_size : 1);
+    if (!p_out)
+        return ctx->err = ERR_OTHER, -1;
+    if (in_size)
+        memcpy(p_out, p_in, in_size);
+    *pp_out = p_out, *p_out_size = in_size;
+    ctx->in_total += in_size;
+    ctx->out_total += in_size;
+    ctx->codec_ns += io_time_ns() - start;
+    ctx->err = ERR_NONE;
+    return 0;
+}
+
+/* Fonctions publiques ====================================================== */
+
+const codec_desc_s *codec_desc(const algo_e algo)
+{
+    if (algo <= ALGO_NONE || algo >= ALGO_NB)
+        return NULL;
+    return &CODEC_REGISTRY[algo];
+}
+
+const codec_desc_s *codec_find(const char *s_name)
+{
+    if (!s_name)
+        return NULL;
+    for (algo_e algo = ALGO_NONE + 1; algo < ALGO_NB; algo++) {
+        if (!strcmp(s_name, CODEC_REGISTRY[algo].s_name))
+            return &CODEC_REGISTRY[algo];
+    }
+    return NULL;
+}
+
+algo_e codec_pick(const byte_t * p_src, const size_t size)
+{
+    if (!p_src || !size)
+        return ALGO_STORED;
+    /* Échantillon : tranches réparties sur les données, ou toutes les données
+     * si elles sont petites. */
+    const int nb_slices = size <= CODEC_SAMPLE_SLICES * CODEC_SAMPLE_SLICE
+        ? 1 : CODEC_SAMPLE_SLICES;
+    const size_t slice = nb_slices == 1 ? size : CODEC_SAMPLE_SLICE;
+    uint32_t a_counts[UINT8_MAX + 1] = { 0 }, total = 0, lz_total = 0;
+    uint64_t cost_rle = 0, cost_lz = 0;
+    for (int i = 0; i < nb_slices; i++) {
+        const byte_t *p = p_src + (size - slice) / (nb_slices > 1
+                                                    ? nb_slices - 1 : 1) * i;
+        for (size_t j = 0; j < slice; j++)
+            a_counts[p[j]]++;
+        total += slice;
+        cost_rle += codec_cost_rle(p, slice);
+        /* L'estimation de LZ, la plus coûteuse, ne voit qu'une tranche sur
+         * deux, et seulement le début d'une tranche unique plus grande. */
+        if (i % 2 == 0) {
+            const size_t lz_size = slice < CODEC_SAMPLE_SLICE ? slice
+                : CODEC_SAMPLE_SLICE;
+            cost_lz += codec_cost_lz(p, lz_size);
+            lz_total += lz_size;
+        }
+    }
+    /* En-tête du codage de Huffman, rapporté à la taille de l'échantillon. */
+    const uint64_t cost_huffman = codec_cost_huffman(a_counts, total)
+        + CODEC_HUFFMAN_HEADER * 256ull * 8 * total / size;
+    /* Taux estimés en centièmes, dans l'ordre de vitesse de compression. */
+    const algo_e a_algos[] = { ALGO_RLE_BIN, ALGO_HUFFMAN, ALGO_LZ };
+    const uint64_t a_ratios[] = {
+        total * 100ull / cost_rle,
+        total * 256ull * 8 * 100 / cost_huffman,
+        lz_total * 100ull / cost_lz
+    };
+    uint64_t best = 0;
+    for (size_t i = 0; i < sizeof(a_ratios) / sizeof(a_ratios[0]); i++)
+        best = a_ratios[i] > best ? a_ratios[i] : best;
+    /* Données incompressibles : stockées telles quelles. */
+    if (best < CODEC_AUTO_RATIO_MIN)
+        return ALGO_STORED;
+    for (size_t i = 0; i < sizeof(a_ratios) / sizeof(a_ratios[0]); i++)
+        if (a_ratios[i] * 100 >= best * CODEC_AUTO_SHARE)
+            return a_algos[i];
+    return ALGO_LZ;
+}
+
+void codec_init(codec_ctx_s * ctx, const mode_e mode, const algo_e algo,
+                const int level)
+{
+    assert(ctx);
+    ctx->mode = mode;
+    codec_set_algo(ctx, algo);
+    ctx->level = level;
+    ctx->pipe.nb_stages = 0;
+    ctx->store = ctx->verify = TRUE;
+    ctx->err = ERR_NONE;
+    ctx->in_total = ctx->out_total = 0;
+    ctx->read_ns = ctx->codec_ns = ctx->write_ns = 0;
+}
+
+int codec_run(codec_ctx_s * ctx, cmp_file_s * cf)
+{
+    if (!ctx)
+        return -1;
+    if (!cf)
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    uint64_t in_start, out_start, in_end, out_end;
+    uint64_t read_start, write_start, read_end, write_end;
+    cmpf_get_totals(cf, &in_start, &out_start);
+    cmpf_get_times(cf, &read_start, &write_start);
+    const uint64_t start = io_time_ns();
+    const int ret = codec_dispatch(ctx, cf);
+    const uint64_t time = io_time_ns() - start;
+    cmpf_get_totals(cf, &in_end, &out_end);
+    cmpf_get_times(cf, &read_end, &write_end);
+    ctx->in_total += in_end - in_start;
+    ctx->out_total += out_end - out_start;
+    /* Le temps de l'algorithme est celui qui n'est pas passé à lire ou à
+     * écrire les fichiers. */
+    ctx->read_ns += read_end - read_start;
+    ctx->write_ns += write_end - write_start;
+    ctx->codec_ns += time - (read_end - read_start)
+        - (write_end - write_start);
+    ctx->err = ret ? cmpf_get_err(cf) : ERR_NONE;
+    return ret;
+}
+
+int codec_run_mem(codec_ctx_s * ctx, const byte_t * p_in,
+                  const size_t in_size, const uint64_t raw_size,
+                  byte_t ** pp_out, size_t * p_out_size)
+{
+    if (!ctx)
+        return -1;
+    if (!pp_out || !p_out_size)
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    *pp_out = NULL, *p_out_size = 0;
+    const uint64_t start = io_time_ns();
+    /* Choix automatique : l'algorithme retenu reste dans le contexte. */
+    if (ctx->mode == MODE_COMPRESS && ctx->algo == ALGO_AUTO)
+        codec_set_algo(ctx, codec_pick(p_in, in_size));
+    /* Données stockées : simple copie, de la taille originale attendue. */
+    if (ctx->algo == ALGO_STORED)
+        return codec_store(ctx, p_in, in_size, raw_size, pp_out, p_out_size,
+                           start);
+    cmp_file_s *cf = cmpf_open_mem(p_in, in_size);
+    if (!cf)
+        return ctx->err = ERR_OTHER, -1;
+    /* Des données décompressées sont allouées à leur taille originale,
+     * qu'elles doivent retrouver. L'erreur de "cf" est relevée avant sa
+     * fermeture. */
+    const err_code_e err =
+        (raw_size != CODEC_SIZE_UNKNOWN && cmpf_set_size(cf, raw_size))
+        || codec_dispatch(ctx, cf) ? cmpf_get_err(cf) : ERR_NONE;
+    const err_code_e err_close = cmpf_close_mem(cf, pp_out, p_out_size);
+    if (err_close)
+        return ctx->err = err ? err : err_close, -1;
+    if (err)
+        return free(*pp_out), *pp_out = NULL, ctx->err = err, -1;
+    /* Données que l'algorithme agrandit : stockées telles quelles. */
+    if (ctx->mode == MODE_COMPRESS && ctx->store && *p_out_size >= in_size) {
+        free(*pp_out), *pp_out = NULL;
+        codec_set_algo(ctx, ALGO_STORED);
+        return codec_store(ctx, p_in, in_size, raw_size, pp_out, p_out_size,
+                           start);
+    }
+    ctx->in_total += in_size;
+    ctx->out_total += *p_out_size;
+    ctx->codec_ns += io_time_ns() - start;
+    ctx->err = ERR_NONE;
+    return 0;
+}
@@ -14,7 +14,23 @@
 #include "init.h"
 #include "io.h"
 #include "stats.h"
-#include "algo_rle.h"
+#include "parallel.h"
+#include "header.h"
+#include "codec.h"
+#include "archive.h"
+
+/* Fonctions privées ======================================================== */
+
+/* Termine le programme une fois le fichier sortant écrit : génère les
+ * statistiques du traitement "ctx" si demandé. Renvoie le code de sortie du
+ * programme. */
+static int end_prog(const prog_info_s * pi, const codec_ctx_s * ctx)
+{
+    err_code_e err;
+    if (pi->stat && (err = stat_print(pi, ctx)))
+        err_print(err);
+    return 0;
+}
 
 /* Point d'entrée =========================================================== */
 
@@ -28,38 +44,130 @@ int main(int argc, char *argv[])
     /* Initialisation de la génération des statistiques. */
     if (pi.stat)
         stat_init();
-    /* Ouverture des flux. */
-    cmp_file_s *cf = cmpf_open(pi.s_input_file, pi.s_output_file);
 
-    /* Partie compression. */
+    header_s hdr;
+    codec_ctx_s ctx;
+    byte_t a_trailer[HDR_TRAILER_SIZE];
 
-#pragma GCC diagnostic ignored "-Wswitch"
-    if (pi.mode == MODE_COMPRESS) {
-        switch (pi.algo) {
-            case ALGO_RLE:
-                rle_compress(cf);
-                break;
+    /* Mode archive : les fichiers sont traités en mémoire par le module
+     * d'archivage, qui gère lui-même ses flux, par défaut sur tout les
+     * processeurs. */
+    if (pi.s_archive) {
+        const int nb_threads = pi.nb_threads ? pi.nb_threads
+            : par_default_threads();
+        codec_init(&ctx, pi.mode, pi.algo, pi.level);
+        ctx.pipe = pi.pipe;
+        ctx.verify = pi.verify;
+        char *s_err_path;
+        if (pi.mode == MODE_COMPRESS ?
+            arc_create(pi.s_archive, pi.a_s_members, pi.nb_members, &ctx,
+                       nb_threads, &s_err_path) :
+            arc_extract(pi.s_archive, pi.s_output_file, pi.a_s_members,
+                        pi.nb_members, &ctx, nb_threads, &s_err_path)) {
+            s_err_path ? err_print_path(ctx.err, s_err_path)
+                : err_print(ctx.err);
+            return free(s_err_path), -1;
         }
-        if (CMP_err == ERR_COMPRESSION_FAILED)
-            return err_print(CMP_err), -1;
-    } else {
-        switch (pi.algo) {
-            case ALGO_RLE:
-                rle_decompress(cf);
-                break;
+        return end_prog(&pi, &ctx);
+    }
+
+    /* Ouverture des flux ("-" : entrée ou sortie standard). */
+    FILE *fp_in = io_fopen(pi.s_input_file, "rb"), *fp_out;
+    if (!fp_in)
+        return err_print_path(ERR_IO_FOPEN, pi.s_input_file), -1;
+    if (!(fp_out = io_fopen(pi.s_output_file, "wb")))
+        return err_print_path(ERR_IO_FOPEN, pi.s_output_file), -1;
+
+    /* Compression en mode parallèle : les blocs indépendants sont traités en
+     * mémoire par le module de parallélisme, qui gère lui-même ses flux et
+     * l'en-tête. */
+    if (pi.mode == MODE_COMPRESS && pi.nb_threads) {
+        codec_init(&ctx, MODE_COMPRESS, pi.algo, pi.level);
+        ctx.pipe = pi.pipe;
+        if (par_compress(fp_in, fp_out, &ctx, pi.nb_threads))
+            return err_print(ctx.err), -1;
+        return end_prog(&pi, &ctx);
+    }
+    if (pi.mode == MODE_DECOMPRESS) {
+        /* L'algorithme est détecté grâce à l'en-tête. */
+        if (hdr_fread(fp_in, &hdr))
+            return err_print(ERR_HEADER), -1;
+        /* Intervalle des données originales : seuls les blocs qui le
+         * couvrent sont décompressés. */
+        if (pi.range_len) {
+            codec_init(&ctx, MODE_DECOMPRESS, hdr.algo, 0);
+            ctx.verify = pi.verify;
+            if (par_decompress_range(fp_in, fp_out, &hdr, &ctx,
+                                     pi.range_offset, pi.range_len))
+                return err_print(ctx.err), -1;
+            return end_prog(&pi, &ctx);
+        }
+        /* Fichier compressé en mode parallèle : décompression parallèle, par
+         * défaut sur tout les processeurs. */
+        if (hdr.flags & HDR_FLAG_PARALLEL) {
+            if (pi.io_buffer || pi.io_direct)
+                fprintf(stderr, "Options --io-buffer et --direct ignorées "
+                        "pour un fichier compressé en mode parallèle.\n");
+            codec_init(&ctx, MODE_DECOMPRESS, hdr.algo, 0);
+            ctx.verify = pi.verify;
+            if (par_decompress(fp_in, fp_out, &hdr, &ctx, pi.nb_threads ?
+                               pi.nb_threads : par_default_threads()))
+                return err_print(ctx.err), -1;
+            return end_prog(&pi, &ctx);
         }
-        if (CMP_err == ERR_DECOMPRESSION_FAILED)
-            return err_print(CMP_err), -1;
     }
-#pragma GCC diagnostic pop
+    cmp_file_s *cf = cmpf_open_fp(fp_in, fp_out);
+    if (!cf)
+        return err_print(ERR_OTHER), -1;
+    if (cmpf_set_output(cf, pi.io_buffer, pi.io_direct))
+        return err_print(cmpf_get_err(cf)), -1;
+
+    /* Partie compression ou décompression. */
+
+    if (pi.mode == MODE_COMPRESS) {
+        /* En-tête : algorithme et taille originale si elle est connue. La
+         * somme de contrôle des données originales, calculée pendant la
+         * lecture, suit les données compressées. */
+        hdr_init(&hdr, pi.algo);
+        hdr.flags |= HDR_FLAG_CHECKSUM;
+        if (!cmpf_get_size(cf, &hdr.size))
+            hdr.flags |= HDR_FLAG_SIZE;
+        codec_init(&ctx, MODE_COMPRESS, pi.algo, pi.level);
+        ctx.pipe = pi.pipe;
+        if (cmpf_set_checksum(cf, FALSE) || hdr_write(cf, &hdr))
+            return err_print(cmpf_get_err(cf)), -1;
+        if (codec_run(&ctx, cf))
+            return err_print(ctx.err), -1;
+        hdr_encode_trailer(a_trailer, cmpf_get_checksum(cf));
+        if (cmpf_put_bytes(cf, a_trailer, HDR_TRAILER_SIZE))
+            return err_print(cmpf_get_err(cf)), -1;
+    } else {
+        /* La taille originale et la somme de contrôle, retenue à la fin du
+         * fichier entrant, sont vérifiées à la fermeture des flux. */
+        const int checked = hdr.flags & HDR_FLAG_CHECKSUM ? TRUE : FALSE;
+        codec_init(&ctx, MODE_DECOMPRESS, hdr.algo, 0);
+        if (checked && (cmpf_set_trailer(cf, HDR_TRAILER_SIZE)
+                        || (pi.verify && cmpf_set_checksum(cf, TRUE))))
+            return err_print(ERR_CHECKSUM), -1;
+        if (hdr.flags & HDR_FLAG_SIZE && cmpf_set_size(cf, hdr.size))
+            return err_print(cmpf_get_err(cf)), -1;
+        if (codec_run(&ctx, cf))
+            return err_print(ctx.err), -1;
+        if (checked && cmpf_get_trailer(cf, a_trailer))
+            return err_print(ERR_CHECKSUM), -1;
+        if (checked && pi.verify
+            && cmpf_expect_checksum(cf, hdr_decode_trailer(a_trailer)))
+            return err_print(cmpf_get_err(cf)), -1;
+    }
 
     /* Fin du programme. */
 
-    /* Fermeture des flux. */
-    if (cmpf_close(cf))
-        return err_print(CMP_err), -1;
-    /* Génération des statistiques si demandé. */
-    if (pi.stat && stat_print(pi.s_input_file, pi.s_output_file))
-        err_print(ERR_STAT);
-    return 0;
+    /* Fermeture des flux : le vidage des buffers est compté dans le temps
+     * d'écriture. */
+    const uint64_t start = io_time_ns();
+    const err_code_e err = cmpf_close(cf);
+    if (err)
+        return err_print(err), -1;
+    ctx.write_ns += io_time_ns() - start;
+    return end_prog(&pi, &ctx);
 }
@@ -0,0 +1,256 @@
+/**
+ * \file crc32c.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Sommes de contrôle.
+ * \details Module de calcul des sommes de contrôle CRC32C (polynôme de
+ * Castagnoli), qui protègent les fichiers compressés contre la troncature et
+ * la corruption. Le calcul utilise l'instruction "crc32" de SSE4.2 quand le
+ * processeur la supporte.
+ */
+
+/* Fonctionnement : l'instruction "crc32" traite 8 bytes par appel mais a une
+ * latence de 3 cycles. Sur les grandes zones, trois suites consécutives de
+ * même longueur sont donc calculées en même temps, puis les sommes sont
+ * recombinées en leur ajoutant l'effet de la longueur des suites suivantes
+ * (des bytes nuls) avec des tables précalculées. Sans SSE4.2, les données
+ * sont traitées par 8 bytes avec 8 tables ("slicing-by-8"). */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "crc32c.h"
+#include "common.h"
+
+/* Portabilité entre compilateur. */
+#ifndef __GNUC__
+#define  __attribute__(x)       /* Nothing. */
+#endif
+
+/* Calcul avec l'instruction "crc32" des processeurs x86 (désactivable avec
+ * -DCRC32C_NO_SSE42). */
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(CRC32C_NO_SSE42)
+#define CRC32C_SSE42
+#include <nmmintrin.h>
+#endif
+
+/* Macro-constantes privées ================================================= */
+
+/* Polynôme de Castagnoli, bits inversés. */
+#define CRC32C_POLY 0x82F63B78
+/* Longueur de chacune des trois suites calculées en même temps sur les
+ * grandes zones, puis sur les zones moyennes. */
+#define CRC32C_LONG 8192
+#define CRC32C_SHORT 256
+
+/* Variables globales privées =============================================== */
+
+/* Tables du calcul par 8 bytes, la première servant au calcul par byte. */
+static uint32_t a_crc32c_table[8][256];
+/* Tables d'ajout de CRC32C_LONG et de CRC32C_SHORT bytes nuls à une somme,
+ * par byte de la somme. */
+static uint32_t a_crc32c_long[4][256];
+static uint32_t a_crc32c_short[4][256];
+/* Fonction de calcul retenue pour le processeur. */
+static uint32_t (*p_crc32c_run)(uint32_t, const byte_t *, size_t);
+/* Initialisation unique des tables et du choix de la fonction. */
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+
+/* Fonctions privées ======================================================== */
+
+/* # Opérateurs sur GF(2) =================================================== */
+
+/* Renvoie le produit de la matrice 32x32 "a_mat" (une colonne par entier) de
+ * GF(2) par le vecteur "vec". */
+static uint32_t crc32c_gf2_times(const uint32_t * a_mat, uint32_t vec)
+{
+    uint32_t sum = 0;
+    for (; vec; vec >>= 1, a_mat++)
+        if (vec & 1)
+            sum ^= *a_mat;
+    return sum;
+}
+
+/* Élève au carré la matrice "a_mat". */
+static void crc32c_gf2_square(uint32_t * a_mat)
+{
+    uint32_t a_square[32];
+    for (int n = 0; n < 32; n++)
+        a_square[n] = crc32c_gf2_times(a_mat, a_mat[n]);
+    memcpy(a_mat, a_square, sizeof(a_square));
+}
+
+/* Stocke dans "a_op" l'opérateur d'ajout d'un bit nul à une somme. */
+static void crc32c_zeros_bit(uint32_t * a_op)
+{
+    uint32_t row = 1;
+    a_op[0] = CRC32C_POLY;
+    for (int n = 1; n < 32; n++, row <<= 1)
+        a_op[n] = row;
+}
+
+/* Applique à la somme "crc" l'ajout de "len" bytes nuls, avec les opérateurs
+ * des puissances de deux successives du nombre de bytes. */
+static uint32_t crc32c_zeros(uint32_t crc, uint64_t len)
+{
+    uint32_t a_op[32];
+    crc32c_zeros_bit(a_op);
+    for (int i = 0; i < 3; i++)
+        crc32c_gf2_square(a_op);
+    for (; len; len >>= 1) {
+        if (len & 1)
+            crc = crc32c_gf2_times(a_op, crc);
+        if (len > 1)
+            crc32c_gf2_square(a_op);
+    }
+    return crc;
+}
+
+/* Remplit les tables "a_zeros" d'ajout de "len" bytes nuls (puissance de
+ * deux), par byte de la somme. */
+static void crc32c_zeros_table(uint32_t a_zeros[][256], const size_t len)
+{
+    assert(len && !(len & (len - 1)));
+    uint32_t a_op[32];
+    crc32c_zeros_bit(a_op);
+    for (size_t nb_bits = len * 8; nb_bits > 1; nb_bits >>= 1)
+        crc32c_gf2_square(a_op);
+    for (uint32_t n = 0; n < 256; n++)
+        for (int i = 0; i < 4; i++)
+            a_zeros[i][n] = crc32c_gf2_times(a_op, n << (i * 8));
+}
+
+/* Renvoie la somme "crc" (sans inversion) après l'ajout des bytes nuls des
+ * tables "a_zeros". */
+static inline uint32_t crc32c_shift(const uint32_t a_zeros[][256],
+                                    const uint32_t crc)
+{
+    return a_zeros[0][crc & 0xFF] ^ a_zeros[1][(crc >> 8) & 0xFF]
+        ^ a_zeros[2][(crc >> 16) & 0xFF] ^ a_zeros[3][crc >> 24];
+}
+
+/* # Calcul ================================================================= */
+
+/* Renvoie l'entier sur 64 bits en little endian à l'adresse "p_src", lu en
+ * une fois sur un processeur little endian. */
+static inline uint64_t crc32c_get_u64(const byte_t * p_src)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t val;
+    memcpy(&val, p_src, sizeof(val));
+#else
+    uint64_t val = 0;
+    for (int i = 7; i >= 0; i--)
+        val = (val << 8) | p_src[i];
+#endif
+    return val;
+}
+
+/* Calcul par 8 bytes avec les tables : met à jour la somme "crc" avec les
+ * "size" bytes de "p_src". */
+static uint32_t crc32c_run_table(uint32_t crc, const byte_t * p_src,
+                                 size_t size)
+{
+    crc = ~crc;
+    for (; size >= 8; size -= 8, p_src += 8) {
+        const uint64_t word = crc32c_get_u64(p_src) ^ crc;
+        crc = a_crc32c_table[7][word & 0xFF]
+            ^ a_crc32c_table[6][(word >> 8) & 0xFF]
+            ^ a_crc32c_table[5][(word >> 16) & 0xFF]
+            ^ a_crc32c_table[4][(word >> 24) & 0xFF]
+            ^ a_crc32c_table[3][(word >> 32) & 0xFF]
+            ^ a_crc32c_table[2][(word >> 40) & 0xFF]
+            ^ a_crc32c_table[1][(word >> 48) & 0xFF]
+            ^ a_crc32c_table[0][word >> 56];
+    }
+    for (; size; size--)
+        crc = (crc >> 8) ^ a_crc32c_table[0][(crc ^ *p_src++) & 0xFF];
+    return ~crc;
+}
+
+#ifdef CRC32C_SSE42
+/* Met à jour la somme "crc" (sans inversion) avec les bytes de "*pp_src" par
+ * trois suites de "len" bytes calculées en même temps, tant qu'il en reste
+ * assez, et avance "*pp_src" et "*p_size". "a_zeros" ajoute "len" bytes
+ * nuls. */
+__attribute__ ((target("sse4.2")))
+static uint64_t crc32c_run_lanes(uint64_t crc, const byte_t ** pp_src,
+                                 size_t * p_size, const size_t len,
+                                 const uint32_t a_zeros[][256])
+{
+    const byte_t *p = *pp_src;
+    for (; *p_size >= 3 * len; *p_size -= 3 * len, p += 2 * len) {
+        uint64_t crc1 = 0, crc2 = 0;
+        for (const byte_t * p_end = p + len; p < p_end; p += 8) {
+            crc = _mm_crc32_u64(crc, crc32c_get_u64(p));
+            crc1 = _mm_crc32_u64(crc1, crc32c_get_u64(p + len));
+            crc2 = _mm_crc32_u64(crc2, crc32c_get_u64(p + 2 * len));
+        }
+        crc = crc32c_shift(a_zeros, crc) ^ crc1;
+        crc = crc32c_shift(a_zeros, crc) ^ crc2;
+    }
+    *pp_src = p;
+    return crc;
+}
+
+/* Calcul avec l'instruction "crc32" : met à jour la somme "crc" avec les
+ * "size" bytes de "p_src". */
+__attribute__ ((target("sse4.2")))
+static uint32_t crc32c_run_sse42(uint32_t crc, const byte_t * p_src,
+                                 size_t size)
+{
+    uint64_t crc0 = ~crc;
+    crc0 = crc32c_run_lanes(crc0, &p_src, &size, CRC32C_LONG,
+                            a_crc32c_long);
+    crc0 = crc32c_run_lanes(crc0, &p_src, &size, CRC32C_SHORT,
+                            a_crc32c_short);
+    for (; size >= 8; size -= 8, p_src += 8)
+        crc0 = _mm_crc32_u64(crc0, crc32c_get_u64(p_src));
+    for (; size; size--)
+        crc0 = _mm_crc32_u8(crc0, *p_src++);
+    return ~(uint32_t) crc0;
+}
+#endif
+
+/* Remplit les tables et choisit la fonction de calcul la plus rapide
+ * supportée par le processeur. */
+static void crc32c_init(void)
+{
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = n;
+        for (int k = 0; k < 8; k++)
+            crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        a_crc32c_table[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; n++)
+        for (int k = 1; k < 8; k++)
+            a_crc32c_table[k][n] = (a_crc32c_table[k - 1][n] >> 8)
+                ^ a_crc32c_table[0][a_crc32c_table[k - 1][n] & 0xFF];
+    p_crc32c_run = crc32c_run_table;
+#ifdef CRC32C_SSE42
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32c_zeros_table(a_crc32c_long, CRC32C_LONG);
+        crc32c_zeros_table(a_crc32c_short, CRC32C_SHORT);
+        p_crc32c_run = crc32c_run_sse42;
+    }
+#endif
+}
+
+/* Fonctions publiques ====================================================== */
+
+uint32_t crc32c_update(uint32_t crc, const void *p_src, size_t size)
+{
+    assert(p_src || !size);
+    pthread_once(&crc32c_once, crc32c_init);
+    return size ? p_crc32c_run(crc, p_src, size) : crc;
+}
+
+uint32_t crc32c_combine(uint32_t crc1, const uint32_t crc2, uint64_t len2)
+{
+    /* Les inversions du début et de la fin de chaque somme s'annulent. */
+    return crc32c_zeros(crc1, len2) ^ crc2;
+}
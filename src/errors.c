@@ -14,7 +14,7 @@
 
 /* Fonctions publiques ====================================================== */
 
-void err_print(const err_code_e err)
+const char *err_str(const err_code_e err)
 {
     static const char *err_desc[] = {
         "aucune erreur",
@@ -26,46 +26,170 @@ void err_print(const err_code_e err)
         "écriture du fichier impossible",
         "fermeture du fichier impossible",
         "compression du fichier impossible",
-        "décompression du fichier impossible"
+        "décompression du fichier impossible",
+        "en-tête du fichier compressé absent, invalide ou non supporté",
+        "taille du fichier sortant différente de la taille originale",
+        "ouverture du fichier impossible",
+        "zone mémoire sortante trop petite",
+        "archive invalide, ou nom de membre incorrect ou en double",
+        "membre absent de l'archive",
+        "accès à un intervalle impossible, le fichier n'est pas compressé "
+            "par blocs (-t)",
+        "somme de contrôle incorrecte, le fichier compressé est tronqué ou "
+            "corrompu",
+        "l'algorithme n'accepte que l'ASCII sans octet nul (--RLE-BIN "
+            "accepte tout les octets)"
     };
-    (unsigned int)err <= ERR_DECOMPRESSION_FAILED ?
-        fprintf(stderr, "Erreur %d : %s.\n", err, err_desc[err]) :
+    return (unsigned int)err <= ERR_NOT_TEXT ? err_desc[err]
+        : "erreur inconnue";
+}
+
+void err_print(const err_code_e err)
+{
+    (unsigned int)err <= ERR_NOT_TEXT ?
+        fprintf(stderr, "Erreur %d : %s.\n", err, err_str(err)) :
         fprintf(stderr, "Erreur inconnu.\n");
 }
 
+void err_print_path(const err_code_e err, const char *s_path)
+{
+    (unsigned int)err <= ERR_NOT_TEXT ?
+        fprintf(stderr, "Erreur %d : %s (%s).\n", err, err_str(err), s_path) :
+        fprintf(stderr, "Erreur inconnu (%s).\n", s_path);
+}
+
 void help_print(FILE * const p_stream, const int exit_code, const char *s_name)
 {
     fprintf(p_stream,
             "Affichage de l'aide :\n\n"
             "Synopsis :\n"
             "\t%s -c|-d -i INPUT FILE [-o OUTPUT FILE]"
-            "[ALGORITHM FLAG] [-s] [-h]\n\n"
+            "[ALGORITHM FLAG] [-1..-9] [-t THREADS] [-s|--stats=FORMAT]\n"
+            "\t[-h]\n"
+            "\t%s [-c] -a ARCHIVE [ALGORITHM FLAG] [-1..-9] [-t THREADS]\n"
+            "\t\tFILE|DIR...\n"
+            "\t%s -d -a ARCHIVE [-o DIR] [-t THREADS] [MEMBER...]\n\n"
             "Options :\n"
             "\t-h, --help\n"
             "\t\tAffiche l'aide sur la sortie standard.\n\n"
             "\t-c, --compress\n"
             "\t\tMode de compression du fichier entrant.\n\n"
             "\t-d, --decompress\n"
-            "\t\tMode de décompression du fichier entrant.\n"
-            "\t\tImplique de préciser un algorthime.\n\n"
+            "\t\tMode de décompression du fichier entrant. L'algorithme\n"
+            "\t\test détecté grâce à l'en-tête du fichier compressé.\n\n"
             "\t-s, --statistics\n"
             "\t\tAffiche les statistiques de la compression ou de la\n"
             "\t\tdécompression effectuée sur la sortie standard.\n\n"
+            "\t--stats[=FORMAT]\n"
+            "\t\tAffiche les statistiques dans le format FORMAT : text\n"
+            "\t\t(par défaut, équivaut à -s), json (un objet sur une\n"
+            "\t\tligne) ou csv (noms des colonnes puis valeurs). Les\n"
+            "\t\tformats json et csv donnent le temps réel et CPU, les\n"
+            "\t\ttailles lues et produites, les débits en MB/s, le taux\n"
+            "\t\tde compression, la mémoire maximale et le temps de\n"
+            "\t\tlecture, de l'algorithme et d'écriture.\n\n"
             "\t-i INPUT FILE, --input=INPUT FILE\n"
-            "\t\tChemin vers le fichier entrant à traiter.\n\n"
+            "\t\tChemin vers le fichier entrant à traiter, ou \"-\" pour\n"
+            "\t\tl'entrée standard.\n\n"
             "\t-o OUTPUT FILE, --output=OUTPUT FILE\n"
             "\t\tChemin vers le fichier sortant résultant. Si non spécifié,\n"
             "\t\tle fichier sortant gardera le nom du fichier source et\n"
             "\t\tsera écrit dans le répertoire \"out/\" situé dans le\n"
-            "\t\trépertoire de l'exécutable.\n\n"
+            "\t\trépertoire de l'exécutable (sur la sortie standard si le\n"
+            "\t\tfichier entrant est l'entrée standard). \"-\" désigne la\n"
+            "\t\tsortie standard.\n\n"
+            "\t--stdout\n"
+            "\t\tÉcris le fichier sortant sur la sortie standard (équivaut\n"
+            "\t\tà -o -). Les statistiques sont alors affichées sur la\n"
+            "\t\tsortie d'erreur.\n\n"
+            "\t--io-buffer=KB\n"
+            "\t\tTaille en kB de chacun des deux buffers d'écriture du\n"
+            "\t\tfichier sortant (1 à 1048576, arrondie à la page). Par\n"
+            "\t\tdéfaut : 1024. Refusé en compression parallèle, en\n"
+            "\t\tmode archive et avec --range.\n\n"
+            "\t--direct\n"
+            "\t\tÉcris le fichier sortant sans le cache du système\n"
+            "\t\t(O_DIRECT), s'il le supporte pour ce fichier. Refusé\n"
+            "\t\tdans les mêmes cas que --io-buffer.\n\n"
+            "\t-t THREADS, --threads=THREADS\n"
+            "\t\tMode parallèle : découpe le fichier entrant en blocs\n"
+            "\t\tindépendants de 1 MiB traités par THREADS threads (1 à\n"
+            "\t\t256). Un bloc que l'algorithme agrandirait est stocké tel\n"
+            "\t\tquel. Un fichier compressé dans ce mode est décompressé\n"
+            "\t\ten parallèle, par défaut sur tout les processeurs.\n\n"
+            "\t--range=OFFSET:LEN\n"
+            "\t\tAvec -d, n'écris que les LEN bytes originaux à partir de\n"
+            "\t\tla position OFFSET d'un fichier compressé avec -t, en ne\n"
+            "\t\tdécompressant que les blocs qui les contiennent.\n\n"
+            "\t--no-verify\n"
+            "\t\tAvec -d, ne vérifie pas les sommes de contrôle (CRC32C)\n"
+            "\t\tenregistrées à la compression, qui détectent un fichier\n"
+            "\t\tcompressé tronqué ou corrompu.\n\n"
+            "\t-a ARCHIVE, --archive=ARCHIVE\n"
+            "\t\tMode archive. En compression (par défaut), compresse les\n"
+            "\t\tfichiers et les répertoires listés (récursivement) dans\n"
+            "\t\tl'archive ARCHIVE, en parallèle sur THREADS threads (par\n"
+            "\t\tdéfaut tout les processeurs). Avec -d, extrait les membres\n"
+            "\t\tlistés (fichiers ou répertoires, tous par défaut) dans le\n"
+            "\t\trépertoire donné par -o, en ne lisant que leurs données.\n\n"
+            "\t-1 .. -9\n"
+            "\t\tNiveau de compression de --LZ, du plus rapide (-1) au plus\n"
+            "\t\tfort (-9). Par défaut : -6.\n\n"
             "Algorithmes :\n"
             "\t--RLE\n"
             "\t\tCompresse le fichier en utilisant l'algorithme RLE\n"
             "\t\t(Run-Lenght Encoding). L'algorithme nécéssite\n"
-            "\t\tobligatoirement un fichier encodé en ASCII pour fonctionner.\n\n"
+            "\t\tobligatoirement un fichier encodé en ASCII pour fonctionner\n"
+            "\t\t(les autres fichiers sont refusés).\n\n"
+            "\t--RLE-FAST\n"
+            "\t\tCompresse le fichier avec le même format que --RLE, mais en\n"
+            "\t\tutilisant le moteur rapide (écriture des champs entiers et\n"
+            "\t\tdécodage par table).\n\n"
+            "\t--RLE-BIN\n"
+            "\t\tCompresse le fichier en utilisant l'algorithme RLE avec un\n"
+            "\t\tformat orienté octet (paquets de littéraux et de\n"
+            "\t\trépétitions de longueur quelconque). Fonctionne sur tout\n"
+            "\t\ttype de fichier.\n\n"
+            "\t--HUFFMAN\n"
+            "\t\tCompresse le fichier en utilisant le codage de Huffman\n"
+            "\t\t(codes canoniques). Fonctionne sur tout type de fichier.\n\n"
+            "\t--ANS\n"
+            "\t\tCompresse le fichier en utilisant le codage rANS à quatre\n"
+            "\t\tétats entrelacés : comme --HUFFMAN, mais avec des codes\n"
+            "\t\td'une fraction de bit. Fonctionne sur tout type de\n"
+            "\t\tfichier.\n\n"
+            "\t--BWT\n"
+            "\t\tCompresse le fichier par blocs de 1 MB en enchaînant la\n"
+            "\t\ttransformée de Burrows-Wheeler, le move-to-front, --RLE-BIN\n"
+            "\t\tet --ANS. Active le mode parallèle par défaut. Fonctionne\n"
+            "\t\tsur tout type de fichier.\n\n"
+            "\t--LZ[=N]\n"
+            "\t\tCompresse le fichier en utilisant l'algorithme LZ77, avec\n"
+            "\t\tune fenêtre de 64 kB, au niveau N (1 à 9, comme -1 .. -9).\n"
+            "\t\tFonctionne sur tout type de fichier.\n\n"
+            "\t--auto\n"
+            "\t\tChoisit l'algorithme de chaque bloc de 1 MiB (mode\n"
+            "\t\tparallèle, par défaut sur tout les processeurs) d'après un\n"
+            "\t\téchantillon : le plus rapide parmi --RLE-BIN, --HUFFMAN et\n"
+            "\t\t--LZ dont le taux estimé approche le meilleur.\n\n"
+            "\t--pipeline=LIST\n"
+            "\t\tCompresse le fichier par blocs de 1 MiB en enchaînant les\n"
+            "\t\tétages de LIST, séparés par des virgules (8 au plus) :\n"
+            "\t\tdelta[:N] (différence avec l'octet situé N octets avant,\n"
+            "\t\t1 par défaut), transpose[:N] (octets de même rang\n"
+            "\t\td'enregistrements de N octets regroupés, 4 par défaut),\n"
+            "\t\trle (--RLE-BIN), huffman et ans. Active le mode parallèle\n"
+            "\t\tpar défaut. Fonctionne sur tout type de fichier.\n\n"
             "Exemples :\n"
             "\t%s -c -i env/corpus/text.txt -o text.cmp --RLE -s\n\n"
             "\t%s --decompress --input=\"text.cmp\" "
-            "--output=\"text.txt\"\n\n", s_name, s_name, s_name);
+            "--output=\"text.txt\"\n\n"
+            "\ttar -c logs/ | %s -c -i - --LZ | ssh host 'cat > logs.cmp'\n\n"
+            "\t%s -a logs.c0a --LZ logs/\n\n"
+            "\t%s -d -a logs.c0a -o logs/ logs/app.log\n\n"
+            "\t%s -d -i logs.cmp --stdout --range=1048576:4096\n\n"
+            "\t%s -c -i sensors.bin --pipeline=transpose:14,delta,rle,ans\n\n",
+            s_name, s_name, s_name, s_name, s_name, s_name, s_name, s_name,
+            s_name, s_name);
     exit(exit_code);
 }
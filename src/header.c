@@ -0,0 +1,177 @@
+/**
+ * \file header.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief En-tête.
+ * \details Module de lecture et d'écriture de l'en-tête des fichiers
+ * compressés, qui permet de les décompresser sans préciser l'algorithme.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "header.h"
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "crc32c.h"
+#include "algo_rle.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Longueur du nombre magique. */
+#define HDR_MAGIC_SIZE 4
+/* Flags connus par cette version. */
+#define HDR_FLAGS_KNOWN (HDR_FLAG_PARALLEL | HDR_FLAG_SIZE | HDR_FLAG_CHECKSUM \
+                         | HDR_FLAG_SEEK)
+
+/* Fonctions privées ======================================================== */
+
+/* Renvoie le paramètre de l'algorithme "algo" inscrit dans l'en-tête. */
+static byte_t hdr_param(const algo_e algo)
+{
+    return algo == ALGO_RLE || algo == ALGO_RLE_FAST ? REP_CODE_LENGHT : 0;
+}
+
+/* Décode et vérifie les HDR_SIZE premiers bytes de "p_src" dans "hdr".
+ * Renvoie 0 sur un succès, -1 si l'en-tête est invalide ou non supporté. */
+static int hdr_decode_fixed(header_s * hdr, const byte_t * p_src)
+{
+    assert(hdr && p_src);
+    if (memcmp(p_src, HDR_MAGIC, HDR_MAGIC_SIZE) || p_src[4] != HDR_VERSION
+        || p_src[5] <= ALGO_NONE || p_src[5] >= ALGO_NB
+        || p_src[6] & ~HDR_FLAGS_KNOWN || p_src[7] != hdr_param(p_src[5]))
+        return -1;
+    hdr->algo = p_src[5];
+    hdr->flags = p_src[6];
+    hdr->param = p_src[7];
+    hdr->size = 0;
+    for (int i = 7; i >= 0; i--)
+        hdr->size = (hdr->size << CHAR_BIT) | p_src[8 + i];
+    return 0;
+}
+
+/* Vérifie la somme de contrôle qui suit les HDR_SIZE premiers bytes de
+ * "p_src".
+ * Renvoie 0 si elle est correcte, -1 si l'en-tête est corrompu. */
+static int hdr_check(const byte_t * p_src)
+{
+    assert(p_src);
+    return hdr_decode_trailer(p_src + HDR_SIZE)
+        == crc32c_update(CRC32C_INIT, p_src, HDR_SIZE) ? 0 : -1;
+}
+
+/* Fonctions publiques ====================================================== */
+
+void hdr_init(header_s * hdr, const algo_e algo)
+{
+    assert(hdr);
+    hdr->algo = algo;
+    hdr->flags = 0;
+    hdr->param = hdr_param(algo);
+    hdr->size = 0;
+}
+
+size_t hdr_encode(const header_s * hdr, byte_t * p_dest)
+{
+    assert(hdr && p_dest);
+    memcpy(p_dest, HDR_MAGIC, HDR_MAGIC_SIZE);
+    p_dest[4] = HDR_VERSION;
+    p_dest[5] = hdr->algo;
+    p_dest[6] = hdr->flags;
+    p_dest[7] = hdr->param;
+    for (int i = 0; i < 8; i++)
+        p_dest[8 + i] = (hdr->size >> (i * CHAR_BIT)) & 0xFF;
+    if (!(hdr->flags & HDR_FLAG_CHECKSUM))
+        return HDR_SIZE;
+    hdr_encode_trailer(p_dest + HDR_SIZE,
+                       crc32c_update(CRC32C_INIT, p_dest, HDR_SIZE));
+    return HDR_SIZE_MAX;
+}
+
+int hdr_decode(header_s * hdr, const byte_t * p_src, const size_t size)
+{
+    if (!hdr || (!p_src && size))
+        return -1;
+    if (size < HDR_SIZE)
+        return 0;
+    if (hdr_decode_fixed(hdr, p_src))
+        return -1;
+    if (!(hdr->flags & HDR_FLAG_CHECKSUM))
+        return HDR_SIZE;
+    if (size < HDR_SIZE_MAX)
+        return 0;
+    if (hdr_check(p_src))
+        return -1;
+    return HDR_SIZE_MAX;
+}
+
+int hdr_write(cmp_file_s * cf, const header_s * hdr)
+{
+    if (!cf)
+        return -1;
+    if (!hdr)
+        return cmpf_set_err(cf, ERR_BAD_ADRESS), -1;
+    byte_t a_buf[HDR_SIZE_MAX];
+    return cmpf_put_bytes(cf, a_buf, hdr_encode(hdr, a_buf));
+}
+
+int hdr_read(cmp_file_s * cf, header_s * hdr)
+{
+    if (!cf)
+        return -1;
+    if (!hdr)
+        return cmpf_set_err(cf, ERR_BAD_ADRESS), -1;
+    byte_t a_buf[HDR_SIZE_MAX];
+    if (cmpf_get_bytes(cf, a_buf, HDR_SIZE) != HDR_SIZE
+        || hdr_decode_fixed(hdr, a_buf))
+        return cmpf_set_err(cf, ERR_HEADER), -1;
+    if (hdr->flags & HDR_FLAG_CHECKSUM
+        && (cmpf_get_bytes(cf, a_buf + HDR_SIZE, 4) != 4 || hdr_check(a_buf)))
+        return cmpf_set_err(cf, ERR_HEADER), -1;
+    return 0;
+}
+
+int hdr_fwrite(FILE * fp, const header_s * hdr)
+{
+    if (!fp || !hdr)
+        return -1;
+    byte_t a_buf[HDR_SIZE_MAX];
+    const size_t size = hdr_encode(hdr, a_buf);
+    if (fwrite(a_buf, sizeof(byte_t), size, fp) != size)
+        return -1;
+    return 0;
+}
+
+int hdr_fread(FILE * fp, header_s * hdr)
+{
+    if (!fp || !hdr)
+        return -1;
+    byte_t a_buf[HDR_SIZE_MAX];
+    if (fread(a_buf, sizeof(byte_t), HDR_SIZE, fp) != HDR_SIZE
+        || hdr_decode_fixed(hdr, a_buf))
+        return -1;
+    if (hdr->flags & HDR_FLAG_CHECKSUM
+        && (fread(a_buf + HDR_SIZE, sizeof(byte_t), 4, fp) != 4
+            || hdr_check(a_buf)))
+        return -1;
+    return 0;
+}
+
+void hdr_encode_trailer(byte_t * p_dest, const uint32_t checksum)
+{
+    assert(p_dest);
+    for (int i = 0; i < HDR_TRAILER_SIZE; i++)
+        p_dest[i] = (checksum >> (i * CHAR_BIT)) & 0xFF;
+}
+
+uint32_t hdr_decode_trailer(const byte_t * p_src)
+{
+    assert(p_src);
+    uint32_t checksum = 0;
+    for (int i = HDR_TRAILER_SIZE - 1; i >= 0; i--)
+        checksum = (checksum << CHAR_BIT) | p_src[i];
+    return checksum;
+}
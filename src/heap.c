@@ -0,0 +1,93 @@
+/**
+ * \file heap.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Tas binaire.
+ * \details Module d'implémentation d'un tas binaire minimum (file de
+ * priorité), dont les éléments sont des couples clé/valeur triés par clé
+ * croissante.
+ */
+
+/* Le tas est stocké dans un tableau : les fils de l'élément i sont les
+ * éléments 2i + 1 et 2i + 2, et chaque élément a une clé inférieure ou égale à
+ * celles de ses fils. */
+
+#include <stdlib.h>
+#include <assert.h>
+#include "heap.h"
+
+/* Structures privées ======================================================= */
+
+/* Tas binaire minimum. */
+struct heap {
+    heap_node_s *a_nodes;       /* Éléments du tas. */
+    int size;                   /* Nombre d'éléments. */
+    int cap;                    /* Nombre maximal d'éléments. */
+};
+
+/* Fonctions publiques ====================================================== */
+
+heap_s *heap_new(const int cap)
+{
+    assert(cap > 0);
+    heap_s *h = malloc(sizeof(heap_s));
+    if (!h)
+        return NULL;
+    if (!(h->a_nodes = malloc(cap * sizeof(heap_node_s))))
+        return free(h), NULL;
+    h->size = 0;
+    h->cap = cap;
+    return h;
+}
+
+void heap_free(heap_s * h)
+{
+    if (h)
+        free(h->a_nodes), free(h);
+}
+
+int heap_size(const heap_s * h)
+{
+    assert(h);
+    return h->size;
+}
+
+int heap_push(heap_s * h, const uint64_t key, const int value)
+{
+    assert(h);
+    if (h->size == h->cap)
+        return -1;
+    /* Remontée de l'élément tant que son père a une clé plus grande. */
+    int i = h->size++;
+    while (i && h->a_nodes[(i - 1) >> 1].key > key) {
+        h->a_nodes[i] = h->a_nodes[(i - 1) >> 1];
+        i = (i - 1) >> 1;
+    }
+    h->a_nodes[i].key = key;
+    h->a_nodes[i].value = value;
+    return 0;
+}
+
+int heap_pop(heap_s * h, heap_node_s * node)
+{
+    assert(h && node);
+    if (!h->size)
+        return -1;
+    *node = h->a_nodes[0];
+    /* Descente du dernier élément depuis la racine tant qu'un de ses fils a
+     * une clé plus petite. */
+    const heap_node_s last = h->a_nodes[--h->size];
+    int i = 0, child;
+    while ((child = (i << 1) + 1) < h->size) {
+        if (child + 1 < h->size
+            && h->a_nodes[child + 1].key < h->a_nodes[child].key)
+            child++;
+        if (h->a_nodes[child].key >= last.key)
+            break;
+        h->a_nodes[i] = h->a_nodes[child];
+        i = child;
+    }
+    h->a_nodes[i] = last;
+    return 0;
+}
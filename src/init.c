@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <assert.h>
 #include <getopt.h>
 #include <errno.h>
@@ -18,26 +19,84 @@
 #include "init.h"
 #include "errors.h"
 #include "common.h"
+#include "parallel.h"
+#include "codec.h"
+#include "io.h"
 
 /* Macros-constantes privées ================================================ */
 
 #define DEF_OUT_PATH "out/"
 
+/* Valeur de retour de "getopt_long" pour l'option longue "--stdout". */
+#define OPT_STDOUT 'O'
+/* Valeur de retour de "getopt_long" pour l'option longue "--stats". */
+#define OPT_STATS 'S'
+/* Valeur de retour de "getopt_long" pour l'option longue "--io-buffer". */
+#define OPT_IO_BUFFER 'B'
+/* Valeur de retour de "getopt_long" pour l'option longue "--direct". */
+#define OPT_DIRECT 'D'
+/* Valeur de retour de "getopt_long" pour l'option longue "--range". */
+#define OPT_RANGE 'R'
+/* Valeur de retour de "getopt_long" pour l'option longue "--no-verify". */
+#define OPT_NO_VERIFY 'V'
+
+/* Taille maximale des buffers d'écriture en kB (1 GiB). */
+#define IO_BUFFER_MAX_KB (1 << 20)
+
 /* Fonctions privées ======================================================== */
 
 /* Initialise une variable de type prog_info_s à 0. */
 static prog_info_s init_prog_info()
 {
     prog_info_s pi;
-    pi.stat = FALSE;
+    pi.stat = STAT_NONE;
     pi.mode = MODE_NONE;
     pi.algo = ALGO_NONE;
+    pi.nb_threads = 0;
+    pi.level = 0;
+    pi.pipe.nb_stages = 0;
+    pi.io_buffer = 0;
+    pi.io_direct = FALSE;
+    pi.verify = TRUE;
     pi.s_prog_name = NULL;
     pi.s_input_file = NULL;
     pi.s_output_file[0] = '\0';
+    pi.s_archive = NULL;
+    pi.a_s_members = NULL;
+    pi.nb_members = 0;
+    pi.range_offset = 0;
+    pi.range_len = 0;
     return pi;
 }
 
+/* Lit l'intervalle "OFFSET:LEN" de "s_range" dans "*p_offset" et "*p_len".
+ * Renvoie 0 sur un succès, -1 si l'intervalle est invalide ou vide. */
+static int get_range(const char *s_range, uint64_t * p_offset,
+                     uint64_t * p_len)
+{
+    char *s_end;
+    errno = 0;
+    if (!isdigit((unsigned char) s_range[0]))
+        return -1;
+    *p_offset = strtoull(s_range, &s_end, 10);
+    if (*s_end != ':' || !isdigit((unsigned char) s_end[1]))
+        return -1;
+    *p_len = strtoull(s_end + 1, &s_end, 10);
+    return *s_end || errno || !*p_len ? -1 : 0;
+}
+
+/* Lit dans "*p_value" l'entier de "s_arg", compris entre 1 et "max".
+ * Renvoie 0 sur un succès, -1 si "s_arg" n'est pas un tel entier. */
+static int get_count(const char *s_arg, const long max, long *p_value)
+{
+    char *s_end;
+    errno = 0;
+    if (!isdigit((unsigned char) s_arg[0]))
+        return -1;
+    *p_value = strtol(s_arg, &s_end, 10);
+    return *s_end || errno || *p_value < 1 || *p_value > max ? -1 : 0;
+}
+
 /* Récupère les arguments en ligne de commande et les stockes dans P. Quitte le
  * programme si une erreur survient. */
 static prog_info_s get_args(prog_info_s pi, const int argc, char *const *argv)
@@ -45,20 +104,50 @@ static prog_info_s get_args(prog_info_s pi, const int argc, char *const *argv)
     /* Stockage de l'argument en cours de traitement. */
     char curr_arg = 0;
 
+    /* Réglages de l'algorithme choisi : argument de son option et niveau
+     * -1 à -9, lus après les options par sa fonction "parse". */
+    const char *s_algo_arg = NULL;
+    char s_level[2] = "";
+    /* Valeur numérique de l'argument en cours de traitement. */
+    long value;
+
     /* Chaîne de caractère contenant les lettres courtes d'options. */
-    const char *s_short_options = "hcdsi:o:";
+    const char *s_short_options = "hcdsi:o:t:a:123456789";
 
-    /* Structure définissant les options longues. */
-    const struct option long_options[] = {
+    /* Structure définissant les options longues, complétée par celles des
+     * algorithmes du registre (la valeur renvoyée est leur identifiant). */
+    const struct option a_base_options[] = {
         {"help", 0, NULL, 'h'},
         {"compress", 0, NULL, 'c'},
         {"decompress", 0, NULL, 'd'},
         {"statistics", 0, NULL, 's'},
+        {"stats", 2, NULL, OPT_STATS},
         {"input", 1, NULL, 'i'},
         {"output", 1, NULL, 'o'},
-        {"RLE", 0, NULL, ALGO_RLE},
-        {NULL, 0, NULL, 0}
+        {"threads", 1, NULL, 't'},
+        {"archive", 1, NULL, 'a'},
+        {"stdout", 0, NULL, OPT_STDOUT},
+        {"io-buffer", 1, NULL, OPT_IO_BUFFER},
+        {"direct", 0, NULL, OPT_DIRECT},
+        {"range", 1, NULL, OPT_RANGE},
+        {"no-verify", 0, NULL, OPT_NO_VERIFY}
     };
+    const int nb_base = sizeof(a_base_options) / sizeof(a_base_options[0]);
+    struct option long_options[sizeof(a_base_options)
+                               / sizeof(a_base_options[0]) + ALGO_NB];
+    int nb_options = nb_base;
+    memcpy(long_options, a_base_options, sizeof(a_base_options));
+    for (algo_e algo = ALGO_NONE + 1; algo < ALGO_NB; algo++) {
+        const codec_desc_s *desc = codec_desc(algo);
+        if (!desc->s_option)
+            continue;
+        struct option *opt = &long_options[nb_options++];
+        opt->name = desc->s_option;
+        opt->has_arg = desc->parse ? 2 : 0;
+        opt->flag = NULL;
+        opt->val = algo;
+    }
+    memset(&long_options[nb_options], 0, sizeof(struct option));
 
     pi.s_prog_name = argv[0];
     do {
@@ -71,16 +160,66 @@ static prog_info_s get_args(prog_info_s pi, const int argc, char *const *argv)
                 pi.mode = MODE_DECOMPRESS;
                 break;
             case 's':
-                pi.stat = TRUE;
+                pi.stat = STAT_TEXT;
+                break;
+            case OPT_STATS:
+                if (!optarg || !strcmp(optarg, "text"))
+                    pi.stat = STAT_TEXT;
+                else if (!strcmp(optarg, "json"))
+                    pi.stat = STAT_JSON;
+                else if (!strcmp(optarg, "csv"))
+                    pi.stat = STAT_CSV;
+                else
+                    help_print(stderr, EXIT_FAILURE, pi.s_prog_name);
                 break;
             case 'i':
                 pi.s_input_file = optarg;
                 break;
+            case 'a':
+                pi.s_archive = optarg;
+                break;
             case 'o':
                 strcat(pi.s_output_file, optarg);
                 break;
-            case ALGO_RLE:
-                pi.algo = ALGO_RLE;
+            case OPT_STDOUT:
+                strcpy(pi.s_output_file, IO_STD_PATH);
+                break;
+            case OPT_IO_BUFFER:
+                if (get_count(optarg, IO_BUFFER_MAX_KB, &value)) {
+                    fprintf(stderr, "Option --io-buffer : entier de 1 à %d "
+                            "attendu.\n", IO_BUFFER_MAX_KB);
+                    help_print(stderr, EXIT_FAILURE, pi.s_prog_name);
+                }
+                pi.io_buffer = (size_t) value * 1024;
+                break;
+            case OPT_DIRECT:
+                pi.io_direct = TRUE;
+                break;
+            case OPT_RANGE:
+                if (get_range(optarg, &pi.range_offset, &pi.range_len))
+                    help_print(stderr, EXIT_FAILURE, pi.s_prog_name);
+                break;
+            case OPT_NO_VERIFY:
+                pi.verify = FALSE;
+                break;
+            case 't':
+                if (get_count(optarg, PAR_THREADS_MAX, &value)) {
+                    fprintf(stderr, "Option --threads : entier de 1 à %d "
+                            "attendu.\n", PAR_THREADS_MAX);
+                    help_print(stderr, EXIT_FAILURE, pi.s_prog_name);
+                }
+                pi.nb_threads = value;
+                break;
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                s_level[0] = curr_arg;
                 break;
             case 'h':
                 help_print(stdout, EXIT_SUCCESS, pi.s_prog_name);
@@ -88,10 +227,35 @@ static prog_info_s get_args(prog_info_s pi, const int argc, char *const *argv)
                 help_print(stdout, EXIT_FAILURE, pi.s_prog_name);
             case -1:           /* Lecture terminée. */
                 break;
-            default:           /* Erreur dans la fonction. */
-                abort();
+            default:
+                /* Options des algorithmes : la valeur est l'identifiant. */
+                if (curr_arg <= ALGO_NONE || curr_arg >= ALGO_NB)
+                    abort();    /* Erreur dans la fonction. */
+                pi.algo = curr_arg;
+                s_algo_arg = codec_desc(pi.algo)->parse ? optarg : NULL;
+                break;
         }
     } while (curr_arg != -1);
+    /* Réglages de l'algorithme choisi, lus dans un contexte puis recopiés. */
+    const codec_desc_s *desc = codec_desc(pi.algo);
+    if (desc && desc->parse) {
+        codec_ctx_s ctx;
+        char s_err[CODEC_ERR_SIZE];
+        codec_init(&ctx, MODE_COMPRESS, pi.algo, 0);
+        if (desc->parse(&ctx, s_algo_arg ? s_algo_arg
+                        : s_level[0] ? s_level : NULL, s_err,
+                        sizeof(s_err))) {
+            fprintf(stderr, "Option --%s : %s.\n", desc->s_option,
+                    s_err);
+            help_print(stderr, EXIT_FAILURE, pi.s_prog_name);
+        }
+        pi.level = ctx.level;
+        pi.pipe = ctx.pipe;
+    }
+    /* Les arguments restants sont les fichiers ou les membres d'une
+     * archive. */
+    pi.a_s_members = argv + optind;
+    pi.nb_members = argc - optind;
     return pi;
 }
 
@@ -105,6 +269,21 @@ prog_info_s init_prog(const int argc, char *const *argv)
     /* Récupération des arguments bruts. */
     pinfo = get_args(pinfo, argc, argv);
 
+    /* Mode archive : compression par défaut, des fichiers listés dans
+     * l'archive, ou extraction de l'archive. */
+    if (pinfo.s_archive) {
+        if (!pinfo.mode)
+            pinfo.mode = MODE_COMPRESS;
+        if (pinfo.mode == MODE_COMPRESS) {
+            if (!pinfo.nb_members || pinfo.s_output_file[0]
+                || strlen(pinfo.s_archive) >= sizeof(pinfo.s_output_file))
+                help_print(stderr, EXIT_FAILURE, pinfo.s_prog_name);
+            pinfo.s_input_file = pinfo.a_s_members[0];
+            strcpy(pinfo.s_output_file, pinfo.s_archive);
+        } else
+            pinfo.s_input_file = pinfo.s_archive;
+    }
+
     /* Test que les options obligatoires ont bien étés passées. */
     if ((pinfo.mode == MODE_COMPRESS && !pinfo.algo) || !pinfo.mode ||
         !pinfo.s_input_file) {
@@ -112,7 +291,37 @@ prog_info_s init_prog(const int argc, char *const *argv)
         help_print(stderr, EXIT_FAILURE, pinfo.s_prog_name);
     }
 
-    /* Met un nom par défaut au fichier de sortie si non spécifié. */
+    /* Algorithmes qui traitent chaque bloc indépendamment (choix
+     * automatique, BWT, chaîne de transformations) : par défaut sur tout
+     * les processeurs. */
+    if (pinfo.mode == MODE_COMPRESS && codec_desc(pinfo.algo)
+        && codec_desc(pinfo.algo)->caps & CODEC_CAP_PARALLEL
+        && !pinfo.s_archive && !pinfo.nb_threads)
+        pinfo.nb_threads = par_default_threads();
+
+    /* Un intervalle ne s'extrait que d'un fichier compressé seul. */
+    if (pinfo.range_len && (pinfo.mode != MODE_DECOMPRESS
+                            || pinfo.s_archive))
+        help_print(stderr, EXIT_FAILURE, pinfo.s_prog_name);
+
+    /* Les buffers d'écriture ne servent qu'au traitement séquentiel d'un
+     * fichier : le mode parallèle, le mode archive et l'extraction d'un
+     * intervalle écrivent leurs blocs sans eux. */
+    if ((pinfo.io_buffer || pinfo.io_direct)
+        && (pinfo.s_archive || pinfo.range_len
+            || (pinfo.mode == MODE_COMPRESS && pinfo.nb_threads))) {
+        fprintf(stderr, "Options --io-buffer et --direct : sans effet en "
+                "mode parallèle, en mode archive et avec --range.\n");
+        help_print(stderr, EXIT_FAILURE, pinfo.s_prog_name);
+    }
+
+    /* Sur l'entrée standard, la sortie par défaut est la sortie standard. */
+    if (!pinfo.s_output_file[0] && !pinfo.s_archive
+        && !strcmp(pinfo.s_input_file, IO_STD_PATH))
+        strcpy(pinfo.s_output_file, IO_STD_PATH);
+
+    /* Met un nom par défaut au fichier de sortie si non spécifié (le
+     * répertoire de sortie par défaut pour l'extraction d'une archive). */
     if (!pinfo.s_output_file[0]) {
         assert(pinfo.s_input_file);
         /* Ajoute le répertoire du programme suivis du répertoire de sortie par
@@ -130,7 +339,8 @@ prog_info_s init_prog(const int argc, char *const *argv)
         /* Ajoute le nom du fichier source. */
         s_ptr_tmp = strrchr(pinfo.s_input_file, '/');
         s_ptr_tmp = s_ptr_tmp ? s_ptr_tmp + 1 : pinfo.s_input_file;
-        strcat(pinfo.s_output_file, s_ptr_tmp);
+        if (!pinfo.s_archive)
+            strcat(pinfo.s_output_file, s_ptr_tmp);
     }
     assert(pinfo.s_output_file[0]);
     return pinfo;
@@ -7,12 +7,24 @@
  * \details Module de gestion des entrées/sorties sur le disque.
  */
 
+/* O_DIRECT. */
+#define _GNU_SOURCE
+
 #include <stdlib.h>
 #include <limits.h>
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <pthread.h>
 #include "io.h"
 #include "errors.h"
+#include "crc32c.h"
 #include "common.h"
 
 /* Portabilité entre compilateur. */
@@ -22,188 +34,1104 @@
 
 /* Macro-constantes privées ================================================= */
 
-/* Taille d'un tableau contenant un fichier chargé en mémoire. */
-#define IO_BUFFER_SIZE 2048     /* Optimal après tests empiriques. */
+/* Capacité initiale d'une zone mémoire sortante. */
+#define IO_BUFFER_SIZE 2048
+
+/* Taille de chacun des deux buffers de lecture d'un fichier non projeté. */
+#define IO_READ_SIZE (1 << 18)
+
+/* Nombre maximal de bytes retenus à la fin du fichier entrant (voir
+ * cmpf_set_trailer), réservés au début de chaque buffer de lecture. */
+#define IO_TRAILER_MAX 8
+
+/* Taille de la fenêtre d'un fichier projeté dont le chargement est demandé au
+ * noyau en avance. */
+#define IO_MAP_AHEAD (1 << 22)
+
+/* Taille par défaut de chacun des deux buffers d'écriture d'un fichier. */
+#define IO_WRITE_SIZE (1 << 20)
+
+/* Taille des buffers de "stdio" sur les fichiers, pour lire et écrire les
+ * tubes par gros morceaux. */
+#define IO_STREAM_BUFFER_SIZE (1 << 20)
+
+/* Taille attendue du flux sortant non spécifiée. */
+#define IO_SIZE_UNKNOWN UINT64_MAX
 
 /* Aligmement des grosses structures en mémoire. */
 #define IO_ALIGN 64             /* Cacheline. */
 
 /* Structures privées ======================================================= */
 
-/* Correspond à un fichier en cours de traitement. */
+typedef struct io_worker io_worker_s;
+
+/* Thread d'entrées/sorties, qui exécute une tâche à la fois pour le thread
+ * principal. */
+struct io_worker {
+    pthread_t thread;           /* Thread. */
+    pthread_mutex_t mutex;      /* Protège les champs suivants. */
+    pthread_cond_t cond;        /* Signale une tâche ou sa fin. */
+    cmp_file_s *cf;             /* Fichier sur lequel travaille la tâche. */
+    int (*p_task)(cmp_file_s *);        /* Tâche en cours (NULL si aucune). */
+    int stop;                   /* Vrai pour terminer le thread. */
+    int ret;                    /* Valeur de retour de la dernière tâche. */
+};
+
+/* Correspond à un fichier en cours de traitement. Les flux sont soit des
+ * fichiers sur le disque, soit des zones mémoires si "fp_in" et "fp_out" sont
+ * nuls (voir cmpf_open_mem). Un fichier entrant régulier est projeté en
+ * mémoire ("map_size" non nul) et lu comme une zone mémoire.
+ * Le fichier sortant est écrit avec "writev" sur son descripteur, sans passer
+ * par le buffer de "stdio", depuis deux buffers alignés sur une page : quand
+ * le buffer courant est plein, il est mis en attente et l'écriture continue
+ * dans l'autre ; quand les deux sont pleins, ils sont écrits en un seul appel
+ * système. Une zone mémoire sortante est écrite directement, sans buffer.
+ * Les entrées/sorties des fichiers sont asynchrones : un thread de lecture
+ * charge le buffer de lecture suivant pendant que l'algorithme traite le
+ * buffer courant, et un thread d'écriture écrit le buffer d'écriture en
+ * attente pendant que l'algorithme remplit l'autre. Le chargement d'un
+ * fichier projeté est demandé au noyau IO_MAP_AHEAD bytes en avance. Si un
+ * thread ne peut pas être créé, les entrées/sorties restent synchrones.
+ * Les sommes de contrôle des flux sont calculées par ces mêmes threads, sur
+ * chaque buffer chargé ou écrit (et sur chaque fenêtre d'un fichier projeté,
+ * pour laquelle le thread de lecture est démarré). */
 struct cmp_file {
     FILE *fp_in;                /* Fichier entrant. */
     FILE *fp_out;               /* Fichier sortant. */
-    int nb_blocks;              /* Nombre de bloc chargé dans "a_read_stream". */
-    int nb_bytes;               /* Nombre de byte chargé dans "a_read_stream". */
-    block_t a_read_stream       /* Flux contenant les données à lire. */
-        [IO_BUFFER_SIZE];
-    block_t a_write_stream      /* Flux contenant les données à écrire. */
-        [IO_BUFFER_SIZE];
-    block_t *p_read;            /* Pointeur sur le prochain bloc à lire. */
-    block_t *p_write;           /* Pointeur sur le prochain bloc à écrire. */
+    size_t map_size;            /* Taille de la projection du fichier entrant
+                                   (0 si non projeté). */
+    const byte_t *p_mem_in;     /* Zone mémoire entrante. */
+    size_t mem_in_size;         /* Taille de la zone mémoire entrante. */
+    size_t mem_in_start;        /* Position de début des données dans
+                                   "p_mem_in" (fichier déjà entamé). */
+    size_t mem_in_pos;          /* Position de lecture dans "p_mem_in". */
+    byte_t *p_mem_out;          /* Zone mémoire sortante (allouée). */
+    size_t mem_out_size;        /* Nombre de byte écrits dans "p_mem_out". */
+    size_t mem_out_cap;         /* Capacité de "p_mem_out". */
+    size_t map_ahead;           /* Position de lecture à partir de laquelle
+                                   la fenêtre suivante est demandée au
+                                   noyau. */
+    byte_t *a_p_read[2];        /* Buffers de lecture (fichier non
+                                   projeté). */
+    int read_cur;               /* Indice du buffer de lecture courant. */
+    size_t nb_bytes;            /* Nombre de byte chargé dans le buffer
+                                   courant. */
+    size_t read_pos;            /* Position du prochain byte à lire dans le
+                                   buffer courant. */
+    size_t read_next;           /* Nombre de byte chargés dans l'autre buffer
+                                   par la dernière tâche de lecture. */
+    int read_ahead;             /* Vrai si le chargement de l'autre buffer
+                                   (ou la somme de contrôle d'une fenêtre du
+                                   fichier projeté) est en cours. */
+    uint64_t in_total;          /* Nombre de byte chargés depuis le fichier
+                                   entrant avec "fread". */
+    int read_eof;               /* Vrai si le dernier chargement a atteint la
+                                   fin du fichier. */
+    byte_t a_trailer[IO_TRAILER_MAX];   /* Derniers bytes chargés, retenus
+                                           jusqu'au chargement suivant. */
+    size_t trailer_size;        /* Nombre de bytes à retenir à la fin du
+                                   fichier entrant. */
+    size_t trailer_held;        /* Nombre de bytes retenus dans
+                                   "a_trailer". */
+    int text_in;                /* Vrai si le fichier entrant est réservé au
+                                   texte (cmpf_set_text). */
+    int sum_in;                 /* Vrai si la somme de contrôle du fichier
+                                   entrant est calculée. */
+    uint32_t in_checksum;       /* Somme de contrôle des bytes chargés. */
+    size_t sum_pos;             /* Position dans "p_mem_in" jusqu'à laquelle
+                                   la somme est calculée. */
+    size_t sum_end;             /* Fin de la fenêtre dont la somme est
+                                   calculée par le thread de lecture. */
+    int fd_out;                 /* Descripteur du fichier sortant (-1 pour
+                                   une zone mémoire). */
+    int direct;                 /* Vrai si le fichier sortant est écrit sans
+                                   le cache du système (O_DIRECT). */
+    byte_t *a_p_write[2];       /* Buffers d'écriture alignés. */
+    size_t write_size;          /* Taille de chaque buffer d'écriture. */
+    int write_cur;              /* Indice du buffer d'écriture courant. */
+    size_t write_pos;           /* Nombre de byte écrits dans le buffer
+                                   courant. */
+    size_t write_wait;          /* Nombre de byte du buffer en attente (0 ou
+                                   "write_size"). */
+    uint64_t out_total;         /* Nombre de byte écrits sur le flux
+                                   sortant. */
+    uint64_t read_ns;           /* Temps passé à attendre le chargement du
+                                   fichier entrant. */
+    uint64_t write_ns;          /* Temps passé à attendre l'écriture du flux
+                                   sortant. */
+    uint64_t out_expected;      /* Taille attendue du flux sortant
+                                   (IO_SIZE_UNKNOWN si inconnue). */
+    int sum_out;                /* Vrai si la somme de contrôle du flux
+                                   sortant est calculée. */
+    uint32_t out_checksum;      /* Somme de contrôle des bytes écrits. */
+    int check_out;              /* Vrai si la somme du flux sortant est
+                                   vérifiée à la fermeture. */
+    uint32_t out_sum_expected;  /* Somme de contrôle attendue du flux
+                                   sortant. */
+    int reader_on;              /* Vrai si le thread de lecture tourne. */
+    int writer_on;              /* Vrai si le thread d'écriture tourne. */
+    io_worker_s reader;         /* Thread de lecture. */
+    io_worker_s writer;         /* Thread d'écriture. */
+    err_code_e err;             /* Erreur du flux (voir cmpf_get_err). */
 } __attribute__ ((aligned(IO_ALIGN)));
 
 /* Fonctions privées ======================================================== */
 
-/* Lit le fichier source de "cf" depuis le disque et le stocke dans son buffer de
- * lecture.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne "CMP_err"
- * sur l'erreur produite.
+/* # Threads d'entrées/sorties ============================================== */
+
+/* Boucle du thread "p_arg" (io_worker_s) : exécute les tâches soumises jusqu'à
+ * ce qu'il soit arrêté. Une tâche ne touche pas à l'erreur du fichier, que le
+ * thread principal positionne d'après sa valeur de retour. */
+static void *io_worker_main(void *p_arg)
+{
+    io_worker_s *w = p_arg;
+    pthread_mutex_lock(&w->mutex);
+    while (TRUE) {
+        while (!w->p_task && !w->stop)
+            pthread_cond_wait(&w->cond, &w->mutex);
+        if (!w->p_task)
+            break;
+        int (*p_task)(cmp_file_s *) = w->p_task;
+        pthread_mutex_unlock(&w->mutex);
+        const int ret = p_task(w->cf);
+        pthread_mutex_lock(&w->mutex);
+        w->ret = ret;
+        w->p_task = NULL;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->mutex);
+    return NULL;
+}
+
+/* Démarre le thread "w" sur le fichier "cf".
+ * Renvoie 0 sur un succès, -1 si le thread ne peut pas être créé. */
+static int io_worker_start(io_worker_s * w, cmp_file_s * cf)
+{
+    assert(w && cf);
+    w->cf = cf;
+    w->p_task = NULL;
+    w->stop = FALSE;
+    w->ret = 0;
+    if (pthread_mutex_init(&w->mutex, NULL))
+        return -1;
+    if (pthread_cond_init(&w->cond, NULL)) {
+        pthread_mutex_destroy(&w->mutex);
+        return -1;
+    }
+    if (pthread_create(&w->thread, NULL, io_worker_main, w)) {
+        pthread_cond_destroy(&w->cond), pthread_mutex_destroy(&w->mutex);
+        return -1;
+    }
+    return 0;
+}
+
+/* Soumet la tâche "p_task" au thread "w", qui ne doit pas en avoir en
+ * cours. */
+static void io_worker_submit(io_worker_s * w, int (*p_task)(cmp_file_s *))
+{
+    assert(w && p_task);
+    pthread_mutex_lock(&w->mutex);
+    assert(!w->p_task);
+    w->p_task = p_task;
+    w->ret = 0;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+}
+
+/* Attend la fin de la tâche en cours du thread "w".
+ * Renvoie la valeur de retour de la tâche. */
+static int io_worker_wait(io_worker_s * w)
+{
+    assert(w);
+    pthread_mutex_lock(&w->mutex);
+    while (w->p_task)
+        pthread_cond_wait(&w->cond, &w->mutex);
+    const int ret = w->ret;
+    pthread_mutex_unlock(&w->mutex);
+    return ret;
+}
+
+/* Attend la fin de la tâche en cours du thread "w", puis l'arrête. */
+static void io_worker_stop(io_worker_s * w)
+{
+    assert(w);
+    pthread_mutex_lock(&w->mutex);
+    w->stop = TRUE;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+    pthread_join(w->thread, NULL);
+    pthread_cond_destroy(&w->cond);
+    pthread_mutex_destroy(&w->mutex);
+}
+
+/* # Lecture ================================================================ */
+
+/* Projette le fichier entrant de "cf" en mémoire s'il s'agit d'un fichier
+ * régulier non vide, et signale au noyau une lecture séquentielle. La lecture
+ * reprend à la position courante du fichier (par exemple après la lecture de
+ * l'en-tête). Sinon (tube, fichier vide, échec de la projection), le fichier
+ * sera lu avec "fread". */
+static void cmpf_map_file(cmp_file_s * cf)
+{
+    assert(cf && cf->fp_in);
+    struct stat file_stat;
+    const long pos = ftell(cf->fp_in);
+    if (fstat(fileno(cf->fp_in), &file_stat) || !S_ISREG(file_stat.st_mode)
+        || !file_stat.st_size || pos < 0 || pos > file_stat.st_size)
+        return;
+    void *p_map = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE,
+                       fileno(cf->fp_in), 0);
+    if (p_map == MAP_FAILED)
+        return;
+    madvise(p_map, file_stat.st_size, MADV_SEQUENTIAL);
+    cf->p_mem_in = p_map;
+    cf->mem_in_size = cf->map_size = file_stat.st_size;
+    cf->mem_in_start = cf->mem_in_pos = cf->map_ahead = pos;
+}
+
+/* Renvoie la taille d'une page mémoire, sur laquelle les buffers d'écriture
+ * et les écritures directes sont alignés. */
+static size_t io_page_size(void)
+{
+    const long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t) size : 4096;
+}
+
+/* Tâche de somme de contrôle : ajoute à la somme du fichier entrant de "cf"
+ * les bytes de la zone mémoire entrante jusqu'à "sum_end".
+ * Renvoie toujours 0. */
+static int cmpf_sum_task(cmp_file_s * cf)
+{
+    assert(cf && cf->p_mem_in && cf->sum_pos <= cf->sum_end);
+    cf->in_checksum = crc32c_update(cf->in_checksum,
+                                    cf->p_mem_in + cf->sum_pos,
+                                    cf->sum_end - cf->sum_pos);
+    cf->sum_pos = cf->sum_end;
+    return 0;
+}
+
+/* Demande au noyau de charger en avance la fenêtre de IO_MAP_AHEAD bytes qui
+ * suit la position de lecture du fichier projeté de "cf", sans attendre, et
+ * fait calculer la somme de contrôle de la fenêtre par le thread de lecture
+ * si elle est demandée. La demande suivante aura lieu au milieu de cette
+ * fenêtre. */
+static void cmpf_map_ahead(cmp_file_s * cf)
+{
+    assert(cf && cf->map_size);
+    const size_t start = cf->mem_in_pos / io_page_size() * io_page_size();
+    const size_t end = start + IO_MAP_AHEAD < cf->map_size
+        ? start + IO_MAP_AHEAD : cf->map_size;
+    madvise((byte_t *) cf->p_mem_in + start, end - start, MADV_WILLNEED);
+    cf->map_ahead = start + IO_MAP_AHEAD / 2;
+    if (cf->sum_in && cf->reader_on && end > cf->sum_end
+        && cf->sum_end < cf->mem_in_size) {
+        const uint64_t wait_start = io_time_ns();
+        if (cf->read_ahead)
+            io_worker_wait(&cf->reader);
+        cf->read_ns += io_time_ns() - wait_start;
+        cf->sum_end = end < cf->mem_in_size ? end : cf->mem_in_size;
+        io_worker_submit(&cf->reader, cmpf_sum_task);
+        cf->read_ahead = TRUE;
+    }
+}
+
+/* Lit un bloc directement depuis la zone mémoire entrante de "cf" et le stocke
+ * dans "b". Le dernier bloc est complété par des octets à 0.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur produite.
+ * Erreurs : ERR_IO_FREAD_EOF si on à déjà lu la fin de la zone mémoire. */
+static inline int cmpf_mem_get_block(cmp_file_s * cf, block_t * b)
+{
+    assert(cf && cf->p_mem_in && b);
+    if (cf->mem_in_pos >= cf->map_ahead)
+        cmpf_map_ahead(cf);
+    const size_t left = cf->mem_in_size - cf->mem_in_pos;
+    if (left >= BLOCK_SIZE) {
+        memcpy(b, cf->p_mem_in + cf->mem_in_pos, BLOCK_SIZE);
+        cf->mem_in_pos += BLOCK_SIZE;
+        return 0;
+    }
+    if (!left)
+        return cf->err = ERR_IO_FREAD_EOF, -1;
+    *b = 0;
+    memcpy(b, cf->p_mem_in + cf->mem_in_pos, left);
+    cf->mem_in_pos += left;
+    return 0;
+}
+
+/* Ajoute "size" bytes de "p_src" à la zone mémoire sortante de "cf", en
+ * l'agrandissant si besoin.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur produite.
+ * Erreurs : ERR_IO_FWRITE si la zone mémoire ne peut pas être agrandie. */
+static int cmpf_mem_write(cmp_file_s * cf, const void *p_src, size_t size)
+{
+    assert(cf && p_src);
+    if (cf->mem_out_size + size > cf->mem_out_cap) {
+        size_t cap = cf->mem_out_cap ? cf->mem_out_cap : IO_BUFFER_SIZE;
+        while (cap < cf->mem_out_size + size)
+            cap <<= 1;
+        byte_t *p_tmp = realloc(cf->p_mem_out, cap);
+        if (!p_tmp)
+            return cf->err = ERR_IO_FWRITE, -1;
+        cf->p_mem_out = p_tmp;
+        cf->mem_out_cap = cap;
+    }
+    memcpy(cf->p_mem_out + cf->mem_out_size, p_src, size);
+    if (cf->sum_out)
+        cf->out_checksum = crc32c_update(cf->out_checksum, p_src, size);
+    cf->mem_out_size += size;
+    cf->out_total += size;
+    return 0;
+}
+
+/* Tâche de lecture : charge le buffer de lecture qui n'est pas le buffer
+ * courant de "cf" depuis le fichier entrant, après ses IO_TRAILER_MAX
+ * premiers bytes, stocke le nombre de bytes lus dans "read_next" et les
+ * ajoute à la somme de contrôle si elle est demandée.
+ * Renvoie 0 sur un succès (fin du fichier comprise), ou -1 si une erreur
+ * intervient pendant "fread". */
+static int cmpf_read_task(cmp_file_s * cf)
+{
+    assert(cf && cf->fp_in);
+    byte_t *p_buf = cf->a_p_read[!cf->read_cur] + IO_TRAILER_MAX;
+    cf->read_next = fread(p_buf, sizeof(byte_t), IO_READ_SIZE, cf->fp_in);
+    if (cf->read_next < IO_READ_SIZE && ferror(cf->fp_in))
+        return -1;
+    if (cf->sum_in)
+        cf->in_checksum = crc32c_update(cf->in_checksum, p_buf,
+                                        cf->read_next);
+    return 0;
+}
+
+/* Lit le fichier source de "cf" depuis le disque et le stocke dans son buffer
+ * de lecture courant. Avec le thread de lecture, le buffer a été chargé en
+ * avance, et le chargement du suivant est lancé aussitôt. Les bytes retenus
+ * du chargement précédent sont replacés devant les nouveaux, dont les
+ * "trailer_size" derniers sont retenus à leur tour.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur produite.
  * Erreurs : ERR_IO_FREAD si une erreur intervient pendant "fread", ou
  * ERR_IO_FREAD_EOF si on essaye de lire tandis que la fin du fichier à déjà été
  * atteinte. */
 static int cmpf_read_file(cmp_file_s * cf)
 {
-    assert(cf && cf->fp_in && cf->a_read_stream);
-    /* Padding à 0, car sinon il peut rester des anciens bits sur les blocs non
-     * complètement remplis. */
-    memset(cf->a_read_stream, '\0', IO_BUFFER_SIZE * BLOCK_SIZE);
-    /* Lecture sur le disque. */
-    if (!(cf->nb_bytes = fread(cf->a_read_stream, sizeof(byte_t),
-                               BLOCK_SIZE * IO_BUFFER_SIZE, cf->fp_in))) {
-        /* Si on était déjà à la fin du fichier. */
-        if (feof(cf->fp_in))
-            CMP_err = ERR_IO_FREAD_EOF;
-        /* Si une erreur s'est produite. */
-        else if (ferror(cf->fp_in))
-            perror("fread"), CMP_err = ERR_IO_FREAD;
-        return -1;
-    }
-    cf->nb_blocks = cf->nb_bytes >> 3;  /* log(BLOCK_SIZE) en base 2 : pos bit le
-                                           plus à gauche */
-    /* Si division pas entière. */
-    if (cf->nb_bytes & (BLOCK_SIZE - 1))
-        cf->nb_blocks++;
-    /* Réinitialisation du pointeur de lecture. */
-    cf->p_read = cf->a_read_stream;
-    assert(cf->nb_bytes && cf->nb_blocks && cf->p_read);
-    return 0;
-}
-
-/* Écris le bloc "blck" sur le fichier pointé par "p_stream" en supprimant les
- * octets égaux à 0 en fin de bloc.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et postionne "CMP_err" sur
- * l'erreur produite.
- * Erreurs : ERR_IO_FWRITE si une erreur survient pendant l'écriture avec
- * "fwrite". */
-static int blck_write_parse(block_t blck, FILE * p_stream)
-{
-    assert(p_stream);
-    block_t mask = 0xFF;
-    for (int i = 0; i < BLOCK_SIZE; i++) {
-        if (blck & mask || blck) {
-            if (!fwrite(&blck, sizeof(byte_t), 1, p_stream))
-                return CMP_err = ERR_IO_FWRITE, perror("fwrite"), -1;
+    assert(cf && cf->fp_in && cf->a_p_read[0]);
+    /* Si le chargement précédent a déjà atteint la fin du fichier. */
+    if (cf->read_eof)
+        return cf->err = ERR_IO_FREAD_EOF, -1;
+    /* Lecture sur le disque, ou attente de la lecture anticipée. */
+    const uint64_t start = io_time_ns();
+    int ret;
+    if (cf->reader_on) {
+        if (!cf->read_ahead)
+            io_worker_submit(&cf->reader, cmpf_read_task);
+        ret = io_worker_wait(&cf->reader);
+        cf->read_ahead = FALSE;
+    } else
+        ret = cmpf_read_task(cf);
+    cf->read_ns += io_time_ns() - start;
+    if (ret)
+        return cf->err = ERR_IO_FREAD, -1;
+    cf->read_cur = !cf->read_cur;
+    /* Un chargement incomplet signifie que la fin du fichier est atteinte. */
+    cf->read_eof = cf->read_next < IO_READ_SIZE;
+    byte_t *p_buf = cf->a_p_read[cf->read_cur];
+    const size_t avail = cf->trailer_held + cf->read_next;
+    const size_t held = avail < cf->trailer_size ? avail : cf->trailer_size;
+    cf->read_pos = IO_TRAILER_MAX - cf->trailer_held;
+    memcpy(p_buf + cf->read_pos, cf->a_trailer, cf->trailer_held);
+    cf->nb_bytes = cf->read_pos + avail - held;
+    memcpy(cf->a_trailer, p_buf + cf->nb_bytes, held);
+    cf->trailer_held = held;
+    /* Lecture anticipée du buffer suivant pendant le traitement de
+     * celui-ci. */
+    if (cf->reader_on && !cf->read_eof) {
+        io_worker_submit(&cf->reader, cmpf_read_task);
+        cf->read_ahead = TRUE;
+    }
+    if (cf->nb_bytes == cf->read_pos)
+        return cf->err = ERR_IO_FREAD_EOF, -1;
+    /* Les bytes chargés ne sont rendus que s'ils sont du texte. */
+    if (cf->text_in && !io_is_text(p_buf + cf->read_pos,
+                                   cf->nb_bytes - cf->read_pos))
+        return cf->err = ERR_NOT_TEXT, -1;
+    cf->in_total += cf->nb_bytes - cf->read_pos;
+    return 0;
+}
+
+/* # Écriture =============================================================== */
+
+/* Écris les "nb_iov" zones de "a_iov" sur le descripteur "fd", en reprenant
+ * après une écriture partielle ou interrompue. "a_iov" est modifié.
+ * Renvoie 0 sur un succès, ou -1 si une erreur survient pendant l'écriture. */
+static int io_writev(const int fd, struct iovec *a_iov, int nb_iov)
+{
+    assert(a_iov);
+    while (nb_iov) {
+        ssize_t nb_bytes = writev(fd, a_iov, nb_iov);
+        if (nb_bytes < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        for (; nb_iov && (size_t)nb_bytes >= a_iov->iov_len; a_iov++, nb_iov--)
+            nb_bytes -= a_iov->iov_len;
+        if (nb_iov) {
+            a_iov->iov_base = (byte_t *) a_iov->iov_base + nb_bytes;
+            a_iov->iov_len -= nb_bytes;
         }
-        blck >>= CHAR_BIT;
     }
     return 0;
 }
 
-/* Vide le buffer d'écriture du fichier de sortie de "cf" sur le disque.
- * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne "CMP_err" sur
- * l'erreur correspondante.
- * Erreurs : ERR_IO_FWRITE si une erreur survient pendant l'écriture avec
- * "fwrite". */
-static int cmpf_write_file(cmp_file_s * cf)
+/* Active ou désactive l'écriture directe (O_DIRECT) du fichier sortant de
+ * "cf". Elle n'est activée que si la position dans le fichier est alignée sur
+ * une page, et reste désactivée si le système la refuse (tube, système de
+ * fichiers sans support). */
+static void cmpf_set_direct(cmp_file_s * cf, const int direct)
 {
-    assert(cf && cf->a_write_stream && cf->p_write && cf->fp_out);
-    /* Écriture sur le disque sans le dernier bloc. */
-    if ((cf->p_write - cf->a_write_stream - 1) &&
-        !fwrite(cf->a_write_stream, sizeof(block_t),
-                cf->p_write - cf->a_write_stream - 1, cf->fp_out)) {
-        return CMP_err = ERR_IO_FWRITE, perror("fwrite"), -1;
+    assert(cf && cf->fd_out >= 0);
+#ifdef O_DIRECT
+    const int flags = fcntl(cf->fd_out, F_GETFL);
+    if (flags < 0)
+        return;
+    if (direct) {
+        const off_t pos = lseek(cf->fd_out, 0, SEEK_CUR);
+        if (pos < 0 || pos % io_page_size())
+            return;
     }
-    /* Écris le dernier bloc sans les bits à 0 en trop. */
-    if (blck_write_parse(*(cf->p_write - 1), cf->fp_out))
+    if (!fcntl(cf->fd_out, F_SETFL, direct ? flags | O_DIRECT
+               : flags & ~O_DIRECT))
+        cf->direct = direct;
+#endif
+}
+
+/* Alloue les deux buffers d'écriture de "cf", de "size" bytes chacun
+ * (multiple d'une page), en libérant les précédents.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur produite.
+ * Erreurs : ERR_OTHER si la mémoire ne peut pas être allouée. */
+static int cmpf_write_alloc(cmp_file_s * cf, const size_t size)
+{
+    assert(cf && !cf->write_pos && !cf->write_wait);
+    assert(size && !(size % io_page_size()));
+    for (int i = 0; i < 2; i++) {
+        void *p_buf;
+        free(cf->a_p_write[i]), cf->a_p_write[i] = NULL;
+        if (posix_memalign(&p_buf, io_page_size(), size))
+            return cf->write_size = 0, cf->err = ERR_OTHER, -1;
+        cf->a_p_write[i] = p_buf;
+    }
+    cf->write_size = size;
+    return 0;
+}
+
+/* Tâche d'écriture : écris le buffer d'écriture en attente de "cf" sur le
+ * fichier sortant, après l'avoir ajouté à la somme de contrôle si elle est
+ * demandée.
+ * Renvoie 0 sur un succès, ou -1 si une erreur survient pendant l'écriture. */
+static int cmpf_write_task(cmp_file_s * cf)
+{
+    assert(cf && cf->fd_out >= 0);
+    struct iovec iov = { cf->a_p_write[!cf->write_cur], cf->write_wait };
+    if (cf->sum_out)
+        cf->out_checksum = crc32c_update(cf->out_checksum, iov.iov_base,
+                                         iov.iov_len);
+    return io_writev(cf->fd_out, &iov, 1);
+}
+
+/* Attend la fin de l'écriture du buffer en attente de "cf" par le thread
+ * d'écriture, s'il y en a une en cours. Le buffer est alors libre.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient pendant l'écriture. */
+static int cmpf_write_wait(cmp_file_s * cf)
+{
+    assert(cf);
+    if (!cf->writer_on || !cf->write_wait)
+        return 0;
+    const uint64_t start = io_time_ns();
+    const int ret = io_worker_wait(&cf->writer);
+    cf->write_ns += io_time_ns() - start;
+    if (ret)
+        return cf->err = ERR_IO_FWRITE, -1;
+    cf->out_total += cf->write_wait;
+    cf->write_wait = 0;
+    return 0;
+}
+
+/* Écris sur le fichier sortant de "cf", en un seul appel système, le buffer
+ * en attente, le buffer courant, puis les "size" bytes de "p_src" (sans copie,
+ * peut être NULL si "size" est nul). Les buffers sont alors vides. Avec le
+ * thread d'écriture, le buffer en attente a déjà été écrit par celui-ci.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient pendant l'écriture. */
+static int cmpf_write_file(cmp_file_s * cf, const byte_t * p_src,
+                           const size_t size)
+{
+    assert(cf && cf->fd_out >= 0 && (p_src || !size));
+    if (cmpf_write_wait(cf))
+        return -1;
+    struct iovec a_iov[3] = {
+        {cf->a_p_write[!cf->write_cur], cf->write_wait},
+        {cf->a_p_write[cf->write_cur], cf->write_pos},
+        {(void *)p_src, size}
+    };
+    const uint64_t start = io_time_ns();
+    if (cf->sum_out)
+        for (int i = 0; i < 3; i++)
+            cf->out_checksum = crc32c_update(cf->out_checksum,
+                                             a_iov[i].iov_base,
+                                             a_iov[i].iov_len);
+    /* Une écriture directe doit avoir une taille multiple d'une page : la
+     * fin du flux, de taille quelconque, passe par le cache du système. */
+    if (cf->direct && (size || cf->write_pos % io_page_size()))
+        cmpf_set_direct(cf, FALSE);
+    if (io_writev(cf->fd_out, a_iov, 3))
+        return cf->err = ERR_IO_FWRITE, -1;
+    cf->out_total += cf->write_wait + cf->write_pos + size;
+    cf->write_wait = cf->write_pos = 0;
+    cf->write_ns += io_time_ns() - start;
+    return 0;
+}
+
+/* Libère le buffer d'écriture courant de "cf", qui est plein : il est mis en
+ * attente et confié au thread d'écriture une fois l'autre buffer écrit. Sans
+ * thread d'écriture, il est mis en attente si l'autre buffer est libre, sinon
+ * les deux buffers sont écrits.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur correspondante.
+ * Erreurs : ERR_IO_FWRITE si une erreur survient pendant l'écriture. */
+static int cmpf_write_next(cmp_file_s * cf)
+{
+    assert(cf && cf->write_pos == cf->write_size);
+    if (cf->writer_on ? cmpf_write_wait(cf) : cf->write_wait
+        && cmpf_write_file(cf, NULL, 0))
         return -1;
-    /* Réinitialisation du pointeur d'écriture. */
-    cf->p_write = cf->a_write_stream;
+    cf->write_wait = cf->write_pos;
+    cf->write_cur = !cf->write_cur;
+    cf->write_pos = 0;
+    if (cf->writer_on)
+        io_worker_submit(&cf->writer, cmpf_write_task);
+    return 0;
+}
+
+/* Initialise les variables de "cf" pour des flux qui n'ont pas encore été
+ * lus ni écrits. */
+static void cmpf_init(cmp_file_s * cf)
+{
+    assert(cf);
+    cf->fp_in = cf->fp_out = NULL;
+    cf->p_mem_in = cf->p_mem_out = NULL;
+    cf->mem_in_size = cf->mem_in_start = cf->mem_in_pos = cf->mem_out_size =
+        cf->mem_out_cap = cf->map_size = 0;
+    cf->map_ahead = SIZE_MAX;
+    cf->a_p_read[0] = cf->a_p_read[1] = NULL;
+    cf->read_cur = 0;
+    cf->nb_bytes = cf->read_pos = cf->read_next = 0;
+    cf->read_ahead = FALSE;
+    cf->in_total = cf->out_total = 0;
+    cf->read_ns = cf->write_ns = 0;
+    cf->out_expected = IO_SIZE_UNKNOWN;
+    cf->read_eof = FALSE;
+    cf->trailer_size = cf->trailer_held = 0;
+    cf->text_in = cf->sum_in = cf->sum_out = cf->check_out = FALSE;
+    cf->in_checksum = cf->out_checksum = cf->out_sum_expected = CRC32C_INIT;
+    cf->sum_pos = cf->sum_end = 0;
+    cf->fd_out = -1;
+    cf->direct = FALSE;
+    cf->a_p_write[0] = cf->a_p_write[1] = NULL;
+    cf->write_size = cf->write_pos = cf->write_wait = 0;
+    cf->write_cur = 0;
+    cf->reader_on = cf->writer_on = FALSE;
+    cf->err = ERR_NONE;
+}
+
+/* Alloue les buffers de lecture de "cf" si son fichier entrant n'est pas
+ * projeté, et démarre les threads de lecture et d'écriture. Un thread qui ne
+ * peut pas être créé est remplacé par des entrées/sorties synchrones.
+ * Renvoie 0 sur un succès, ou -1 sur une erreur et positionne l'erreur de
+ * "cf" sur l'erreur produite.
+ * Erreurs : ERR_OTHER si la mémoire ne peut pas être allouée. */
+static int cmpf_start_io(cmp_file_s * cf)
+{
+    assert(cf && cf->fp_in && cf->fd_out >= 0);
+    if (!cf->p_mem_in) {
+        for (int i = 0; i < 2; i++)
+            if (!(cf->a_p_read[i] = malloc(IO_TRAILER_MAX + IO_READ_SIZE)))
+                return cf->err = ERR_OTHER, -1;
+        cf->reader_on = !io_worker_start(&cf->reader, cf);
+    }
+    cf->writer_on = !io_worker_start(&cf->writer, cf);
     return 0;
 }
 
+/* Attend la fin des tâches en cours de "cf" et arrête ses threads de lecture
+ * et d'écriture. */
+static void cmpf_stop_io(cmp_file_s * cf)
+{
+    assert(cf);
+    if (cf->reader_on)
+        io_worker_stop(&cf->reader), cf->reader_on = FALSE;
+    if (cf->writer_on)
+        io_worker_stop(&cf->writer), cf->writer_on = FALSE;
+    cf->read_ahead = FALSE;
+}
+
 /* Fonctions publiques ====================================================== */
 
+FILE *io_fopen(const char *s_filepath, const char *s_mode)
+{
+    if (!s_filepath || !s_mode)
+        return errno = EINVAL, NULL;
+    FILE *fp = !strcmp(s_filepath, IO_STD_PATH) ?
+        (s_mode[0] == 'r' ? stdin : stdout) : fopen(s_filepath, s_mode);
+    if (!fp)
+        return NULL;
+    /* Gros buffer : moins d'appels système sur les tubes. */
+    setvbuf(fp, NULL, _IOFBF, IO_STREAM_BUFFER_SIZE);
+    return fp;
+}
+
+uint64_t io_time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int io_is_text(const byte_t * p_data, const size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (!p_data[i] || p_data[i] > 0x7F)
+            return FALSE;
+    }
+    return TRUE;
+}
+
 cmp_file_s *cmpf_open(const char *s_filepath_in, const char *s_filepath_out)
 {
-    /* Ouverture des fichiers. */
+    FILE *fp_in = io_fopen(s_filepath_in, "rb"), *fp_out;
+    if (!fp_in)
+        return NULL;
+    if (!(fp_out = io_fopen(s_filepath_out, "wb")))
+        return fclose(fp_in), NULL;
+    return cmpf_open_fp(fp_in, fp_out);
+}
+
+cmp_file_s *cmpf_open_fp(FILE * fp_in, FILE * fp_out)
+{
+    if (!fp_in || !fp_out)
+        return NULL;
+    /* Initilisation des variables. */
     cmp_file_s *cf = malloc(sizeof(cmp_file_s));
-    if (!(cf->fp_in = fopen(s_filepath_in, "rb")) ||
-        !(cf->fp_out = fopen(s_filepath_out, "wb"))) {
-        perror("fopen for file initialization");
-        exit(EXIT_FAILURE);
+    if (!cf) {
+        fclose(fp_in), fclose(fp_out);
+        return NULL;
+    }
+    cmpf_init(cf);
+    cf->fp_in = fp_in;
+    cf->fp_out = fp_out;
+    /* Le fichier sortant est écrit sur son descripteur : le buffer de
+     * "stdio" doit être vide. */
+    cf->fd_out = fileno(fp_out);
+    const int ret = fflush(fp_out) ? -1
+        : cmpf_write_alloc(cf, IO_WRITE_SIZE);
+    /* Projection en mémoire du fichier entrant si possible, sinon lecture
+     * anticipée. */
+    if (ret || (cmpf_map_file(cf), cmpf_start_io(cf))) {
+        cmpf_stop_io(cf);
+        if (cf->map_size)
+            munmap((void *)cf->p_mem_in, cf->map_size);
+        fclose(fp_in), fclose(fp_out);
+        free(cf->a_p_read[0]), free(cf->a_p_read[1]);
+        free(cf->a_p_write[0]), free(cf->a_p_write[1]), free(cf);
+        return NULL;
     }
-    /* Initilisation des variables. */
-    cf->nb_blocks = cf->nb_bytes = cf->a_read_stream[0] =
-        cf->a_write_stream[0] = 0;
-    cf->p_read = cf->p_write = NULL;
-    assert(cf->fp_in && cf->fp_out);
+    return cf;
+}
+
+cmp_file_s *cmpf_open_mem(const byte_t * p_in, const size_t in_size)
+{
+    if (!p_in && in_size)
+        return NULL;
+    cmp_file_s *cf = malloc(sizeof(cmp_file_s));
+    if (!cf)
+        return NULL;
+    /* Initilisation des variables, zone entrante vide si "in_size" nul. */
+    cmpf_init(cf);
+    cf->p_mem_in = in_size ? p_in : (const byte_t *)"";
+    cf->mem_in_size = in_size;
     return cf;
 }
 
 inline int cmpf_get_block(cmp_file_s * cf, block_t * b)
 {
-    if (!cf || !b)
-        return CMP_err = ERR_BAD_ADRESS, -1;
-    assert(cf->a_read_stream);
-    /* Si c'est la première lecture dans ce buffer ou que l'on arrive à la fin,
-     * on le remplis de nouveau. */
-    if (!cf->p_read || (cf->p_read == &(cf->a_read_stream[IO_BUFFER_SIZE]))) {
-        if (cmpf_read_file(cf))
-            return -1;
+    if (!cf)
+        return -1;
+    if (!b)
+        return cf->err = ERR_BAD_ADRESS, -1;
+    /* Zone mémoire ou fichier projeté : lecture directe, sans copie dans le
+     * buffer de lecture. */
+    if (cf->p_mem_in)
+        return cmpf_mem_get_block(cf, b);
+    assert(cf->a_p_read[cf->read_cur]);
+    /* Cas courant : un bloc entier est disponible dans le buffer. */
+    if (cf->nb_bytes - cf->read_pos >= BLOCK_SIZE) {
+        memcpy(b, cf->a_p_read[cf->read_cur] + cf->read_pos, BLOCK_SIZE);
+        cf->read_pos += BLOCK_SIZE;
+        return 0;
     }
-    /* Si on déjà lu la fin du fichier dans le buffer. */
-    else if (cf->p_read == &(cf->a_read_stream[cf->nb_blocks]))
-        return CMP_err = ERR_IO_FREAD_EOF, -1;
-    /* Lit le bloc du buffer et met à jours l'adresse du prochain bloc à lire. */
-    *b = *(cf->p_read++);
-    assert(cf->p_read);
-    return 0;
+    /* Sinon, le bloc est à cheval sur deux chargements ou est le dernier du
+     * fichier : il est complété par des octets à 0. */
+    *b = 0;
+    return cmpf_get_bytes(cf, (byte_t *) b, BLOCK_SIZE) ? 0 : -1;
+}
+
+size_t cmpf_get_bytes(cmp_file_s * cf, byte_t * p_dest, const size_t size)
+{
+    if (!cf)
+        return 0;
+    if (!p_dest && size)
+        return cf->err = ERR_BAD_ADRESS, 0;
+    size_t done = 0;
+    while (done < size) {
+        size_t nb_bytes;
+        /* Zone mémoire ou fichier projeté : copie directe. */
+        if (cf->p_mem_in) {
+            if (cf->mem_in_pos >= cf->map_ahead)
+                cmpf_map_ahead(cf);
+            if (!(nb_bytes = cf->mem_in_size - cf->mem_in_pos)) {
+                cf->err = ERR_IO_FREAD_EOF;
+                break;
+            }
+            nb_bytes = nb_bytes < size - done ? nb_bytes : size - done;
+            memcpy(p_dest + done, cf->p_mem_in + cf->mem_in_pos, nb_bytes);
+            cf->mem_in_pos += nb_bytes;
+        } else {
+            /* Rechargement du buffer s'il est entièrement lu. */
+            if (cf->read_pos == cf->nb_bytes && cmpf_read_file(cf))
+                break;
+            nb_bytes = cf->nb_bytes - cf->read_pos;
+            nb_bytes = nb_bytes < size - done ? nb_bytes : size - done;
+            memcpy(p_dest + done, cf->a_p_read[cf->read_cur] + cf->read_pos,
+                   nb_bytes);
+            cf->read_pos += nb_bytes;
+        }
+        done += nb_bytes;
+    }
+    return done;
 }
 
 inline int cmpf_put_block(cmp_file_s * cf, const block_t b)
 {
     if (!cf)
-        return CMP_err = ERR_BAD_ADRESS, -1;
-    assert(cf->a_write_stream);
-    /* Si c'est la première écriture dans ce buffer. */
-    if (!cf->p_write)
-        cf->p_write = cf->a_write_stream;
-    /* Si le buffer est plein, on le vide sur le disque. */
-    if (cf->p_write == &(cf->a_write_stream[IO_BUFFER_SIZE])
-        && cmpf_write_file(cf))
         return -1;
-    /* Écris le bloc dans le buffer et met à jours l'adresse du prochain bloc
-     * à écrire. */
-    *(cf->p_write++) = b;
-    /* Padding à 0 du bloc après le dernier bloc. */
-    if (cf->p_write != &(cf->a_write_stream[IO_BUFFER_SIZE]))
-        *cf->p_write = 0;
-    assert(cf->p_write);
+    /* Zone mémoire : écriture directe. */
+    if (cf->fd_out < 0)
+        return cmpf_mem_write(cf, &b, BLOCK_SIZE);
+    /* Bloc à cheval sur deux buffers (en-tête de taille quelconque écrit
+     * avant les blocs) : écrit en deux morceaux. */
+    if (cf->write_size - cf->write_pos < BLOCK_SIZE)
+        return cmpf_put_bytes(cf, (const byte_t *)&b, BLOCK_SIZE);
+    memcpy(cf->a_p_write[cf->write_cur] + cf->write_pos, &b, BLOCK_SIZE);
+    cf->write_pos += BLOCK_SIZE;
+    return 0;
+}
+
+int cmpf_put_bytes(cmp_file_s * cf, const byte_t * p_src, const size_t size)
+{
+    if (!cf)
+        return -1;
+    if (!p_src && size)
+        return cf->err = ERR_BAD_ADRESS, -1;
+    if (cf->fd_out < 0)
+        return size ? cmpf_mem_write(cf, p_src, size) : 0;
+    size_t done = 0;
+    while (done < size) {
+        /* Gros morceau : écrit sans copie à la suite des buffers, en un seul
+         * appel système (sauf en écriture directe, qui doit être alignée). */
+        if (!cf->direct && size - done >= cf->write_size)
+            return cmpf_write_file(cf, p_src + done, size - done);
+        /* Si le buffer courant est plein, on passe au suivant. */
+        if (cf->write_pos == cf->write_size && cmpf_write_next(cf))
+            return -1;
+        size_t nb_bytes = cf->write_size - cf->write_pos;
+        nb_bytes = nb_bytes < size - done ? nb_bytes : size - done;
+        memcpy(cf->a_p_write[cf->write_cur] + cf->write_pos, p_src + done,
+               nb_bytes);
+        cf->write_pos += nb_bytes;
+        done += nb_bytes;
+    }
     return 0;
 }
 
-int cmpf_close(cmp_file_s * cf)
+int cmpf_set_output(cmp_file_s * cf, const size_t buf_size, const int direct)
 {
     if (!cf)
-        return CMP_err = ERR_BAD_ADRESS, -1;
-    /* Vide le buffer avant la fermeture des flux. */
-    if (cf->p_write && cmpf_write_file(cf))
         return -1;
-    /* Ferme les fichiers. */
-    fclose(cf->fp_in);
-    fclose(cf->fp_out);
+    /* Zone mémoire : pas de buffer d'écriture. */
+    if (cf->fd_out < 0)
+        return 0;
+    /* Le buffer en attente doit être écrit avant de changer de mode. */
+    if (cmpf_write_wait(cf))
+        return -1;
+    /* Taille arrondie à la page supérieure. */
+    const size_t page = io_page_size();
+    const size_t size = buf_size ? (buf_size + page - 1) / page * page
+        : IO_WRITE_SIZE;
+    if (size != cf->write_size) {
+        /* Le contenu des buffers doit être écrit avant de les remplacer. */
+        if ((cf->write_pos || cf->write_wait) && cmpf_write_file(cf, NULL, 0))
+            return -1;
+        if (cmpf_write_alloc(cf, size))
+            return -1;
+    }
+    if (direct != cf->direct)
+        cmpf_set_direct(cf, direct);
+    return 0;
+}
+
+err_code_e cmpf_close(cmp_file_s * cf)
+{
+    if (!cf)
+        return ERR_BAD_ADRESS;
+    /* Vide les buffers avant la fermeture des flux, puis vérifie la taille
+     * du flux sortant si elle est connue. */
+    err_code_e err = ERR_NONE;
+    if (cf->fd_out >= 0 && (cf->write_pos || cf->write_wait)
+        && cmpf_write_file(cf, NULL, 0))
+        err = cf->err;
+    else if (cf->out_expected != IO_SIZE_UNKNOWN
+             && cf->out_total != cf->out_expected)
+        err = ERR_IO_SIZE;
+    else if (cf->check_out && cf->out_checksum != cf->out_sum_expected)
+        err = ERR_CHECKSUM;
+    cmpf_stop_io(cf);
+    /* Supprime la projection et ferme les fichiers. */
+    if (cf->map_size)
+        munmap((void *)cf->p_mem_in, cf->map_size);
+    if (cf->fp_in)
+        fclose(cf->fp_in);
+    if (cf->fp_out && fclose(cf->fp_out))
+        err = ERR_IO_FCLOSE;
     /* Libère la mémoire. */
+    free(cf->p_mem_out);
+    free(cf->a_p_read[0]), free(cf->a_p_read[1]);
+    free(cf->a_p_write[0]), free(cf->a_p_write[1]);
+    free(cf), cf = NULL;
+    return err;
+}
+
+err_code_e cmpf_close_mem(cmp_file_s * cf, byte_t ** pp_out,
+                          size_t * p_out_size)
+{
+    if (!cf || !pp_out || !p_out_size)
+        return ERR_BAD_ADRESS;
+    assert(!cf->fp_in && !cf->fp_out);
+    /* La zone mémoire sortante est déjà complète. */
+    if (cf->out_expected != IO_SIZE_UNKNOWN
+        && cf->out_total != cf->out_expected) {
+        free(cf->p_mem_out), free(cf);
+        return ERR_IO_SIZE;
+    }
+    /* Transfère la zone mémoire sortante à l'appelant. */
+    *pp_out = cf->p_mem_out;
+    *p_out_size = cf->mem_out_size;
     free(cf), cf = NULL;
+    return ERR_NONE;
+}
+
+int cmpf_get_size(const cmp_file_s * cf, uint64_t * p_size)
+{
+    if (!cf || !p_size)
+        return -1;
+    /* Zone mémoire ou fichier projeté. */
+    if (cf->p_mem_in) {
+        *p_size = cf->mem_in_size - cf->mem_in_start;
+        return 0;
+    }
+    /* Seul un fichier régulier a une taille connue à l'avance. */
+    struct stat file_stat;
+    if (!cf->fp_in || fstat(fileno(cf->fp_in), &file_stat)
+        || !S_ISREG(file_stat.st_mode))
+        return -1;
+    *p_size = file_stat.st_size;
+    return 0;
+}
+
+void cmpf_get_totals(const cmp_file_s * cf, uint64_t * p_in,
+                     uint64_t * p_out)
+{
+    assert(cf && p_in && p_out);
+    *p_in = cf->p_mem_in ? cf->mem_in_pos - cf->mem_in_start
+        : cf->in_total - (cf->nb_bytes - cf->read_pos);
+    *p_out = cf->out_total + cf->write_wait + cf->write_pos;
+}
+
+void cmpf_get_times(const cmp_file_s * cf, uint64_t * p_read_ns,
+                    uint64_t * p_write_ns)
+{
+    assert(cf && p_read_ns && p_write_ns);
+    *p_read_ns = cf->read_ns;
+    *p_write_ns = cf->write_ns;
+}
+
+int cmpf_set_size(cmp_file_s * cf, const uint64_t size)
+{
+    if (!cf)
+        return -1;
+    cf->out_expected = size;
+    /* Zone mémoire : allouée en une fois à sa taille finale. */
+    if (!cf->fp_out && size > cf->mem_out_cap && size <= SIZE_MAX) {
+        byte_t *p_tmp = realloc(cf->p_mem_out, size);
+        if (!p_tmp)
+            return cf->err = ERR_IO_FWRITE, -1;
+        cf->p_mem_out = p_tmp;
+        cf->mem_out_cap = size;
+    }
+    return 0;
+}
+
+int cmpf_set_text(cmp_file_s * cf)
+{
+    if (!cf)
+        return -1;
+    cf->text_in = TRUE;
+    /* Zone mémoire ou fichier projeté : vérifiée en une fois. Sinon, les
+     * bytes déjà chargés le sont ici, et les suivants à leur chargement. */
+    if (cf->p_mem_in ? !io_is_text(cf->p_mem_in + cf->mem_in_pos,
+                                   cf->mem_in_size - cf->mem_in_pos)
+        : !io_is_text(cf->a_p_read[cf->read_cur] + cf->read_pos,
+                      cf->nb_bytes - cf->read_pos))
+        return cf->err = ERR_NOT_TEXT, -1;
+    return 0;
+}
+
+int cmpf_set_checksum(cmp_file_s * cf, const int output)
+{
+    if (!cf)
+        return -1;
+    if (output) {
+        cf->sum_out = TRUE;
+        cf->out_checksum = CRC32C_INIT;
+        return 0;
+    }
+    cf->sum_in = TRUE;
+    cf->in_checksum = CRC32C_INIT;
+    cf->sum_pos = cf->sum_end = cf->mem_in_pos;
+    /* Fichier projeté : le thread de lecture, inutile au chargement, calcule
+     * la somme des fenêtres. S'il ne peut pas être créé, la somme est
+     * calculée à la fin. */
+    if (cf->map_size && !cf->reader_on)
+        cf->reader_on = !io_worker_start(&cf->reader, cf);
+    return 0;
+}
+
+uint32_t cmpf_get_checksum(cmp_file_s * cf)
+{
+    assert(cf && cf->sum_in);
+    if (cf->read_ahead)
+        io_worker_wait(&cf->reader);
+    /* Fin de la zone mémoire entrante qui n'a pas encore été comptée. */
+    if (cf->p_mem_in && cf->sum_pos < cf->mem_in_size) {
+        cf->sum_end = cf->mem_in_size;
+        cmpf_sum_task(cf);
+    }
+    return cf->in_checksum;
+}
+
+int cmpf_expect_checksum(cmp_file_s * cf, const uint32_t checksum)
+{
+    if (!cf)
+        return -1;
+    assert(cf->sum_out);
+    cf->check_out = TRUE;
+    cf->out_sum_expected = checksum;
+    return 0;
+}
+
+int cmpf_set_trailer(cmp_file_s * cf, const size_t size)
+{
+    if (!cf)
+        return -1;
+    assert(size <= IO_TRAILER_MAX && !cf->trailer_size);
+    /* Zone mémoire ou fichier projeté : la fin est retirée des données. */
+    if (cf->p_mem_in) {
+        if (cf->mem_in_size - cf->mem_in_pos < size)
+            return cf->err = ERR_IO_FREAD_EOF, -1;
+        cf->mem_in_size -= size;
+    }
+    cf->trailer_size = size;
+    return 0;
+}
+
+int cmpf_get_trailer(cmp_file_s * cf, byte_t * p_dest)
+{
+    if (!cf)
+        return -1;
+    if (!p_dest)
+        return cf->err = ERR_BAD_ADRESS, -1;
+    if (cf->p_mem_in) {
+        memcpy(p_dest, cf->p_mem_in + cf->mem_in_size, cf->trailer_size);
+        return 0;
+    }
+    /* Les données que l'algorithme n'a pas lues sont ignorées : les bytes
+     * retenus à la fin du fichier sont les derniers. */
+    while (!cf->read_eof)
+        if (cmpf_read_file(cf) && cf->err != ERR_IO_FREAD_EOF)
+            return -1;
+    cf->read_pos = cf->nb_bytes;
+    if (cf->trailer_held < cf->trailer_size)
+        return cf->err = ERR_IO_FREAD_EOF, -1;
+    memcpy(p_dest, cf->a_trailer, cf->trailer_size);
     return 0;
 }
 
+err_code_e cmpf_get_err(const cmp_file_s * cf)
+{
+    assert(cf);
+    return cf->err;
+}
+
+void cmpf_set_err(cmp_file_s * cf, const err_code_e err)
+{
+    assert(cf);
+    cf->err = err;
+}
+
+int cmpf_fail(cmp_file_s * cf, const err_code_e err)
+{
+    assert(cf);
+    /* La cause déjà inscrite (lecture, écriture, mémoire, etc.) est plus
+     * précise que l'échec de l'appelant. */
+    if (cf->err == ERR_NONE || cf->err == ERR_IO_FREAD_EOF)
+        cf->err = err;
+    return -1;
+}
+
 void cmpf_rewind(cmp_file_s * cf)
 {
-    assert(cf && cf->fp_in);
-    rewind(cf->fp_in);
-    cf->p_read = NULL;
+    assert(cf && (cf->fp_in || cf->p_mem_in));
+    /* La lecture anticipée en cours doit être terminée. */
+    if (cf->read_ahead)
+        io_worker_wait(&cf->reader), cf->read_ahead = FALSE;
+    if (cf->fp_in)
+        rewind(cf->fp_in);
+    cf->mem_in_pos = cf->mem_in_start;
+    if (cf->map_size)
+        cf->map_ahead = cf->mem_in_start;
+    cf->nb_bytes = cf->read_pos = 0;
+    cf->in_total = 0;
+    cf->read_eof = FALSE;
+    cf->trailer_held = 0;
+    /* La somme de contrôle du fichier entrant est recalculée depuis le
+     * début. */
+    cf->in_checksum = CRC32C_INIT;
+    cf->sum_pos = cf->sum_end = cf->mem_in_start;
+    cf->err = ERR_NONE;
 }
 
 inline byte_t blck_get_byte(const block_t blck, const int pos)
@@ -0,0 +1,502 @@
+/**
+ * \file libcompressor0.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Bibliothèque.
+ * \details Interface de la bibliothèque libcompressor0, qui permet de
+ * compresser et de décompresser des zones mémoires au sein d'un autre
+ * programme, sans lancer l'exécutable ni passer par le disque.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include "libcompressor0.h"
+#include "errors.h"
+#include "header.h"
+#include "parallel.h"
+#include "codec.h"
+#include "crc32c.h"
+#include "common.h"
+
+/* Macro-fonctions privées ================================================== */
+
+/* Valeur renvoyée par les fonctions sur des zones mémoires pour l'erreur
+ * "err" (toujours négative, voir cmp_error). */
+#define LIB_ERROR(err) (-2 - (int64_t) (err))
+
+/* Structures privées ======================================================= */
+
+/* Flux de compression ou de décompression. */
+struct cmp_stream {
+    mode_e mode;                /* Compression ou décompression. */
+    algo_e algo;                /* Algorithme de compression. */
+    cmp_write_f write;          /* Fonction de sortie. */
+    void *p_opaque;             /* Paramètre de la fonction de sortie. */
+    err_code_e err;             /* Dernière erreur survenue. */
+    header_s hdr;               /* En-tête du fichier compressé. */
+    int hdr_done;               /* Vrai si l'en-tête a été écrit ou lu. */
+    int chunks_done;            /* Vrai si l'en-tête de bloc nul qui termine
+                                   les blocs a été lu. */
+    byte_t *p_buf;              /* Données entrantes en attente. */
+    size_t buf_size;            /* Fin des données dans "p_buf". */
+    size_t buf_pos;             /* Début des données non traitées. */
+    size_t buf_cap;             /* Capacité de "p_buf". */
+    uint64_t raw_total;         /* Taille des données originales traitées. */
+    uint32_t checksum;          /* Somme de contrôle des données originales
+                                   traitées. */
+};
+
+/* Fonctions privées ======================================================== */
+
+/* # Zones mémoires ========================================================= */
+
+/* Copie "size" bytes de "p_src" à la position "*p_pos" de "p_dst" de capacité
+ * "dst_cap", et avance la position.
+ * Renvoie 0 sur un succès, -1 si "p_dst" est trop petit. */
+static int lib_copy(byte_t * p_dst, const size_t dst_cap, size_t * p_pos,
+                    const byte_t * p_src, const size_t size)
+{
+    if (size > dst_cap - *p_pos)
+        return -1;
+    if (size)
+        memcpy(p_dst + *p_pos, p_src, size);
+    *p_pos += size;
+    return 0;
+}
+
+/* Décompresse "in_size" bytes de "p_in" avec "algo" et copie le résultat à la
+ * position "*p_pos" de "p_dst". "raw_size" est la taille originale attendue
+ * (CODEC_SIZE_UNKNOWN si inconnue). Si "p_checksum" n'est pas NULL, la somme
+ * de contrôle du résultat doit valoir "*p_checksum".
+ * Renvoie ERR_NONE sur un succès, l'erreur correspondante sinon. */
+static err_code_e lib_decompress_to(const algo_e algo, const byte_t * p_in,
+                             const size_t in_size, const uint64_t raw_size,
+                             byte_t * p_dst, const size_t dst_cap,
+                             size_t * p_pos, const uint32_t * p_checksum)
+{
+    byte_t *p_out;
+    size_t out_size;
+    codec_ctx_s ctx;
+    const size_t start = *p_pos;
+    int ret;
+    /* Évite d'allouer une taille originale corrompue. */
+    if (raw_size != CODEC_SIZE_UNKNOWN && raw_size > dst_cap - *p_pos)
+        return ERR_BUFFER_SMALL;
+    /* Données stockées : copiées directement. */
+    if (algo == ALGO_STORED) {
+        if (raw_size != CODEC_SIZE_UNKNOWN && raw_size != in_size)
+            return ERR_DECOMPRESSION_FAILED;
+        ret = lib_copy(p_dst, dst_cap, p_pos, p_in, in_size);
+    } else {
+        codec_init(&ctx, MODE_DECOMPRESS, algo, 0);
+        if (codec_run_mem(&ctx, p_in, in_size, raw_size, &p_out, &out_size))
+            return ctx.err;
+        ret = lib_copy(p_dst, dst_cap, p_pos, p_out, out_size);
+        free(p_out);
+    }
+    if (ret)
+        return ERR_BUFFER_SMALL;
+    if (p_checksum && crc32c_update(CRC32C_INIT, p_dst + start,
+                                    *p_pos - start) != *p_checksum)
+        return ERR_CHECKSUM;
+    return ERR_NONE;
+}
+
+/* # Flux =================================================================== */
+
+/* Transmet "size" bytes de "p_data" à la fonction de sortie de "stream".
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err". */
+static int stream_output(cmp_stream_s * stream, const void *p_data,
+                         const size_t size)
+{
+    if (size && stream->write(stream->p_opaque, p_data, size))
+        return stream->err = ERR_IO_FWRITE, -1;
+    return 0;
+}
+
+/* Réserve la place de "size" bytes supplémentaires dans les données en
+ * attente de "stream", en supprimant d'abord les données déjà traitées.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err". */
+static int stream_reserve(cmp_stream_s * stream, const size_t size)
+{
+    if (stream->buf_pos) {
+        memmove(stream->p_buf, stream->p_buf + stream->buf_pos,
+                stream->buf_size - stream->buf_pos);
+        stream->buf_size -= stream->buf_pos;
+        stream->buf_pos = 0;
+    }
+    if (stream->buf_size + size <= stream->buf_cap)
+        return 0;
+    size_t cap = stream->buf_cap ? stream->buf_cap : PAR_CHUNK_SIZE;
+    while (cap < stream->buf_size + size)
+        cap <<= 1;
+    byte_t *p_tmp = realloc(stream->p_buf, cap);
+    if (!p_tmp)
+        return stream->err = ERR_OTHER, -1;
+    stream->p_buf = p_tmp;
+    stream->buf_cap = cap;
+    return 0;
+}
+
+/* Écris l'en-tête du fichier compressé de "stream" s'il ne l'a pas encore
+ * été.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err". */
+static int stream_put_header(cmp_stream_s * stream)
+{
+    if (stream->hdr_done)
+        return 0;
+    byte_t a_header[HDR_SIZE_MAX];
+    stream->hdr_done = TRUE;
+    return stream_output(stream, a_header, hdr_encode(&stream->hdr,
+                                                      a_header));
+}
+
+/* Compresse le bloc en attente de "stream" et le transmet précédé de son
+ * en-tête.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err". */
+static int stream_put_chunk(cmp_stream_s * stream)
+{
+    byte_t a_header[PAR_HEADER_SIZE_MAX], *p_out;
+    size_t out_size;
+    codec_ctx_s ctx;
+    if (stream_put_header(stream))
+        return -1;
+    if (!stream->buf_size)
+        return 0;
+    codec_init(&ctx, MODE_COMPRESS, stream->algo, 0);
+    if (codec_run_mem(&ctx, stream->p_buf, stream->buf_size,
+                      CODEC_SIZE_UNKNOWN, &p_out, &out_size))
+        return stream->err = ERR_COMPRESSION_FAILED, -1;
+    const uint32_t checksum = crc32c_update(CRC32C_INIT, stream->p_buf,
+                                            stream->buf_size);
+    const size_t header_size = par_chunk_encode(a_header, stream->buf_size,
+                                                out_size, ctx.algo,
+                                                stream->hdr.flags, checksum);
+    int ret = stream_output(stream, a_header, header_size)
+        || stream_output(stream, p_out, out_size) ? -1 : 0;
+    free(p_out);
+    stream->checksum = crc32c_combine(stream->checksum, checksum,
+                                      stream->buf_size);
+    stream->raw_total += stream->buf_size;
+    stream->buf_size = 0;
+    return ret;
+}
+
+/* Décompresse "in_size" bytes de "p_in" avec "algo" et transmet le résultat.
+ * "raw_size" est la taille originale attendue (CODEC_SIZE_UNKNOWN si
+ * inconnue). Si l'en-tête de "stream" l'indique, le résultat n'est transmis
+ * que si sa somme de contrôle vaut "checksum".
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err". */
+static int stream_put_raw(cmp_stream_s * stream, const algo_e algo,
+                          const byte_t * p_in, const size_t in_size,
+                          const uint64_t raw_size, const uint32_t checksum)
+{
+    byte_t *p_out;
+    size_t out_size;
+    codec_ctx_s ctx;
+    codec_init(&ctx, MODE_DECOMPRESS, algo, 0);
+    if (codec_run_mem(&ctx, p_in, in_size, raw_size, &p_out, &out_size))
+        return stream->err = ctx.err, -1;
+    if (stream->hdr.flags & HDR_FLAG_CHECKSUM) {
+        const uint32_t sum = crc32c_update(CRC32C_INIT, p_out, out_size);
+        if (sum != checksum)
+            return free(p_out), stream->err = ERR_CHECKSUM, -1;
+        stream->checksum = crc32c_combine(stream->checksum, sum, out_size);
+    }
+    int ret = stream_output(stream, p_out, out_size);
+    free(p_out);
+    stream->raw_total += out_size;
+    return ret;
+}
+
+/* Décompresse l'en-tête puis les blocs indépendants complets en attente dans
+ * "stream". Les fichiers non découpés en blocs restent en attente jusqu'à la
+ * fin du flux. La somme de contrôle de l'en-tête de bloc nul est vérifiée, et
+ * la table d'accès qui le suit est ignorée.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err". */
+static int stream_get_chunks(cmp_stream_s * stream)
+{
+    if (!stream->hdr_done) {
+        const int ret = hdr_decode(&stream->hdr, stream->p_buf,
+                                   stream->buf_size);
+        if (ret <= 0)
+            return ret ? stream->err = ERR_HEADER, -1 : 0;
+        stream->buf_pos = ret;
+        stream->hdr_done = TRUE;
+    }
+    if (!(stream->hdr.flags & HDR_FLAG_PARALLEL))
+        return 0;
+    if (stream->chunks_done)
+        return stream->buf_pos = stream->buf_size, 0;
+    const byte_t flags = stream->hdr.flags;
+    const size_t header_size = par_header_size(flags);
+    while (stream->buf_size - stream->buf_pos >= header_size) {
+        uint32_t raw_size, cmp_size, checksum;
+        algo_e algo;
+        const byte_t *p_chunk = stream->p_buf + stream->buf_pos;
+        par_chunk_decode(p_chunk, &raw_size, &cmp_size, &algo, flags,
+                         &checksum);
+        if (flags & (HDR_FLAG_SEEK | HDR_FLAG_CHECKSUM)
+            && par_chunk_end(p_chunk)) {
+            if (flags & HDR_FLAG_CHECKSUM && checksum != stream->checksum)
+                return stream->err = ERR_CHECKSUM, -1;
+            stream->chunks_done = TRUE;
+            stream->buf_pos = stream->buf_size;
+            break;
+        }
+        if (stream->buf_size - stream->buf_pos < header_size + cmp_size)
+            break;
+        if (stream_put_raw(stream, algo, p_chunk + header_size, cmp_size,
+                           raw_size, checksum))
+            return -1;
+        stream->buf_pos += header_size + cmp_size;
+    }
+    return 0;
+}
+
+/* Fonctions publiques ====================================================== */
+
+err_code_e cmp_error(const int64_t ret)
+{
+    return ret < 0 ? (err_code_e) (-2 - ret) : ERR_NONE;
+}
+
+const char *cmp_error_str(const err_code_e err)
+{
+    return err_str(err);
+}
+
+size_t cmp_compress_bound(const size_t src_len)
+{
+    /* Les données que l'algorithme agrandirait sont stockées telles
+     * quelles. */
+    return HDR_SIZE_MAX + src_len + HDR_TRAILER_SIZE;
+}
+
+int64_t cmp_compress_buffer(const algo_e algo, const void *p_src,
+                            const size_t src_len, void *p_dst,
+                            const size_t dst_cap)
+{
+    if ((!p_src && src_len) || !p_dst)
+        return LIB_ERROR(ERR_BAD_ADRESS);
+    byte_t a_header[HDR_SIZE_MAX], a_trailer[HDR_TRAILER_SIZE], *p_out;
+    size_t out_size, pos = 0;
+    header_s hdr;
+    codec_ctx_s ctx;
+    codec_init(&ctx, MODE_COMPRESS, algo, 0);
+    if (algo <= ALGO_NONE || algo >= ALGO_NB
+        || codec_run_mem(&ctx, p_src, src_len, CODEC_SIZE_UNKNOWN, &p_out,
+                         &out_size))
+        return LIB_ERROR(ERR_COMPRESSION_FAILED);
+    /* En-tête avec l'algorithme utilisé et la taille originale, puis les
+     * données compressées et la somme de contrôle des données originales. */
+    hdr_init(&hdr, ctx.algo);
+    hdr.flags |= HDR_FLAG_SIZE | HDR_FLAG_CHECKSUM;
+    hdr.size = src_len;
+    hdr_encode_trailer(a_trailer, crc32c_update(CRC32C_INIT, p_src,
+                                                src_len));
+    int ret = lib_copy(p_dst, dst_cap, &pos, a_header,
+                       hdr_encode(&hdr, a_header))
+        || lib_copy(p_dst, dst_cap, &pos, p_out, out_size)
+        || lib_copy(p_dst, dst_cap, &pos, a_trailer, HDR_TRAILER_SIZE);
+    free(p_out);
+    return ret ? LIB_ERROR(ERR_BUFFER_SMALL) : (int64_t) pos;
+}
+
+int64_t cmp_get_size(const void *p_src, const size_t src_len)
+{
+    if (!p_src && src_len)
+        return LIB_ERROR(ERR_BAD_ADRESS);
+    header_s hdr;
+    if (hdr_decode(&hdr, p_src, src_len) <= 0 || !(hdr.flags & HDR_FLAG_SIZE)
+        || hdr.size > INT64_MAX)
+        return LIB_ERROR(ERR_HEADER);
+    return hdr.size;
+}
+
+int64_t cmp_decompress_buffer(const void *p_src, const size_t src_len,
+                              void *p_dst, const size_t dst_cap)
+{
+    if ((!p_src && src_len) || (!p_dst && dst_cap))
+        return LIB_ERROR(ERR_BAD_ADRESS);
+    const byte_t *p_in = p_src;
+    size_t in_pos, pos = 0;
+    header_s hdr;
+    int ret = hdr_decode(&hdr, p_in, src_len);
+    if (ret <= 0)
+        return LIB_ERROR(ERR_HEADER);
+    in_pos = ret;
+    const int checked = hdr.flags & HDR_FLAG_CHECKSUM ? TRUE : FALSE;
+    /* Fichier en un seul morceau, suivi de la somme de contrôle des données
+     * originales. */
+    if (!(hdr.flags & HDR_FLAG_PARALLEL)) {
+        size_t in_size = src_len - in_pos;
+        uint32_t checksum = 0;
+        if (checked) {
+            if (in_size < HDR_TRAILER_SIZE)
+                return LIB_ERROR(ERR_CHECKSUM);
+            in_size -= HDR_TRAILER_SIZE;
+            checksum = hdr_decode_trailer(p_in + in_pos + in_size);
+        }
+        const err_code_e err = lib_decompress_to(hdr.algo, p_in + in_pos,
+                                                 in_size, hdr.flags
+                                                 & HDR_FLAG_SIZE ? hdr.size
+                                                 : CODEC_SIZE_UNKNOWN, p_dst,
+                                                 dst_cap, &pos, checked
+                                                 ? &checksum : NULL);
+        return err ? LIB_ERROR(err) : (int64_t) pos;
+    }
+    /* Fichier découpé en blocs indépendants, jusqu'à l'en-tête de bloc nul
+     * qui précède la table d'accès. */
+    const size_t header_size = par_header_size(hdr.flags);
+    uint32_t total_checksum = CRC32C_INIT;
+    int end = FALSE;
+    while (in_pos < src_len) {
+        uint32_t raw_size, cmp_size, checksum;
+        algo_e algo;
+        if (src_len - in_pos < header_size)
+            return LIB_ERROR(ERR_DECOMPRESSION_FAILED);
+        par_chunk_decode(p_in + in_pos, &raw_size, &cmp_size, &algo,
+                         hdr.flags, &checksum);
+        if (hdr.flags & (HDR_FLAG_SEEK | HDR_FLAG_CHECKSUM)
+            && par_chunk_end(p_in + in_pos)) {
+            if (checked && checksum != total_checksum)
+                return LIB_ERROR(ERR_CHECKSUM);
+            end = TRUE;
+            break;
+        }
+        in_pos += header_size;
+        if (src_len - in_pos < cmp_size)
+            return LIB_ERROR(ERR_DECOMPRESSION_FAILED);
+        const err_code_e err = lib_decompress_to(algo, p_in + in_pos,
+                                                 cmp_size, raw_size, p_dst,
+                                                 dst_cap, &pos, checked
+                                                 ? &checksum : NULL);
+        if (err)
+            return LIB_ERROR(err);
+        if (checked)
+            total_checksum = crc32c_combine(total_checksum, checksum,
+                                            raw_size);
+        in_pos += cmp_size;
+    }
+    /* Sans l'en-tête de bloc nul, les données sont tronquées. */
+    if (checked && !end)
+        return LIB_ERROR(ERR_CHECKSUM);
+    if (hdr.flags & HDR_FLAG_SIZE && pos != hdr.size)
+        return LIB_ERROR(ERR_IO_SIZE);
+    return pos;
+}
+
+cmp_stream_s *cmp_stream_new(const mode_e mode, const algo_e algo,
+                             const cmp_write_f write, void *p_opaque)
+{
+    if (!write || (mode != MODE_COMPRESS && mode != MODE_DECOMPRESS)
+        || (mode == MODE_COMPRESS && (algo <= ALGO_NONE || algo >= ALGO_NB)))
+        return NULL;
+    cmp_stream_s *stream = calloc(1, sizeof(cmp_stream_s));
+    if (!stream)
+        return NULL;
+    stream->mode = mode;
+    stream->algo = algo;
+    stream->write = write;
+    stream->p_opaque = p_opaque;
+    stream->err = ERR_NONE;
+    stream->checksum = CRC32C_INIT;
+    /* En-tête des blocs indépendants avec leurs sommes de contrôle, sans
+     * taille originale. */
+    hdr_init(&stream->hdr, algo);
+    stream->hdr.flags |= HDR_FLAG_PARALLEL | HDR_FLAG_CHECKSUM;
+    return stream;
+}
+
+int cmp_stream_write(cmp_stream_s * stream, const void *p_src,
+                     const size_t size)
+{
+    if (!stream)
+        return -1;
+    if (!p_src && size)
+        return stream->err = ERR_BAD_ADRESS, -1;
+    if (stream->err)
+        return -1;
+    const byte_t *p_in = p_src;
+    /* Décompression : les blocs complets sont traités après l'ajout des
+     * données. */
+    if (stream->mode == MODE_DECOMPRESS) {
+        if (stream_reserve(stream, size))
+            return -1;
+        if (size)
+            memcpy(stream->p_buf + stream->buf_size, p_in, size);
+        stream->buf_size += size;
+        return stream_get_chunks(stream);
+    }
+    /* Compression : un bloc est compressé dès qu'il est complet. */
+    for (size_t done = 0, nb_bytes; done < size; done += nb_bytes) {
+        if (!stream->buf_cap && stream_reserve(stream, PAR_CHUNK_SIZE))
+            return -1;
+        nb_bytes = PAR_CHUNK_SIZE - stream->buf_size;
+        nb_bytes = nb_bytes < size - done ? nb_bytes : size - done;
+        memcpy(stream->p_buf + stream->buf_size, p_in + done, nb_bytes);
+        stream->buf_size += nb_bytes;
+        if (stream->buf_size == PAR_CHUNK_SIZE && stream_put_chunk(stream))
+            return -1;
+    }
+    return 0;
+}
+
+int cmp_stream_end(cmp_stream_s * stream)
+{
+    if (!stream)
+        return -1;
+    if (stream->err)
+        return -1;
+    /* Compression : dernier bloc, puis en-tête de bloc nul avec la somme de
+     * contrôle de toutes les données originales. */
+    if (stream->mode == MODE_COMPRESS) {
+        byte_t a_end[PAR_HEADER_SIZE_MAX];
+        return stream_put_chunk(stream)
+            || stream_output(stream, a_end,
+                             par_chunk_encode(a_end, 0, 0, ALGO_NONE,
+                                              stream->hdr.flags,
+                                              stream->checksum)) ? -1 : 0;
+    }
+    if (!stream->hdr_done)
+        return stream->err = ERR_HEADER, -1;
+    size_t left = stream->buf_size - stream->buf_pos;
+    const uint64_t size = stream->hdr.flags & HDR_FLAG_SIZE ?
+        stream->hdr.size : CODEC_SIZE_UNKNOWN;
+    const int checked = stream->hdr.flags & HDR_FLAG_CHECKSUM ? TRUE : FALSE;
+    /* Fichier en un seul morceau : décompressé maintenant qu'il est complet,
+     * sans la somme de contrôle qui le termine. */
+    if (!(stream->hdr.flags & HDR_FLAG_PARALLEL)) {
+        const byte_t *p_in = stream->p_buf + stream->buf_pos;
+        if (checked && left < HDR_TRAILER_SIZE)
+            return stream->err = ERR_CHECKSUM, -1;
+        left -= checked ? HDR_TRAILER_SIZE : 0;
+        stream->buf_pos = stream->buf_size;
+        return stream_put_raw(stream, stream->hdr.algo, p_in, left, size,
+                              checked ? hdr_decode_trailer(p_in + left) : 0);
+    }
+    /* Blocs tronqués ou taille originale non retrouvée. */
+    if (checked && !stream->chunks_done)
+        return stream->err = ERR_CHECKSUM, -1;
+    if (left || (size != CODEC_SIZE_UNKNOWN && stream->raw_total != size))
+        return stream->err = ERR_IO_SIZE, -1;
+    return 0;
+}
+
+err_code_e cmp_stream_error(const cmp_stream_s * stream)
+{
+    return stream ? stream->err : ERR_BAD_ADRESS;
+}
+
+void cmp_stream_free(cmp_stream_s * stream)
+{
+    if (!stream)
+        return;
+    free(stream->p_buf);
+    free(stream);
+}
@@ -0,0 +1,797 @@
+/**
+ * \file parallel.c
+ * \author agent
+ * \date 17 octobre 2026
+ *
+ * \brief Parallélisme.
+ * \details Module de compression et de décompression parallèle. Le fichier
+ * entrant est découpé en blocs indépendants de taille fixe, traités par un
+ * groupe de threads puis écrits dans l'ordre sur le fichier sortant.
+ */
+
+/* Fonctionnement : le thread principal lit les blocs du fichier entrant dans
+ * un anneau d'emplacements, les threads de travail prennent les blocs dans
+ * l'ordre de lecture, les traitent en mémoire, et le thread principal écrit
+ * les blocs traités dans l'ordre avant de réutiliser leur emplacement. La
+ * lecture et l'écriture se font donc pendant que les threads travaillent. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "parallel.h"
+#include "header.h"
+#include "errors.h"
+#include "io.h"
+#include "common.h"
+#include "codec.h"
+#include "crc32c.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Nombre d'emplacements de blocs par thread : permet aux threads de travailler
+ * pendant que le thread principal lit et écrit les blocs. */
+#define PAR_SLOTS_BY_THREAD 2
+
+/* Énumérations privées ===================================================== */
+
+/* États d'un emplacement de bloc. */
+typedef enum par_state {
+    PAR_FREE = 0,               /* Emplacement libre. */
+    PAR_READY,                  /* Bloc chargé, en attente ou en traitement. */
+    PAR_DONE                    /* Bloc traité, en attente d'écriture. */
+} par_state_e;
+
+/* Structures privées ======================================================= */
+
+/* Emplacement d'un bloc dans l'anneau. */
+typedef struct par_slot {
+    par_state_e state;          /* État de l'emplacement. */
+    byte_t *p_in;               /* Données entrantes du bloc. */
+    size_t in_size;             /* Taille des données entrantes. */
+    size_t in_cap;              /* Capacité de "p_in". */
+    byte_t *p_out;              /* Données traitées du bloc (allouées). */
+    size_t out_size;            /* Taille des données traitées. */
+    uint32_t raw_size;          /* Taille originale attendue (décompression). */
+    algo_e algo;                /* Algorithme du bloc. */
+    uint32_t checksum;          /* Somme de contrôle des données originales
+                                   (calculée à la compression, lue dans
+                                   l'en-tête du bloc à la décompression). */
+    err_code_e err;             /* Erreur du traitement (ERR_NONE si
+                                   réussi). */
+} par_slot_s;
+
+/* Table d'accès en construction, remplie dans l'ordre d'écriture des
+ * blocs. */
+typedef struct par_seek {
+    byte_t *p_table;            /* Entrées encodées. */
+    size_t size;                /* Taille des entrées. */
+    size_t cap;                 /* Capacité de "p_table". */
+    uint64_t raw_pos;           /* Position des données originales du
+                                   prochain bloc. */
+    uint64_t cmp_pos;           /* Position du prochain bloc dans le fichier
+                                   compressé. */
+} par_seek_s;
+
+/* Groupe de threads et anneau d'emplacements partagé. */
+typedef struct par_pool {
+    pthread_mutex_t mutex;      /* Protège les compteurs et les états. */
+    pthread_cond_t cond_ready;  /* Signalé quand un bloc est chargé. */
+    pthread_cond_t cond_done;   /* Signalé quand un bloc est traité. */
+    pthread_t *a_threads;       /* Threads de travail. */
+    int nb_threads;             /* Nombre de threads de travail. */
+    par_slot_s *a_slots;        /* Anneau d'emplacements. */
+    int nb_slots;               /* Nombre d'emplacements. */
+    long nb_loaded;             /* Nombre de blocs chargés. */
+    long nb_taken;              /* Nombre de blocs pris par les threads. */
+    int stop;                   /* Vrai quand plus aucun bloc ne sera chargé. */
+    mode_e mode;                /* Compression ou décompression. */
+    int level;                  /* Niveau de compression. */
+    pipe_spec_s pipe;           /* Chaîne de transformations. */
+    byte_t flags;               /* Flags de l'en-tête du fichier. */
+    int verify;                 /* Vrai pour vérifier les sommes de contrôle
+                                   à la décompression. */
+    uint32_t checksum;          /* Somme de contrôle des données originales
+                                   des blocs écrits. */
+    int end;                    /* Vrai si l'en-tête de bloc nul a été lu. */
+    uint32_t end_checksum;      /* Somme de contrôle de l'en-tête de bloc
+                                   nul. */
+    uint64_t in_total;          /* Taille des données lues. */
+    uint64_t out_total;         /* Taille des données traitées écrites. */
+    uint64_t write_ns;          /* Temps passé à écrire les blocs. */
+    par_seek_s *p_seek;         /* Table d'accès à remplir, ou NULL. */
+    err_code_e err;             /* Erreur du premier bloc qui a échoué. */
+} par_pool_s;
+
+/* Fonctions privées ======================================================== */
+
+/* # Format ================================================================= */
+
+/* Écris l'entier "val" sur 32 bits en little endian à l'adresse "p_dest". */
+static void par_put_u32(byte_t * p_dest, const uint32_t val)
+{
+    for (int i = 0; i < 4; i++)
+        p_dest[i] = (val >> (i * CHAR_BIT)) & 0xFF;
+}
+
+/* Renvoie l'entier sur 32 bits en little endian à l'adresse "p_src". */
+static uint32_t par_get_u32(const byte_t * p_src)
+{
+    uint32_t val = 0;
+    for (int i = 0; i < 4; i++)
+        val |= (uint32_t) p_src[i] << (i * CHAR_BIT);
+    return val;
+}
+
+/* Écris l'entier "val" sur 64 bits en little endian à l'adresse "p_dest". */
+static void par_put_u64(byte_t * p_dest, const uint64_t val)
+{
+    par_put_u32(p_dest, val & UINT32_MAX);
+    par_put_u32(p_dest + 4, val >> 32);
+}
+
+/* Renvoie l'entier sur 64 bits en little endian à l'adresse "p_src". */
+static uint64_t par_get_u64(const byte_t * p_src)
+{
+    return par_get_u32(p_src) | (uint64_t) par_get_u32(p_src + 4) << 32;
+}
+
+/* # Table d'accès ========================================================== */
+
+/* Ajoute à la table "seek" l'entrée du bloc suivant, de "raw_size" bytes
+ * originaux et de "cmp_size" bytes dans le fichier compressé (en-tête
+ * compris).
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int par_seek_add(par_seek_s * seek, const size_t raw_size,
+                        const size_t cmp_size)
+{
+    assert(seek);
+    if (seek->size == seek->cap) {
+        const size_t cap = seek->cap ? seek->cap * 2
+            : 256 * PAR_SEEK_ENTRY_SIZE;
+        byte_t *p_tmp = realloc(seek->p_table, cap);
+        if (!p_tmp)
+            return -1;
+        seek->p_table = p_tmp;
+        seek->cap = cap;
+    }
+    par_put_u64(seek->p_table + seek->size, seek->raw_pos);
+    par_put_u64(seek->p_table + seek->size + 8, seek->cmp_pos);
+    seek->size += PAR_SEEK_ENTRY_SIZE;
+    seek->raw_pos += raw_size;
+    seek->cmp_pos += cmp_size;
+    return 0;
+}
+
+/* Écris l'en-tête de bloc nul d'un fichier aux flags "flags", avec la somme
+ * de contrôle "checksum" de toutes les données originales, la table "seek" et
+ * la fin du fichier sur "fp_out". La table est vide (et "p_table" nul) pour
+ * une entrée vide.
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int par_seek_write(const par_seek_s * seek, const byte_t flags,
+                          const uint32_t checksum, FILE * fp_out)
+{
+    assert(seek && fp_out);
+    byte_t a_end[PAR_HEADER_SIZE_MAX], a_trailer[PAR_SEEK_TRAILER_SIZE];
+    const size_t end_size = par_chunk_encode(a_end, 0, 0, ALGO_NONE, flags,
+                                             checksum);
+    par_put_u64(a_trailer, seek->cmp_pos + end_size);
+    par_put_u32(a_trailer + 8, seek->size / PAR_SEEK_ENTRY_SIZE);
+    memcpy(a_trailer + 12, PAR_SEEK_MAGIC, 4);
+    if (fwrite(a_end, sizeof(byte_t), end_size, fp_out) != end_size
+        || (seek->size && fwrite(seek->p_table, sizeof(byte_t), seek->size,
+                                 fp_out) != seek->size)
+        || fwrite(a_trailer, sizeof(byte_t), PAR_SEEK_TRAILER_SIZE, fp_out)
+        != PAR_SEEK_TRAILER_SIZE)
+        return -1;
+    return 0;
+}
+
+/* Lit "size" bytes à la position "offset" du descripteur "fd", sans
+ * modifier sa position.
+ * Renvoie 0 sur un succès, -1 sur une erreur ou si le fichier est trop
+ * court. */
+static int par_pread(const int fd, byte_t * p_dest, const size_t size,
+                     const uint64_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        const ssize_t nb_bytes = pread(fd, p_dest + done, size - done,
+                                       offset + done);
+        if (nb_bytes < 0 && errno == EINTR)
+            continue;
+        if (nb_bytes <= 0)
+            return -1;
+        done += nb_bytes;
+    }
+    return 0;
+}
+
+/* Positionne "fp_in" sur le bloc qui contient la position "offset" des
+ * données originales, trouvé par dichotomie dans la table d'accès, et
+ * renvoie la position des données originales de ce bloc dans "*p_raw_pos".
+ * Seules la fin du fichier et les entrées de la dichotomie sont lues.
+ * Renvoie 0 sur un succès, 1 si le fichier entrant n'est pas régulier (sans
+ * accès direct), -1 si la table d'accès est corrompue. */
+static int par_seek_find(FILE * fp_in, const uint64_t offset,
+                         uint64_t * p_raw_pos)
+{
+    assert(fp_in && p_raw_pos);
+    const int fd = fileno(fp_in);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) || !S_ISREG(file_stat.st_mode))
+        return 1;
+    /* Fin du fichier : position et taille de la table. */
+    byte_t a_buf[PAR_SEEK_TRAILER_SIZE];
+    const uint64_t end = file_stat.st_size - PAR_SEEK_TRAILER_SIZE;
+    if (file_stat.st_size < PAR_SEEK_TRAILER_SIZE
+        || par_pread(fd, a_buf, PAR_SEEK_TRAILER_SIZE, end)
+        || memcmp(a_buf + 12, PAR_SEEK_MAGIC, 4))
+        return -1;
+    const uint64_t table = par_get_u64(a_buf);
+    const uint32_t nb_chunks = par_get_u32(a_buf + 8);
+    if (table > end || end - table != (uint64_t) nb_chunks
+        * PAR_SEEK_ENTRY_SIZE)
+        return -1;
+    /* Aucun bloc : la lecture s'arrêtera sur l'en-tête de bloc nul. */
+    *p_raw_pos = 0;
+    if (!nb_chunks)
+        return 0;
+    /* Dernier bloc dont les données originales commencent avant "offset"
+     * (le premier commence à 0). */
+    uint32_t low = 0, high = nb_chunks;
+    while (high - low > 1) {
+        const uint32_t mid = low + (high - low) / 2;
+        if (par_pread(fd, a_buf, 8, table + (uint64_t) mid *
+                      PAR_SEEK_ENTRY_SIZE))
+            return -1;
+        if (par_get_u64(a_buf) <= offset)
+            low = mid;
+        else
+            high = mid;
+    }
+    if (par_pread(fd, a_buf, PAR_SEEK_ENTRY_SIZE, table + (uint64_t) low *
+                  PAR_SEEK_ENTRY_SIZE))
+        return -1;
+    *p_raw_pos = par_get_u64(a_buf);
+    const uint64_t cmp_pos = par_get_u64(a_buf + 8);
+    if (cmp_pos >= table || cmp_pos > INT64_MAX
+        || fseeko(fp_in, cmp_pos, SEEK_SET))
+        return -1;
+    return 0;
+}
+
+/* # Traitement ============================================================= */
+
+/* Traite le bloc de l'emplacement "slot" en mémoire dans le mode et au niveau
+ * du groupe "pool", et positionne "err" sur l'emplacement si une erreur
+ * survient. Chaque bloc a son propre contexte : les threads ne partagent aucun
+ * état des algorithmes. La somme de contrôle des données originales est
+ * calculée ou vérifiée dans la foulée, par le même thread. */
+static void par_process(par_slot_s * slot, const par_pool_s * pool)
+{
+    assert(slot && pool && !slot->p_out);
+    codec_ctx_s ctx;
+    codec_init(&ctx, pool->mode, slot->algo, pool->level);
+    ctx.pipe = pool->pipe;
+    /* Un bloc décompressé est alloué à sa taille originale, qu'il doit
+     * retrouver. Un bloc refusé par l'algorithme garde sa cause. */
+    slot->err = ERR_NONE;
+    if (codec_run_mem(&ctx, slot->p_in, slot->in_size,
+                      pool->mode == MODE_DECOMPRESS ? slot->raw_size
+                      : CODEC_SIZE_UNKNOWN, &slot->p_out, &slot->out_size))
+        slot->err = ctx.err == ERR_NOT_TEXT ? ERR_NOT_TEXT
+            : pool->mode == MODE_COMPRESS ? ERR_COMPRESSION_FAILED
+            : ERR_DECOMPRESSION_FAILED;
+    /* Algorithme retenu pour le bloc en choix automatique. */
+    slot->algo = ctx.algo;
+    if (slot->err || !(pool->flags & HDR_FLAG_CHECKSUM))
+        return;
+    if (pool->mode == MODE_COMPRESS)
+        slot->checksum = crc32c_update(CRC32C_INIT, slot->p_in,
+                                       slot->in_size);
+    else if (pool->verify && crc32c_update(CRC32C_INIT, slot->p_out,
+                                           slot->out_size) != slot->checksum)
+        slot->err = ERR_CHECKSUM;
+}
+
+/* Boucle d'un thread de travail : prend les blocs chargés dans l'ordre jusqu'à
+ * l'arrêt du groupe. */
+static void *par_worker(void *p_arg)
+{
+    par_pool_s *pool = p_arg;
+    pthread_mutex_lock(&pool->mutex);
+    while (TRUE) {
+        while (!pool->stop && pool->nb_taken == pool->nb_loaded)
+            pthread_cond_wait(&pool->cond_ready, &pool->mutex);
+        /* Arrêt demandé et plus aucun bloc à traiter. */
+        if (pool->nb_taken == pool->nb_loaded)
+            break;
+        par_slot_s *slot = &pool->a_slots[pool->nb_taken++ % pool->nb_slots];
+        pthread_mutex_unlock(&pool->mutex);
+        par_process(slot, pool);
+        pthread_mutex_lock(&pool->mutex);
+        slot->state = PAR_DONE;
+        pthread_cond_broadcast(&pool->cond_done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+/* # Groupe de threads ====================================================== */
+
+static void par_pool_destroy(par_pool_s * pool);
+
+/* Initialise le groupe "pool" de "nb_threads" threads dans le mode, au niveau
+ * et avec la vérification des sommes de contrôle de "ctx", pour un fichier
+ * compressé aux flags "flags".
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int par_pool_init(par_pool_s * pool, const int nb_threads,
+                         const codec_ctx_s * ctx, const byte_t flags)
+{
+    assert(pool && nb_threads > 0 && ctx);
+    memset(pool, 0, sizeof(par_pool_s));
+    pool->mode = ctx->mode;
+    pool->level = ctx->level;
+    pool->pipe = ctx->pipe;
+    pool->flags = flags;
+    pool->verify = ctx->verify;
+    pool->checksum = CRC32C_INIT;
+    pool->nb_slots = nb_threads * PAR_SLOTS_BY_THREAD;
+    if (!(pool->a_slots = calloc(pool->nb_slots, sizeof(par_slot_s)))
+        || !(pool->a_threads = calloc(nb_threads, sizeof(pthread_t)))) {
+        free(pool->a_slots);
+        return -1;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond_ready, NULL);
+    pthread_cond_init(&pool->cond_done, NULL);
+    for (; pool->nb_threads < nb_threads; pool->nb_threads++) {
+        if (pthread_create(&pool->a_threads[pool->nb_threads], NULL,
+                           par_worker, pool))
+            return par_pool_destroy(pool), -1;
+    }
+    return 0;
+}
+
+/* Arrête les threads du groupe "pool" une fois les blocs chargés traités, et
+ * libère les ressources. */
+static void par_pool_destroy(par_pool_s * pool)
+{
+    assert(pool);
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = TRUE;
+    pthread_cond_broadcast(&pool->cond_ready);
+    pthread_mutex_unlock(&pool->mutex);
+    for (int i = 0; i < pool->nb_threads; i++)
+        pthread_join(pool->a_threads[i], NULL);
+    for (int i = 0; i < pool->nb_slots; i++)
+        free(pool->a_slots[i].p_in), free(pool->a_slots[i].p_out);
+    pthread_cond_destroy(&pool->cond_done);
+    pthread_cond_destroy(&pool->cond_ready);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->a_threads), free(pool->a_slots);
+}
+
+/* # Lecture et écriture des blocs ========================================== */
+
+/* Réserve au moins "size" bytes dans les données entrantes de "slot".
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int par_slot_reserve(par_slot_s * slot, const size_t size)
+{
+    if (slot->in_cap >= size)
+        return 0;
+    byte_t *p_tmp = realloc(slot->p_in, size);
+    if (!p_tmp)
+        return -1;
+    slot->p_in = p_tmp;
+    slot->in_cap = size;
+    return 0;
+}
+
+/* Charge le prochain bloc original de "fp_in" dans "slot".
+ * Renvoie 1 si un bloc est chargé, 0 à la fin du fichier, -1 sur une
+ * erreur. */
+static int par_read_raw(par_pool_s * pool, par_slot_s * slot, FILE * fp_in)
+{
+    if (par_slot_reserve(slot, PAR_CHUNK_SIZE))
+        return -1;
+    slot->in_size = fread(slot->p_in, sizeof(byte_t), PAR_CHUNK_SIZE, fp_in);
+    if (!slot->in_size)
+        return ferror(fp_in) ? -1 : 0;
+    return 1;
+}
+
+/* Charge le prochain bloc compressé de "fp_in" dans "slot" en lisant son
+ * en-tête, au format des flags de "pool". L'en-tête de bloc nul termine la
+ * lecture, et sa somme de contrôle est conservée dans "pool".
+ * Renvoie 1 si un bloc est chargé, 0 à la fin du fichier, -1 sur une erreur ou
+ * si le fichier est tronqué. */
+static int par_read_chunk(par_pool_s * pool, par_slot_s * slot, FILE * fp_in)
+{
+    byte_t a_header[PAR_HEADER_SIZE_MAX];
+    uint32_t cmp_size;
+    const size_t header_size = par_header_size(pool->flags);
+    size_t nb_bytes = fread(a_header, sizeof(byte_t), header_size, fp_in);
+    if (!nb_bytes)
+        return ferror(fp_in) ? -1 : 0;
+    if (nb_bytes != header_size)
+        return -1;
+    par_chunk_decode(a_header, &slot->raw_size, &cmp_size, &slot->algo,
+                     pool->flags, &slot->checksum);
+    /* En-tête de bloc nul : fin des blocs, la table d'accès suit. */
+    if (par_chunk_end(a_header)) {
+        pool->end = TRUE;
+        pool->end_checksum = slot->checksum;
+        return 0;
+    }
+    slot->in_size = cmp_size;
+    if (par_slot_reserve(slot, slot->in_size ? slot->in_size : 1)
+        || fread(slot->p_in, sizeof(byte_t), slot->in_size, fp_in)
+        != slot->in_size)
+        return -1;
+    return 1;
+}
+
+/* Écris le bloc compressé de "slot" précédé de son en-tête, au format des
+ * flags de "pool", sur "fp_out".
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int par_write_chunk(par_pool_s * pool, const par_slot_s * slot,
+                           FILE * fp_out)
+{
+    byte_t a_header[PAR_HEADER_SIZE_MAX];
+    const size_t header_size = par_chunk_encode(a_header, slot->in_size,
+                                                slot->out_size, slot->algo,
+                                                pool->flags, slot->checksum);
+    if (fwrite(a_header, sizeof(byte_t), header_size, fp_out) != header_size
+        || fwrite(slot->p_out, sizeof(byte_t), slot->out_size, fp_out)
+        != slot->out_size)
+        return -1;
+    return 0;
+}
+
+/* Écris le bloc décompressé de "slot" sur "fp_out".
+ * Renvoie 0 sur un succès, -1 sur une erreur. */
+static int par_write_raw(par_pool_s * pool, const par_slot_s * slot,
+                         FILE * fp_out)
+{
+    if (fwrite(slot->p_out, sizeof(byte_t), slot->out_size, fp_out)
+        != slot->out_size)
+        return -1;
+    return 0;
+}
+
+/* Attends que le bloc de "slot" soit traité, puis l'écris sur "fp_out" avec
+ * "write" et libère l'emplacement.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err" de "pool"
+ * sur l'erreur du traitement s'il a échoué. */
+static int par_flush_slot(par_pool_s * pool, par_slot_s * slot, FILE * fp_out,
+                          int (*write)(par_pool_s *, const par_slot_s *,
+                                       FILE *))
+{
+    pthread_mutex_lock(&pool->mutex);
+    while (slot->state == PAR_READY)
+        pthread_cond_wait(&pool->cond_done, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+    assert(slot->state == PAR_DONE);
+    const uint64_t start = io_time_ns();
+    if (slot->err)
+        pool->err = slot->err;
+    int ret = slot->err || write(pool, slot, fp_out) ? -1 : 0;
+    /* Entrée de la table d'accès du bloc compressé écrit. */
+    if (!ret && pool->p_seek)
+        ret = par_seek_add(pool->p_seek, slot->in_size,
+                           par_header_size(pool->flags) + slot->out_size);
+    /* Somme de contrôle de toutes les données originales, recombinée dans
+     * l'ordre des blocs à partir de leurs sommes. */
+    if (!ret && pool->flags & HDR_FLAG_CHECKSUM)
+        pool->checksum = crc32c_combine(pool->checksum, slot->checksum,
+                                        pool->mode == MODE_COMPRESS ?
+                                        slot->in_size : slot->out_size);
+    pool->write_ns += io_time_ns() - start;
+    pool->out_total += slot->out_size;
+    free(slot->p_out), slot->p_out = NULL;
+    slot->state = PAR_FREE;
+    return ret;
+}
+
+/* Fait traiter tout les blocs de "fp_in" lus avec "read" par les "nb_threads"
+ * threads dans le mode, avec l'algorithme, au niveau et avec la vérification
+ * de "ctx", pour un fichier compressé aux flags "flags", et les écris dans
+ * l'ordre sur "fp_out" avec "write". La table d'accès "p_seek", si elle n'est
+ * pas NULL, est remplie puis écrite après les blocs. À la décompression, la
+ * somme de contrôle de toutes les données originales est vérifiée. Ajoute la
+ * taille des données lues et traitées et le temps de chaque phase aux
+ * statistiques de "ctx" : les temps sont ceux du thread de lecture et
+ * d'écriture, qui attend les threads de travail pendant la phase de
+ * l'algorithme.
+ * Renvoie 0 sur un succès, -1 sur une erreur et positionne "err" de "ctx" sur
+ * l'erreur d'un bloc, ou sur ERR_CHECKSUM si la somme de contrôle de toutes
+ * les données est incorrecte. */
+static int par_run(FILE * fp_in, FILE * fp_out, const int nb_threads,
+                   codec_ctx_s * ctx, const byte_t flags,
+                   int (*read)(par_pool_s *, par_slot_s *, FILE *),
+                   int (*write)(par_pool_s *, const par_slot_s *, FILE *),
+                   par_seek_s * p_seek)
+{
+    par_pool_s pool;
+    int ret = 0;
+    long nb_written = 0;
+    uint64_t read_ns = 0;
+    const uint64_t start = io_time_ns();
+    if (par_pool_init(&pool, nb_threads, ctx, flags))
+        return -1;
+    pool.p_seek = p_seek;
+    while (TRUE) {
+        par_slot_s *slot = &pool.a_slots[pool.nb_loaded % pool.nb_slots];
+        /* Si l'anneau est plein, l'emplacement contient le plus ancien bloc
+         * non écrit. */
+        if (pool.nb_loaded - nb_written == pool.nb_slots) {
+            if (par_flush_slot(&pool, slot, fp_out, write)) {
+                ret = -1;
+                break;
+            }
+            nb_written++;
+        }
+        slot->algo = ctx->algo;
+        const uint64_t read_start = io_time_ns();
+        ret = read(&pool, slot, fp_in);
+        read_ns += io_time_ns() - read_start;
+        if (ret <= 0)
+            break;
+        ret = 0;
+        pool.in_total += slot->in_size;
+        pthread_mutex_lock(&pool.mutex);
+        slot->state = PAR_READY;
+        pool.nb_loaded++;
+        pthread_cond_signal(&pool.cond_ready);
+        pthread_mutex_unlock(&pool.mutex);
+    }
+    /* Écriture des derniers blocs dans l'ordre. */
+    for (; !ret && nb_written < pool.nb_loaded; nb_written++) {
+        if (par_flush_slot(&pool, &pool.a_slots[nb_written % pool.nb_slots],
+                           fp_out, write))
+            ret = -1;
+    }
+    par_pool_destroy(&pool);
+    ctx->err = ret ? pool.err : ERR_NONE;
+    /* Somme de contrôle de toutes les données originales, écrite ou lue
+     * dans l'en-tête de bloc nul : son absence signale un fichier
+     * tronqué. */
+    if (!ret && p_seek)
+        ret = par_seek_write(p_seek, flags, pool.checksum, fp_out);
+    else if (!ret && pool.mode == MODE_DECOMPRESS && pool.verify
+             && flags & HDR_FLAG_CHECKSUM
+             && (!pool.end || pool.end_checksum != pool.checksum))
+        ctx->err = ERR_CHECKSUM, ret = -1;
+    ctx->in_total += pool.in_total;
+    ctx->out_total += pool.out_total;
+    ctx->read_ns += read_ns;
+    ctx->write_ns += pool.write_ns;
+    ctx->codec_ns += io_time_ns() - start - read_ns - pool.write_ns;
+    return ret;
+}
+
+/* Fonctions publiques ====================================================== */
+
+int par_default_threads(void)
+{
+    const long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return nb_cpus < 1 ? 1 : nb_cpus > PAR_THREADS_MAX ? PAR_THREADS_MAX
+        : nb_cpus;
+}
+
+size_t par_header_size(const byte_t flags)
+{
+    return flags & HDR_FLAG_CHECKSUM ? PAR_HEADER_SIZE_MAX : PAR_HEADER_SIZE;
+}
+
+size_t par_chunk_encode(byte_t * p_dest, const uint32_t raw_size,
+                        const uint32_t cmp_size, const algo_e algo,
+                        const byte_t flags, const uint32_t checksum)
+{
+    assert(p_dest);
+    par_put_u32(p_dest, raw_size);
+    par_put_u32(p_dest + 4, cmp_size);
+    p_dest[8] = algo;
+    if (flags & HDR_FLAG_CHECKSUM)
+        par_put_u32(p_dest + PAR_HEADER_SIZE, checksum);
+    return par_header_size(flags);
+}
+
+void par_chunk_decode(const byte_t * p_src, uint32_t * p_raw_size,
+                      uint32_t * p_cmp_size, algo_e * p_algo,
+                      const byte_t flags, uint32_t * p_checksum)
+{
+    assert(p_src && p_raw_size && p_cmp_size && p_algo && p_checksum);
+    *p_raw_size = par_get_u32(p_src);
+    *p_cmp_size = par_get_u32(p_src + 4);
+    *p_algo = p_src[8];
+    *p_checksum = flags & HDR_FLAG_CHECKSUM ?
+        par_get_u32(p_src + PAR_HEADER_SIZE) : 0;
+}
+
+int par_chunk_end(const byte_t * p_src)
+{
+    assert(p_src);
+    for (int i = 0; i < PAR_HEADER_SIZE; i++)
+        if (p_src[i])
+            return FALSE;
+    return TRUE;
+}
+
+int par_compress(FILE * fp_in, FILE * fp_out, codec_ctx_s * ctx,
+                 const int nb_threads)
+{
+    if (!ctx)
+        return -1;
+    if (!fp_in || !fp_out)
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    assert(nb_threads > 0 && nb_threads <= PAR_THREADS_MAX);
+    /* En-tête : fichier découpé en blocs avec une table d'accès et des sommes
+     * de contrôle, et taille originale si le fichier entrant est régulier. */
+    header_s hdr;
+    struct stat file_stat;
+    hdr_init(&hdr, ctx->algo);
+    hdr.flags |= HDR_FLAG_PARALLEL | HDR_FLAG_SEEK | HDR_FLAG_CHECKSUM;
+    if (!fstat(fileno(fp_in), &file_stat) && S_ISREG(file_stat.st_mode)) {
+        hdr.flags |= HDR_FLAG_SIZE;
+        hdr.size = file_stat.st_size;
+    }
+    par_seek_s seek = { NULL, 0, 0, 0, hdr.flags & HDR_FLAG_CHECKSUM
+        ? HDR_SIZE_MAX : HDR_SIZE
+    };
+    int ret = hdr_fwrite(fp_out, &hdr)
+        || par_run(fp_in, fp_out, nb_threads, ctx, hdr.flags, par_read_raw,
+                   par_write_chunk, &seek);
+    free(seek.p_table);
+    if (ret && ctx->err != ERR_NOT_TEXT)
+        ctx->err = ERR_COMPRESSION_FAILED;
+    fclose(fp_in);
+    if (fclose(fp_out) && !ret)
+        ctx->err = ERR_COMPRESSION_FAILED, ret = -1;
+    return ret ? -1 : 0;
+}
+
+int par_decompress(FILE * fp_in, FILE * fp_out, const header_s * hdr,
+                   codec_ctx_s * ctx, const int nb_threads)
+{
+    if (!ctx)
+        return -1;
+    if (!fp_in || !fp_out || !hdr)
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    assert(nb_threads > 0 && nb_threads <= PAR_THREADS_MAX);
+    assert(hdr->flags & HDR_FLAG_PARALLEL);
+    const uint64_t out_start = ctx->out_total;
+    int ret = par_run(fp_in, fp_out, nb_threads, ctx, hdr->flags,
+                      par_read_chunk, par_write_raw, NULL);
+    const uint64_t size = ctx->out_total - out_start;
+    if (ret && ctx->err != ERR_CHECKSUM)
+        ctx->err = ERR_DECOMPRESSION_FAILED;
+    fclose(fp_in);
+    if (fclose(fp_out) && !ret)
+        ctx->err = ERR_DECOMPRESSION_FAILED, ret = -1;
+    /* Vérification de la taille originale. */
+    if (!ret && hdr->flags & HDR_FLAG_SIZE && size != hdr->size)
+        return ctx->err = ERR_IO_SIZE, -1;
+    return ret ? -1 : 0;
+}
+
+int par_decompress_range(FILE * fp_in, FILE * fp_out, const header_s * hdr,
+                         codec_ctx_s * ctx, const uint64_t offset,
+                         const uint64_t len)
+{
+    if (!ctx)
+        return -1;
+    if (!fp_in || !fp_out || !hdr)
+        return ctx->err = ERR_BAD_ADRESS, -1;
+    if (!(hdr->flags & HDR_FLAG_PARALLEL))
+        return fclose(fp_in), fclose(fp_out), ctx->err = ERR_RANGE, -1;
+    const uint64_t end = len > UINT64_MAX - offset ? UINT64_MAX
+        : offset + len;
+    uint64_t raw_pos = 0, read_ns = 0, write_ns = 0;
+    /* Premier bloc trouvé dans la table d'accès, sinon en parcourant les
+     * en-têtes des blocs depuis le début. */
+    int ret = hdr->flags & HDR_FLAG_SEEK ? par_seek_find(fp_in, offset,
+                                                         &raw_pos) : 1;
+    if (ret > 0)
+        ret = 0;
+    par_slot_s slot;
+    memset(&slot, 0, sizeof(par_slot_s));
+    const size_t header_size = par_header_size(hdr->flags);
+    while (!ret && raw_pos < end) {
+        byte_t a_header[PAR_HEADER_SIZE_MAX];
+        uint32_t raw_size, cmp_size, checksum;
+        algo_e algo;
+        uint64_t start = io_time_ns();
+        const size_t nb_bytes = fread(a_header, sizeof(byte_t), header_size,
+                                      fp_in);
+        if (!nb_bytes || (nb_bytes == header_size
+                          && par_chunk_end(a_header))) {
+            ret = ferror(fp_in) ? -1 : 0;
+            break;
+        }
+        par_chunk_decode(a_header, &raw_size, &cmp_size, &algo, hdr->flags,
+                         &checksum);
+        /* Seuls les blocs d'un algorithme qui les décompresse chacun seul
+         * peuvent être sautés ou décompressés à part (un algorithme inconnu
+         * est une corruption, détectée à la décompression). */
+        const codec_desc_s *desc = codec_desc(algo);
+        if (nb_bytes == header_size && desc
+            && !(desc->caps & CODEC_CAP_SEEKABLE)) {
+            fclose(fp_in), fclose(fp_out);
+            free(slot.p_in);
+            return ctx->err = ERR_RANGE, -1;
+        }
+        /* Bloc avant l'intervalle : ses données sont sautées. */
+        if (nb_bytes == header_size && raw_pos + raw_size <= offset
+            && !fseeko(fp_in, cmp_size, SEEK_CUR)) {
+            raw_pos += raw_size;
+            read_ns += io_time_ns() - start;
+            continue;
+        }
+        if (nb_bytes != header_size
+            || par_slot_reserve(&slot, cmp_size ? cmp_size : 1)
+            || fread(slot.p_in, sizeof(byte_t), cmp_size, fp_in) != cmp_size) {
+            ret = -1;
+            break;
+        }
+        read_ns += io_time_ns() - start;
+        /* Sur un tube, les données d'un bloc avant l'intervalle sont lues
+         * mais pas décompressées. */
+        if (raw_pos + raw_size <= offset) {
+            raw_pos += raw_size;
+            continue;
+        }
+        codec_ctx_s chunk_ctx;
+        codec_init(&chunk_ctx, MODE_DECOMPRESS, algo, 0);
+        if (codec_run_mem(&chunk_ctx, slot.p_in, cmp_size, raw_size,
+                          &slot.p_out, &slot.out_size)) {
+            ret = -1;
+            break;
+        }
+        /* Le bloc entier est décompressé : sa somme de contrôle est
+         * vérifiée. */
+        if (hdr->flags & HDR_FLAG_CHECKSUM && ctx->verify
+            && crc32c_update(CRC32C_INIT, slot.p_out, slot.out_size)
+            != checksum) {
+            free(slot.p_out), slot.p_out = NULL;
+            fclose(fp_in), fclose(fp_out);
+            free(slot.p_in);
+            return ctx->err = ERR_CHECKSUM, -1;
+        }
+        /* Partie du bloc dans l'intervalle. */
+        const size_t from = offset > raw_pos ? offset - raw_pos : 0;
+        const size_t to = end - raw_pos < raw_size ? end - raw_pos : raw_size;
+        start = io_time_ns();
+        if (fwrite(slot.p_out + from, sizeof(byte_t), to - from, fp_out)
+            != to - from) {
+            free(slot.p_out), slot.p_out = NULL;
+            fclose(fp_in), fclose(fp_out);
+            free(slot.p_in);
+            return ctx->err = ERR_IO_FWRITE, -1;
+        }
+        write_ns += io_time_ns() - start;
+        free(slot.p_out), slot.p_out = NULL;
+        ctx->in_total += header_size + cmp_size;
+        ctx->out_total += to - from;
+        ctx->codec_ns += chunk_ctx.codec_ns;
+        raw_pos += raw_size;
+    }
+    free(slot.p_in);
+    fclose(fp_in);
+    if (fclose(fp_out) && !ret)
+        return ctx->err = ERR_IO_FCLOSE, -1;
+    ctx->read_ns += read_ns;
+    ctx->write_ns += write_ns;
+    if (ret)
+        return ctx->err = ERR_DECOMPRESSION_FAILED, -1;
+    ctx->err = ERR_NONE;
+    return 0;
+}
@@ -9,24 +9,57 @@
  */
 
 #include <stdio.h>
-/*#include <string.h>*/
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
 #include <time.h>
 #include <sys/stat.h>
 #include <sys/resource.h>
 #include "stats.h"
+#include "init.h"
+#include "codec.h"
 #include "errors.h"
+#include "io.h"
+
+/* Macro-constantes privées ================================================= */
+
+/* Noms des colonnes du format CSV, dans l'ordre des champs du format JSON. */
+#define STAT_CSV_HEADER "mode,algo,level,in_bytes,out_bytes,ratio,wall_s," \
+    "cpu_s,in_mb_s,out_mb_s,read_s,codec_s,write_s,max_rss_kb,input,output"
+
+/* Structures privées ======================================================= */
+
+/* Mesures du programme affichées par les formats JSON et CSV. */
+typedef struct stat_values {
+    double wall;                /* Temps réel en s. */
+    double cpu;                 /* Temps CPU (user & kernel) en s. */
+    double ratio;               /* Taille originale / taille compressée. */
+    double in_mb_s;             /* Débit des données lues en MB/s. */
+    double out_mb_s;            /* Débit des données produites en MB/s. */
+    double read;                /* Temps de lecture en s. */
+    double codec;               /* Temps dans l'algorithme en s. */
+    double write;               /* Temps d'écriture en s. */
+    long max_rss;               /* Mémoire maximale utilisée en kB. */
+} stat_values_s;
 
 /* Variables globales privées =============================================== */
 
 /* Contiendra le temps CPU à l'initialisation du programme. */
 static clock_t STAT_t;
+/* Contiendra le temps réel à l'initialisation du programme. */
+static uint64_t STAT_wall;
+/* Flux d'affichage des statistiques (sortie d'erreur si la sortie standard
+ * reçoit le fichier sortant). */
+static FILE *STAT_stream;
 
 /* Fonctions privées ======================================================== */
 
-/* Affiche la taille d'un fichier sur la sortie standard. Si succès renvoie 0,
- * si erreur renvoie -1. */
+/* Affiche la taille d'un fichier sur le flux des statistiques. Si succès renvoie 0,
+ * si erreur renvoie -1. L'entrée et la sortie standard n'ont pas de taille. */
 static int stat_print_file(const char *s_pathname)
 {
+    if (!strcmp(s_pathname, IO_STD_PATH))
+        return 0;
     /* Récupération des statistiques. */
     struct stat file_stat;
     if (stat(s_pathname, &file_stat))
@@ -35,24 +68,110 @@ static int stat_print_file(const char *s_pathname)
     /*const char *s_ptr_tmp = strrchr(s_pathname, '/'); */
     /*s_pathname = s_ptr_tmp ? s_ptr_tmp + 1 : s_pathname; */
     /* Affichage des informations. */
-    printf("Taille de %s : %ld kB.\n", s_pathname, file_stat.st_size / 1000);
+    fprintf(STAT_stream, "Taille de %s : %ld kB.\n", s_pathname,
+            file_stat.st_size / 1000);
     return 0;
 }
 
-/* Affiche les statistiques d'exécution du programme sur la sortie standard. Si succès
+/* Affiche les statistiques d'exécution du programme sur le flux des statistiques. Si succès
  * renvoie 0, si erreur renvoie -1. */
 static int stat_print_prog()
 {
     /* Temps CPU utilisé (mode user et kernel). */
     STAT_t = clock() - STAT_t;
-    printf("Temps CPU (user & kernel) du programme : %f s.\n",
-           ((float)STAT_t) / CLOCKS_PER_SEC);
+    fprintf(STAT_stream, "Temps CPU (user & kernel) du programme : %f s.\n",
+            ((float)STAT_t) / CLOCKS_PER_SEC);
     /* Consommation en mémoire. */
     struct rusage rus;
     if (getrusage(RUSAGE_SELF, &rus))
         return perror("getrusage for program statistics"), -1;
-    printf("Espace mémoire utilisé (resident set size) : %ld kB.\n",
-           rus.ru_maxrss);
+    fprintf(STAT_stream,
+            "Espace mémoire utilisé (resident set size) : %ld kB.\n",
+            rus.ru_maxrss);
+    return 0;
+}
+
+/* # Formats JSON et CSV ==================================================== */
+
+/* Calcule les mesures du programme dans "v" à partir des statistiques de
+ * "ctx". Si succès renvoie 0, si erreur renvoie -1. */
+static int stat_get_values(const codec_ctx_s * ctx, stat_values_s * v)
+{
+    struct rusage rus;
+    if (getrusage(RUSAGE_SELF, &rus))
+        return perror("getrusage for program statistics"), -1;
+    v->max_rss = rus.ru_maxrss;
+    v->wall = (io_time_ns() - STAT_wall) / 1e9;
+    v->cpu = (double)(clock() - STAT_t) / CLOCKS_PER_SEC;
+    /* Le taux compare toujours la taille originale à la taille compressée. */
+    const uint64_t raw = ctx->mode == MODE_COMPRESS ? ctx->in_total
+        : ctx->out_total;
+    const uint64_t cmp = ctx->mode == MODE_COMPRESS ? ctx->out_total
+        : ctx->in_total;
+    v->ratio = cmp ? (double)raw / cmp : 0;
+    v->in_mb_s = v->wall > 0 ? ctx->in_total / 1e6 / v->wall : 0;
+    v->out_mb_s = v->wall > 0 ? ctx->out_total / 1e6 / v->wall : 0;
+    v->read = ctx->read_ns / 1e9;
+    v->codec = ctx->codec_ns / 1e9;
+    v->write = ctx->write_ns / 1e9;
+    return 0;
+}
+
+/* Affiche la chaîne "s" entre guillemets sur le flux des statistiques, en
+ * échappant les caractères spéciaux pour le format "format" (JSON ou CSV). */
+static void stat_print_string(const char *s, const stat_format_e format)
+{
+    fputc('"', STAT_stream);
+    for (; *s; s++) {
+        const unsigned char c = *s;
+        if (format == STAT_CSV && c == '"')
+            fputs("\"\"", STAT_stream);
+        else if (format == STAT_JSON && (c == '"' || c == '\\'))
+            fprintf(STAT_stream, "\\%c", c);
+        else if (format == STAT_JSON && c < 0x20)
+            fprintf(STAT_stream, "\\u%04x", c);
+        else
+            fputc(c, STAT_stream);
+    }
+    fputc('"', STAT_stream);
+}
+
+/* Affiche les statistiques de "pi" et "ctx" dans le format "format" (JSON ou
+ * CSV) sur le flux des statistiques. Si succès renvoie 0, si erreur renvoie
+ * -1. */
+static int stat_print_record(const prog_info_s * pi, const codec_ctx_s * ctx,
+                             const stat_format_e format)
+{
+    stat_values_s v;
+    if (stat_get_values(ctx, &v))
+        return -1;
+    const char *s_mode = ctx->mode == MODE_COMPRESS ? "compress"
+        : "decompress";
+    const char *s_algo = ctx->p_desc ? ctx->p_desc->s_name : "NONE";
+    if (format == STAT_JSON) {
+        fprintf(STAT_stream, "{\"mode\":\"%s\",\"algo\":\"%s\",\"level\":%d,"
+                "\"in_bytes\":%" PRIu64 ",\"out_bytes\":%" PRIu64 ","
+                "\"ratio\":%.4f,\"wall_s\":%.6f,\"cpu_s\":%.6f,"
+                "\"in_mb_s\":%.3f,\"out_mb_s\":%.3f,\"read_s\":%.6f,"
+                "\"codec_s\":%.6f,\"write_s\":%.6f,\"max_rss_kb\":%ld,"
+                "\"input\":", s_mode, s_algo, ctx->level, ctx->in_total,
+                ctx->out_total, v.ratio, v.wall, v.cpu, v.in_mb_s, v.out_mb_s,
+                v.read, v.codec, v.write, v.max_rss);
+        stat_print_string(pi->s_input_file, format);
+        fputs(",\"output\":", STAT_stream);
+        stat_print_string(pi->s_output_file, format);
+        fputs("}\n", STAT_stream);
+    } else {
+        fprintf(STAT_stream, STAT_CSV_HEADER "\n%s,%s,%d,%" PRIu64 ",%"
+                PRIu64 ",%.4f,%.6f,%.6f,%.3f,%.3f,%.6f,%.6f,%.6f,%ld,",
+                s_mode, s_algo, ctx->level, ctx->in_total, ctx->out_total,
+                v.ratio, v.wall, v.cpu, v.in_mb_s, v.out_mb_s, v.read,
+                v.codec, v.write, v.max_rss);
+        stat_print_string(pi->s_input_file, format);
+        fputc(',', STAT_stream);
+        stat_print_string(pi->s_output_file, format);
+        fputc('\n', STAT_stream);
+    }
     return 0;
 }
 
@@ -61,12 +180,17 @@ static int stat_print_prog()
 void stat_init()
 {
     STAT_t = clock();
+    STAT_wall = io_time_ns();
 }
 
-int stat_print(const char *s_filepath_in, const char *s_filepath_out)
+err_code_e stat_print(const prog_info_s * pi, const codec_ctx_s * ctx)
 {
-    if (stat_print_file(s_filepath_in) || stat_print_file(s_filepath_out)
-        || stat_print_prog())
-        return CMP_err = ERR_STAT, -1;
-    return 0;
+    STAT_stream = strcmp(pi->s_output_file, IO_STD_PATH) ? stdout : stderr;
+    if (pi->stat == STAT_JSON || pi->stat == STAT_CSV) {
+        return stat_print_record(pi, ctx, pi->stat) ? ERR_STAT : ERR_NONE;
+    }
+    if (stat_print_file(pi->s_input_file)
+        || stat_print_file(pi->s_output_file) || stat_print_prog())
+        return ERR_STAT;
+    return ERR_NONE;
 }